@@ -5,19 +5,25 @@
 #include <fstream>
 #include <iostream>
 
+#ifdef _WIN32
 #import  "..\MccSdk\MccCOMInterop.tlb" raw_interfaces_only
+#endif
 
 using namespace processing::storage;
 using namespace matching;
 
 Matcher::Matcher()
 {
+#ifdef _WIN32
     CoInitialize(nullptr);
+#endif
 }
 
 Matcher::~Matcher()
 {
+#ifdef _WIN32
     CoUninitialize();
+#endif
 }
 
 bool Matcher::createTxtMinutiaTemplate(const Fingerprint& fingerprint, const std::string& filename)
@@ -54,6 +60,7 @@ bool Matcher::createTxtMinutiaTemplate(const Fingerprint& fingerprint, const std
 
 double Matcher::match(const std::string& template1, const std::string& template2)
 {
+#ifdef _WIN32
     MccCOMInterop::IMatcherPtr pIMatcher(__uuidof(MccCOMInterop::Matcher));
 
     const auto tpl1 = std::wstring(template1.begin(), template1.end());
@@ -66,4 +73,8 @@ double Matcher::match(const std::string& template1, const std::string& template2
     pIMatcher->Match(path1, path2, &score);
 
     return score;
+#else
+    // MCC SDK je dostupne len cez COM, mimo Windows skore nevieme urcit
+    return -1;
+#endif
 }
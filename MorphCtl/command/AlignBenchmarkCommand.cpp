@@ -0,0 +1,231 @@
+#include "AlignBenchmarkCommand.h"
+
+#include "../exceptions/InvalidArgument.h"
+#include "../utils/Benchmark.h"
+
+#include <storage/Fingerprint.h>
+#include <storage/AlignedFingerprint.h>
+#include <utils/ImageProcessor.h>
+
+#include <opencv2/core/utility.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+using namespace cli::command;
+
+const std::string AlignBenchmarkCommand::name = "bench-align";
+const int AlignBenchmarkCommand::runs = 3;
+
+int AlignBenchmarkCommand::run(const std::vector<std::string>& args) const
+{
+	const auto& mode = this->configuration.getBenchmarkMode();
+
+	if (mode.empty())
+	{
+		return this->parallel(args);
+	}
+	if (mode != "coarse" && mode != "fft" && mode != "bound")
+	{
+		throw exception::InvalidArgument("--mode " + mode);
+	}
+
+	return this->compare(args, mode);
+}
+
+int AlignBenchmarkCommand::parallel(const std::vector<std::string>& args) const
+{
+	if (args.size() < 2)
+	{
+		throw exception::InvalidArgument(usage());
+	}
+
+	std::vector<int> threads;
+	for (auto i = 2u; i < args.size(); i++)
+	{
+		std::stringstream value(args[i]);
+		auto count = 0;
+		value >> count;
+
+		if (value.fail() || !value.eof() || count < 1)
+		{
+			throw exception::InvalidArgument(args[i]);
+		}
+		threads.push_back(count);
+	}
+	if (threads.empty())
+	{
+		threads = { 1, 8, 16, 32 };
+	}
+
+	auto processor = this->configuration.createFingerprintProcessor();
+	auto serial = this->configuration.createFingerprintAligner(processor);
+	serial.parallel(false);
+	auto parallel = serial;
+	parallel.parallel(true);
+
+	processing::storage::Fingerprint f(processing::utils::ImageProcessor::read(args[0]));
+	this->configuration.prepare(processor, f);
+	const auto img = processing::utils::ImageProcessor::read(args[1]);
+
+	morphing::storage::AlignedFingerprint reference;
+	const auto serialTime = this->measure(serial, processor, f, img, reference);
+
+	const auto cvThreads = cv::getNumThreads();
+	auto rc = 0;
+
+	std::cout << "threads;serial ms;parallel ms;speedup;identical;" << std::endl;
+	for (const auto count : threads)
+	{
+		cv::setNumThreads(count);
+
+		morphing::storage::AlignedFingerprint af;
+		const auto parallelTime = this->measure(parallel, processor, f, img, af);
+
+		const auto o = af.getOrientations();
+		const auto oReference = reference.getOrientations();
+		const auto identical = af.getAlignment() == reference.getAlignment()
+			&& o.size() == oReference.size()
+			&& (o.empty() || cv::norm(o, oReference, cv::NORM_INF) == 0);
+
+		if (!identical)
+		{
+			rc = 1;
+		}
+
+		std::cout << count << ";" << serialTime << ";" << parallelTime << ";"
+			<< serialTime / parallelTime << ";" << (identical ? "yes" : "no") << ";" << std::endl;
+	}
+
+	cv::setNumThreads(cvThreads);
+
+	return rc;
+}
+
+double AlignBenchmarkCommand::measure(const morphing::utils::FingerprintAligner& aligner, const processing::FingerprintProcessor& processor,
+	processing::storage::Fingerprint& f, const cv::Mat& img, morphing::storage::AlignedFingerprint& af) const
+{
+	auto time = .0;
+	for (auto run = 0; run < runs; run++)
+	{
+		// zarovnanie meni zarovnavany odtlacok, kazde opakovanie zacina od novo spracovaneho
+		af = morphing::storage::AlignedFingerprint(img);
+		this->configuration.prepare(processor, af);
+
+		time += utils::Benchmark::measure([&] { aligner.align(af, f); });
+	}
+
+	return time / runs;
+}
+
+int AlignBenchmarkCommand::compare(const std::vector<std::string>& directories, const std::string& mode) const
+{
+	if (directories.empty())
+	{
+		throw exception::InvalidArgument(usage());
+	}
+
+	auto processor = this->configuration.createFingerprintProcessor();
+	auto plain = this->configuration.createFingerprintAligner(processor);
+
+	// vyrovnavacia pamat by zvyhodnila druhy beh kazdej dvojice
+	plain.setRotationCache(nullptr);
+
+	auto variant = plain;
+	const auto statistics = std::make_shared<morphing::utils::FingerprintAligner::Statistics>();
+
+	if (mode == "coarse")
+	{
+		plain.setCoarseScale(1);
+		variant.setCoarseScale(std::max(2, this->configuration.getCoarseScale()));
+	}
+	else if (mode == "fft")
+	{
+		plain.setCoarseScale(1).correlation(false);
+		variant.setCoarseScale(1).correlation(true);
+	}
+	else
+	{
+		plain.bound(false);
+		variant.bound(true).setStatistics(statistics);
+	}
+
+	const auto rotationStep = plain.getRotationStep();
+	const auto translationStep = plain.getTranslationStep();
+
+	// hrube prehladavanie sa hodnoti zasahom do jedneho kroku, ostatne musia najst rovnake zarovnanie
+	const auto verdict = mode == "coarse" ? "hit" : "identical";
+	if (mode == "bound")
+	{
+		std::cout << "name;plain ms;" << mode << " ms;evaluated;negligible;pruned;" << verdict << ";" << std::endl;
+	}
+	else
+	{
+		std::cout << "name;plain ms;" << mode << " ms;angle;x;y;" << verdict << ";" << std::endl;
+	}
+
+	for (const auto& directory : directories)
+	{
+		const auto files = utils::Benchmark::listImages(directory);
+
+		auto matches = 0;
+		auto plainTime = .0, variantTime = .0;
+		std::size_t evaluated = 0, negligible = 0, pruned = 0;
+
+		const auto counts = utils::Benchmark::forEachPair(files, [&](const std::string& name, const std::string& file, const std::string& other)
+		{
+			statistics->clear();
+
+			double t1, t2;
+			const auto a1 = utils::Benchmark::align(this->configuration, processor, plain, file, other, t1);
+			const auto a2 = utils::Benchmark::align(this->configuration, processor, variant, file, other, t2);
+
+			const auto angle = std::abs(a2[2] - a1[2]);
+			const auto x = std::abs(a2[0] - a1[0]);
+			const auto y = std::abs(a2[1] - a1[1]);
+			const auto match = mode == "coarse"
+				? angle <= rotationStep && x <= translationStep && y <= translationStep
+				: a1 == a2;
+
+			matches += match ? 1 : 0;
+			plainTime += t1;
+			variantTime += t2;
+			evaluated += statistics->evaluated;
+			negligible += statistics->negligible;
+			pruned += statistics->bounded;
+
+			std::cout << name << ";" << t1 << ";" << t2 << ";";
+			if (mode == "bound")
+			{
+				std::cout << statistics->evaluated << ";" << statistics->negligible << ";" << statistics->bounded << ";";
+			}
+			else
+			{
+				std::cout << angle << ";" << x << ";" << y << ";";
+			}
+			std::cout << (match ? "yes" : "no") << ";" << std::endl;
+		});
+
+		auto& summary = utils::Benchmark::summary(directory, counts, "pairs")
+			<< ", " << (mode == "coarse" ? "recall " : "identical ") << counts.mean(matches)
+			<< ", speedup " << (variantTime > 0 ? plainTime / variantTime : .0);
+
+		if (mode == "bound")
+		{
+			const auto total = evaluated + negligible + pruned;
+			summary << ", negligible " << (total > 0 ? static_cast<double>(negligible) / total : .0)
+				<< ", pruned " << (total > 0 ? static_cast<double>(pruned) / total : .0);
+		}
+		summary << std::endl;
+	}
+
+	return 0;
+}
+
+std::string AlignBenchmarkCommand::usage()
+{
+	return "bench-align <fingerprint> <fingerprint> [threads...] | bench-align --mode coarse|fft|bound <directory>...";
+}
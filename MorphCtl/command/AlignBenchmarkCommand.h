@@ -0,0 +1,79 @@
+#pragma once
+
+#include "../utils/Configuration.h"
+
+#include <string>
+#include <vector>
+
+namespace cli
+{
+	namespace command
+	{
+		/**
+		 * \brief Prikaz merania zarovnania odtlackov. Bez volby --mode meria zrychlenie
+		 * paralelneho zarovnania voci seriovemu a pre kazdy zadany pocet vlakien vypise
+		 * na standardny vystup riadok v tvare vlakna;seriovo ms;paralelne ms;zrychlenie;zhoda.
+		 * S volbou --mode coarse, fft alebo bound porovna dany sposob prehladavania
+		 * s uplnym prehladavanim na vsetkych dvojiciach odtlackov zadanych priecinkov.
+		 */
+		class AlignBenchmarkCommand
+		{
+		private:
+			// members
+			/**
+			 * \brief Parametre spracovania a zarovnania.
+			 */
+			utils::Configuration configuration;
+
+			// static members
+			/**
+			 * \brief Pocet opakovani merania, vysledny cas je priemer.
+			 */
+			static const int runs;
+
+			// methods
+			/**
+			 * \brief Zmeria priemerny cas zarovnania dvojice odtlackov.
+			 * \param aligner nastroj zarovnania
+			 * \param processor ovladac spracovania odtlackov
+			 * \param f odtlacok
+			 * \param img obrazok zarovnavaneho odtlacku
+			 * \param af sem sa ulozi zarovnany odtlacok posledneho opakovania
+			 * \return priemerny cas zarovnania v ms
+			 */
+			double measure(const morphing::utils::FingerprintAligner& aligner, const processing::FingerprintProcessor& processor,
+				processing::storage::Fingerprint& f, const cv::Mat& img, morphing::storage::AlignedFingerprint& af) const;
+			/**
+			 * \brief Zmeria seriove a paralelne zarovnanie dvojice odtlackov.
+			 * \param args <odtlacok> <druhy odtlacok> [pocty vlakien]
+			 * \return navratovy kod procesu, 1 ak sa paralelny vysledok lisi od serioveho
+			 */
+			int parallel(const std::vector<std::string>& args) const;
+			/**
+			 * \brief Porovna sposob prehladavania s uplnym prehladavanim na dvojiciach odtlackov.
+			 * \param directories priecinky s odtlackami
+			 * \param mode sposob prehladavania: coarse, fft alebo bound
+			 * \return navratovy kod procesu
+			 */
+			int compare(const std::vector<std::string>& directories, const std::string& mode) const;
+
+		public:
+			// static members
+			static const std::string name;
+
+			// constructors
+			explicit AlignBenchmarkCommand(const utils::Configuration& configuration) : configuration(configuration) {}
+
+			// methods
+			/**
+			 * \brief Spusti meranie podla volby --mode.
+			 * \param args <odtlacok> <druhy odtlacok> [pocty vlakien], s volbou --mode <priecinok>...
+			 * \return navratovy kod procesu, 1 ak sa paralelny vysledok lisi od serioveho
+			 */
+			int run(const std::vector<std::string>& args) const;
+
+			// static methods
+			static std::string usage();
+		};
+	}
+}
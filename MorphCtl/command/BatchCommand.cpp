@@ -0,0 +1,128 @@
+#include "BatchCommand.h"
+#include "MorphCommand.h"
+
+#include "../exceptions/InvalidArgument.h"
+#include "../utils/Benchmark.h"
+
+#include <storage/Fingerprint.h>
+
+#include <opencv2/core/utility.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+using namespace cli::command;
+
+const std::string BatchCommand::name = "batch";
+
+int BatchCommand::run(const std::vector<std::string>& args) const
+{
+	if (args.size() != 2)
+	{
+		throw exception::InvalidArgument(usage());
+	}
+
+	const auto manifest = utils::Manifest::read(args[0]);
+	const auto& directory = args[1];
+	fs::create_directories(directory);
+
+	auto workers = this->configuration.getWorkers();
+	if (workers == 0)
+	{
+		workers = std::max(1u, std::thread::hardware_concurrency());
+	}
+	workers = static_cast<unsigned int>(std::min<std::size_t>(workers, std::max<std::size_t>(1, manifest.size())));
+
+	// paralelizmus je na urovni dvojic, vnutorne vlakna OpenCV by si s nim konkurovali
+	const auto cvThreads = cv::getNumThreads();
+	if (workers > 1)
+	{
+		cv::setNumThreads(1);
+	}
+
+	std::atomic<std::size_t> next(0);
+	std::atomic<std::size_t> failed(0);
+
+	cv::TickMeter tm; tm.start();
+
+	std::vector<std::thread> pool;
+	for (auto i = 0u; i < workers; i++)
+	{
+		pool.emplace_back(&BatchCommand::work, this, std::cref(manifest), std::ref(next), std::cref(directory), std::ref(failed));
+	}
+	for (auto& worker : pool)
+	{
+		worker.join();
+	}
+
+	tm.stop();
+	cv::setNumThreads(cvThreads);
+
+	std::cerr << manifest.size() << " pairs, " << failed.load() << " failed, "
+		<< workers << " workers, " << tm.getTimeSec() << " s" << std::endl;
+
+	const auto cache = this->configuration.getRotationCache();
+	if (cache)
+	{
+		std::cerr << "rotation cache: " << cache->getHits() << " hits, " << cache->getMisses() << " misses, "
+			<< cache->size() << " entries, " << cache->getUsed() / (1024 * 1024) << " MB" << std::endl;
+	}
+
+	// buffre dvojic sa vratili do poolu, po skonceni davky ich uz netreba drzat
+	const auto buffers = this->configuration.getBufferPool();
+	if (buffers)
+	{
+		std::cerr << "buffer pool: " << buffers->getHits() << " hits, " << buffers->getMisses() << " misses, "
+			<< buffers->size() << " buffers, " << buffers->getRetained() / (1024 * 1024) << " MB" << std::endl;
+
+		buffers->release();
+	}
+
+	return failed.load() == 0 ? 0 : 1;
+}
+
+void BatchCommand::work(const utils::Manifest& manifest, std::atomic<std::size_t>& next,
+	const std::string& directory, std::atomic<std::size_t>& failed) const
+{
+	const MorphCommand command(this->configuration);
+	auto processor = this->configuration.createFingerprintProcessor();
+	auto morpher = this->configuration.createMorphingProcessor(processor);
+
+	const auto& entries = manifest.getEntries();
+	for (auto i = next++; i < entries.size(); i = next++)
+	{
+		const auto& entry = entries[i];
+
+		cv::TickMeter tm; tm.start();
+		try
+		{
+			const auto morphedFingerprint = command.morph(morpher, entry.fingerprint, entry.other);
+			command.write(morphedFingerprint, (fs::path(directory) / entry.name).string(), this->configuration.writesTemplates());
+
+			tm.stop();
+			this->report(entry.name, "ok", tm.getTimeMilli());
+		}
+		catch (std::exception& e)
+		{
+			tm.stop();
+			++failed;
+			this->report(entry.name, e.what(), tm.getTimeMilli());
+		}
+	}
+}
+
+void BatchCommand::report(const std::string& name, const std::string& status, const double time) const
+{
+	std::lock_guard<std::mutex> lock(this->output);
+	// text vynimky nesmie rozbit riadkovy format vystupu
+	std::cout << name << ";" << utils::Benchmark::sanitize(status) << ";" << time << '\n' << std::flush;
+}
+
+std::string BatchCommand::usage()
+{
+	return "batch <manifest> <output directory>";
+}
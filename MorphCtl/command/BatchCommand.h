@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../utils/Configuration.h"
+#include "../utils/Manifest.h"
+
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cli
+{
+	namespace command
+	{
+		/**
+		 * \brief Prikaz davkoveho morfovania dvojic odtlackov zo zoznamu
+		 * utils::Manifest. Dvojice su spracovavane paralelne skupinou
+		 * pracovnych vlakien a vysledok kazdej dvojice je priebezne vypisany
+		 * na standardny vystup v tvare nazov;stav;cas v ms.
+		 */
+		class BatchCommand
+		{
+		private:
+			// members
+			/**
+			 * \brief Parametre spracovania a morfovania.
+			 */
+			utils::Configuration configuration;
+			/**
+			 * \brief Zamok vystupu vysledkov.
+			 */
+			mutable std::mutex output;
+
+			// methods
+			/**
+			 * \brief Telo pracovneho vlakna. Vlakno si vytvori vlastne ovladace
+			 * a spracovava dvojice manifestu az kym nie su vycerpane.
+			 * \param manifest zoznam dvojic
+			 * \param next index dalsej nespracovanej dvojice
+			 * \param directory vystupny priecinok
+			 * \param failed pocet neuspesnych dvojic
+			 */
+			void work(const utils::Manifest& manifest, std::atomic<std::size_t>& next, 
+				const std::string& directory, std::atomic<std::size_t>& failed) const;
+			/**
+			 * \brief Vypise vysledok jednej dvojice. Oddelovace a konce riadkov
+			 * v stave su nahradene medzerou.
+			 * \param name nazov vysledku
+			 * \param status stav spracovania
+			 * \param time cas spracovania v ms
+			 */
+			void report(const std::string& name, const std::string& status, double time) const;
+
+		public:
+			// static members
+			static const std::string name;
+
+			// constructors
+			explicit BatchCommand(const utils::Configuration& configuration) : configuration(configuration) {}
+
+			// methods
+			/**
+			 * \brief Zmorfuje vsetky dvojice manifestu.
+			 * \param args <manifest> <vystupny priecinok>
+			 * \return navratovy kod procesu
+			 */
+			int run(const std::vector<std::string>& args) const;
+
+			// static methods
+			static std::string usage();
+		};
+	}
+}
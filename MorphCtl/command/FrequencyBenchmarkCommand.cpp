@@ -0,0 +1,90 @@
+#include "FrequencyBenchmarkCommand.h"
+
+#include "../exceptions/InvalidArgument.h"
+#include "../utils/Benchmark.h"
+
+#include <storage/Fingerprint.h>
+#include <utils/ImageProcessor.h>
+
+#include <array>
+#include <iostream>
+
+using namespace cli::command;
+using processing::utils::FrequenciesEstimator;
+
+const std::string FrequencyBenchmarkCommand::name = "bench-frequency";
+
+int FrequencyBenchmarkCommand::run(const std::vector<std::string>& args) const
+{
+	if (args.empty())
+	{
+		throw exception::InvalidArgument(usage());
+	}
+
+	const auto processor = this->configuration.createFingerprintProcessor();
+
+	auto signature = this->configuration;
+	signature.useSpectralFrequencies(false);
+	auto spectrum = this->configuration;
+	spectrum.useSpectralFrequencies();
+
+	const std::array<FrequenciesEstimator, 2> estimators = {
+		signature.createFrequenciesEstimator(), spectrum.createFrequenciesEstimator()
+	};
+
+	std::cout << "name;signature ms;spectral ms;signature distance;spectral distance;"
+		"signature block;spectral block;signature area;spectral area;" << std::endl;
+
+	for (const auto& directory : args)
+	{
+		const auto files = utils::Benchmark::listImages(directory);
+
+		std::array<double, 2> times = {}, distances = {}, areas = {};
+
+		const auto counts = utils::Benchmark::forEachImage(files, [&](const std::string& name, const std::string& file)
+		{
+			processing::storage::Fingerprint f(processing::utils::ImageProcessor::read(file));
+
+			this->configuration.adapt(f);
+			processor.preprocess(f);
+
+			const auto normalized = f.getNormalized();
+
+			std::array<double, 2> time, distance, area;
+			std::array<int, 2> block;
+
+			for (auto k = 0; k < 2; k++)
+			{
+				FrequenciesEstimator::Workspace workspace(f.getOrientations());
+
+				cv::Mat frequencies;
+				time[k] = utils::Benchmark::measure([&] { frequencies = estimators[k].estimate(normalized, workspace); });
+				distance[k] = workspace.regionMask.getAveragePeakDistance();
+				block[k] = workspace.regionMask.idealGaborBlock();
+				area[k] = static_cast<double>(frequencies.total()) / static_cast<double>(normalized.total());
+			}
+
+			for (auto k = 0; k < 2; k++)
+			{
+				times[k] += time[k];
+				distances[k] += distance[k];
+				areas[k] += area[k];
+			}
+
+			std::cout << name << ";" << time[0] << ";" << time[1] << ";" << distance[0] << ";" << distance[1] << ";"
+				<< block[0] << ";" << block[1] << ";" << area[0] << ";" << area[1] << ";" << std::endl;
+		});
+
+		utils::Benchmark::summary(directory, counts, "fingerprints")
+			<< ", signature ms " << counts.mean(times[0]) << ", spectral ms " << counts.mean(times[1])
+			<< ", signature distance " << counts.mean(distances[0]) << ", spectral distance " << counts.mean(distances[1])
+			<< ", signature area " << counts.mean(areas[0]) << ", spectral area " << counts.mean(areas[1]) << std::endl;
+	}
+
+	return 0;
+}
+
+std::string FrequencyBenchmarkCommand::usage()
+{
+	return "bench-frequency <directory>...";
+}
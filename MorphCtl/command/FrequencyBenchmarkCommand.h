@@ -0,0 +1,50 @@
+#pragma once
+
+#include "../utils/Configuration.h"
+
+#include <string>
+#include <vector>
+
+namespace cli
+{
+	namespace command
+	{
+		/**
+		 * \brief Prikaz porovnania odhadu frekvencii z x-signatury a zo spektra okien.
+		 * Pre kazdy odtlacok z kazdeho zadaneho priecinka vypise na standardny vystup
+		 * riadok v tvare
+		 * nazov;signatura ms;spektrum ms;signatura vzdialenost;spektrum vzdialenost;
+		 * signatura blok;spektrum blok;signatura plocha;spektrum plocha.
+		 * Vzdialenost je priemerna vzdialenost linii popredia, blok idealna velkost
+		 * bloku Gaborovho filtra a plocha podiel oblasti popredia na odtlacku.
+		 * Suhrn kazdeho priecinka vypise na standardny chybovy vystup.
+		 */
+		class FrequencyBenchmarkCommand
+		{
+		private:
+			// members
+			/**
+			 * \brief Parametre spracovania odtlackov.
+			 */
+			utils::Configuration configuration;
+
+		public:
+			// static members
+			static const std::string name;
+
+			// constructors
+			explicit FrequencyBenchmarkCommand(const utils::Configuration& configuration) : configuration(configuration) {}
+
+			// methods
+			/**
+			 * \brief Porovna oba odhady frekvencii na vsetkych odtlackoch zadanych priecinkov.
+			 * \param args <priecinok>...
+			 * \return navratovy kod procesu
+			 */
+			int run(const std::vector<std::string>& args) const;
+
+			// static methods
+			static std::string usage();
+		};
+	}
+}
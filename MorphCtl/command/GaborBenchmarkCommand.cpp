@@ -0,0 +1,126 @@
+#include "GaborBenchmarkCommand.h"
+
+#include "../exceptions/InvalidArgument.h"
+#include "../utils/Benchmark.h"
+
+#include <storage/Fingerprint.h>
+#include <utils/GaborBank.h>
+#include <utils/ImageProcessor.h>
+
+#include <array>
+#include <iostream>
+
+using namespace cli::command;
+
+const std::string GaborBenchmarkCommand::name = "bench-gabor";
+
+int GaborBenchmarkCommand::run(const std::vector<std::string>& args) const
+{
+	if (args.empty())
+	{
+		throw exception::InvalidArgument(usage());
+	}
+
+	// banka z prikazoveho riadku, inak s predvolenym kvantovanim
+	auto bank = this->configuration.getGaborBank();
+	if (!bank)
+	{
+		bank = std::make_shared<processing::utils::GaborBank>();
+	}
+
+	auto exact = this->configuration;
+	exact.setGaborBank(nullptr).useGaborComposite(false);
+	auto quantized = this->configuration;
+	quantized.setGaborBank(bank).useGaborComposite(false);
+	auto nearest = quantized;
+	nearest.useGaborComposite().useGaborBlend(false);
+	auto blend = nearest;
+	blend.useGaborBlend();
+
+	const auto exactProcessor = exact.createFingerprintProcessor();
+	const auto quantizedProcessor = quantized.createFingerprintProcessor();
+	const auto deviation = static_cast<float>(this->configuration.getDeviation());
+
+	// skladanie sa meria priamo na filtri, pocet filtrovani je v jeho pracovnych datach
+	const std::array<processing::utils::GaborFilter, 2> composites = {
+		nearest.createGaborFilter(), blend.createGaborFilter()
+	};
+
+	std::cerr << "gabor bank: " << bank->getOrientations() << " orientations, "
+		<< bank->getWavelengths() << " wavelengths, " << composites[0].getCompositeWavelengths()
+		<< " composite wavelengths per orientation" << std::endl;
+	std::cout << "name;block;bank ms;exact ms;quantized ms;nearest ms;blend ms;nearest passes;blend passes;"
+		"difference;nearest difference;blend difference;" << std::endl;
+
+	for (const auto& directory : args)
+	{
+		const auto files = utils::Benchmark::listImages(directory);
+
+		auto bankTime = .0, exactTime = .0, quantizedTime = .0, difference = .0;
+		std::array<double, 2> compositeTimes = {}, compositePasses = {}, compositeDifferences = {};
+
+		const auto counts = utils::Benchmark::forEachImage(files, [&](const std::string& name, const std::string& file)
+		{
+			processing::storage::Fingerprint f(processing::utils::ImageProcessor::read(file));
+			this->configuration.prepare(exactProcessor, f);
+
+			const auto blockSize = f.getRegionMask().idealGaborBlock();
+
+			// jadra sa vytvoria mimo merania filtrovania
+			const auto built = bank->size();
+			const auto kernels = bank->get(blockSize, deviation);
+			const auto t0 = bank->size() > built ? kernels->getBuildTime() : .0;
+
+			const auto t1 = utils::Benchmark::measure([&] { exactProcessor.filterFingerprint(f); });
+			const cv::Mat reference = f.getFiltered().clone();
+
+			const auto t2 = utils::Benchmark::measure([&] { quantizedProcessor.filterFingerprint(f); });
+			const auto d = cv::norm(reference, f.getFiltered(), cv::NORM_L1) / static_cast<double>(reference.total());
+
+			std::array<double, 2> time, distance;
+			std::array<int, 2> passes;
+
+			for (auto k = 0; k < 2; k++)
+			{
+				processing::utils::GaborFilter::Workspace workspace(f.getOrientations(), f.getFrequencies(), blockSize);
+
+				cv::Mat filtered;
+				time[k] = utils::Benchmark::measure([&] { filtered = composites[k].filter(f.getNormalized(), workspace); });
+				passes[k] = workspace.passes;
+				distance[k] = cv::norm(reference, filtered, cv::NORM_L1) / static_cast<double>(reference.total());
+			}
+
+			bankTime += t0;
+			exactTime += t1;
+			quantizedTime += t2;
+			difference += d;
+			for (auto k = 0; k < 2; k++)
+			{
+				compositeTimes[k] += time[k];
+				compositePasses[k] += passes[k];
+				compositeDifferences[k] += distance[k];
+			}
+
+			std::cout << name << ";" << blockSize << ";" << t0 << ";" << t1 << ";" << t2 << ";" << time[0] << ";" << time[1] << ";"
+				<< passes[0] << ";" << passes[1] << ";" << d << ";" << distance[0] << ";" << distance[1] << ";" << std::endl;
+		});
+
+		utils::Benchmark::summary(directory, counts, "fingerprints") << ", bank ms " << bankTime
+			<< ", exact ms " << counts.mean(exactTime)
+			<< ", quantized ms " << counts.mean(quantizedTime)
+			<< ", nearest ms " << counts.mean(compositeTimes[0])
+			<< ", blend ms " << counts.mean(compositeTimes[1])
+			<< ", nearest passes " << counts.mean(compositePasses[0])
+			<< ", blend passes " << counts.mean(compositePasses[1])
+			<< ", difference " << counts.mean(difference)
+			<< ", nearest difference " << counts.mean(compositeDifferences[0])
+			<< ", blend difference " << counts.mean(compositeDifferences[1]) << std::endl;
+	}
+
+	return 0;
+}
+
+std::string GaborBenchmarkCommand::usage()
+{
+	return "bench-gabor <directory>...";
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../utils/Configuration.h"
+
+#include <string>
+#include <vector>
+
+namespace cli
+{
+	namespace command
+	{
+		/**
+		 * \brief Prikaz merania vylepsenia odtlacku Gaborovym filtrom s jadrom vytvaranym
+		 * pre kazdy blok, s bankou kvantovanych jadier a skladanim odoziev s vyberom
+		 * najblizsej vlnovej dlzky aj s prelinanim dvoch ohranicujucich. Pre kazdy odtlacok
+		 * z kazdeho zadaneho priecinka vypise na standardny vystup riadok v tvare
+		 * nazov;blok;banka ms;povodne ms;kvantovane ms;najblizsia ms;prelinanie ms;
+		 * najblizsia filtrovania;prelinanie filtrovania;rozdiel;rozdiel najblizsej;rozdiel prelinania.
+		 * Cas banky je cas vytvorenia jadier pre velkost bloku odtlacku (0 ak uz boli
+		 * vytvorene), rozdiely su priemerne absolutne rozdiely voci povodnemu vylepseniu.
+		 * Suhrn kazdeho priecinka vypise na standardny chybovy vystup.
+		 */
+		class GaborBenchmarkCommand
+		{
+		private:
+			// members
+			/**
+			 * \brief Parametre spracovania odtlackov, pripadne aj banka jadier.
+			 */
+			utils::Configuration configuration;
+
+		public:
+			// static members
+			static const std::string name;
+
+			// constructors
+			explicit GaborBenchmarkCommand(const utils::Configuration& configuration) : configuration(configuration) {}
+
+			// methods
+			/**
+			 * \brief Zmeria vylepsenie vsetkymi sposobmi na vsetkych odtlackoch zadanych priecinkov.
+			 * \param args <priecinok>...
+			 * \return navratovy kod procesu
+			 */
+			int run(const std::vector<std::string>& args) const;
+
+			// static methods
+			static std::string usage();
+		};
+	}
+}
@@ -0,0 +1,80 @@
+#include "MinutiaeBenchmarkCommand.h"
+
+#include "../exceptions/InvalidArgument.h"
+#include "../utils/Benchmark.h"
+
+#include <storage/Fingerprint.h>
+#include <storage/AlignedFingerprint.h>
+#include <storage/Minutiae.h>
+#include <utils/ImageProcessor.h>
+
+#include <iostream>
+
+using namespace cli::command;
+
+const std::string MinutiaeBenchmarkCommand::name = "bench-minutiae";
+
+int MinutiaeBenchmarkCommand::run(const std::vector<std::string>& args) const
+{
+	if (args.empty())
+	{
+		throw exception::InvalidArgument(usage());
+	}
+
+	auto processor = this->configuration.createFingerprintProcessor();
+	auto aligner = this->configuration.createFingerprintAligner(processor);
+	auto cutline = this->configuration.createCutlineEstimator(processor);
+
+	std::cerr << "minutia record: " << sizeof(processing::utils::storage::Minutiae) << " bytes" << std::endl;
+	std::cout << "name;minutiae;fake ms;cutline ms;" << std::endl;
+
+	for (const auto& directory : args)
+	{
+		const auto files = utils::Benchmark::listImages(directory);
+
+		auto fakeTime = .0, cutlineTime = .0;
+
+		const auto counts = utils::Benchmark::forEachPair(files, [&](const std::string& name, const std::string& file, const std::string& other)
+		{
+			processing::storage::Fingerprint f(processing::utils::ImageProcessor::read(file));
+			morphing::storage::AlignedFingerprint af(processing::utils::ImageProcessor::read(other));
+
+			this->configuration.prepare(processor, f);
+			this->configuration.prepare(processor, af);
+
+			aligner.align(af, f);
+
+			auto count = 0;
+			const auto t1 = this->minutiaes(processor, af, count) + this->minutiaes(processor, f, count);
+			const auto t2 = utils::Benchmark::measure([&] { cutline.estimate(af, f); });
+
+			fakeTime += t1;
+			cutlineTime += t2;
+
+			std::cout << name << ";" << count << ";" << t1 << ";" << t2 << ";" << std::endl;
+		});
+
+		utils::Benchmark::summary(directory, counts, "pairs") << ", fake ms " << counts.mean(fakeTime)
+			<< ", cutline ms " << counts.mean(cutlineTime) << std::endl;
+	}
+
+	return 0;
+}
+
+double MinutiaeBenchmarkCommand::minutiaes(const processing::FingerprintProcessor& processor, processing::storage::Fingerprint& fingerprint,
+	int& count) const
+{
+	processor.filterFingerprint(fingerprint);
+	processing::FingerprintProcessor::binarize(fingerprint);
+	processing::FingerprintProcessor::thinning(fingerprint);
+	processor.estimateMinutiaes(fingerprint);
+
+	count += static_cast<int>(fingerprint.getMinutiae().size());
+
+	return utils::Benchmark::measure([&] { processor.handleFakeMinutiaes(fingerprint); });
+}
+
+std::string MinutiaeBenchmarkCommand::usage()
+{
+	return "bench-minutiae <directory>...";
+}
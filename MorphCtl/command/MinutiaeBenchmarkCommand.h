@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../utils/Configuration.h"
+
+#include <string>
+#include <vector>
+
+namespace cli
+{
+	namespace command
+	{
+		/**
+		 * \brief Prikaz merania odstranenia falosnych markantov a odhadu reznej linie.
+		 * Pre kazdu dvojicu odtlackov z kazdeho zadaneho priecinka vypise na standardny
+		 * vystup riadok v tvare
+		 * nazov;markanty;falosne markanty ms;rezna linia ms.
+		 * Markanty su pocty markantov oboch odtlackov pred odstranenim falosnych,
+		 * cas falosnych markantov je sucet za oba odtlacky. Suhrn kazdeho priecinka
+		 * vypise na standardny chybovy vystup.
+		 */
+		class MinutiaeBenchmarkCommand
+		{
+		private:
+			// members
+			/**
+			 * \brief Parametre spracovania, zarovnania a odhadu reznej linie.
+			 */
+			utils::Configuration configuration;
+
+			// methods
+			/**
+			 * \brief Pripravi odtlacok po odhad markantov a zmeria odstranenie falosnych markantov.
+			 * \param processor ovladac spracovania odtlackov
+			 * \param fingerprint odtlacok s odhadnutymi vlastnostami
+			 * \param count sem sa pripocita pocet markantov pred odstranenim falosnych
+			 * \return cas odstranenia falosnych markantov v ms
+			 */
+			double minutiaes(const processing::FingerprintProcessor& processor, processing::storage::Fingerprint& fingerprint, int& count) const;
+
+		public:
+			// static members
+			static const std::string name;
+
+			// constructors
+			explicit MinutiaeBenchmarkCommand(const utils::Configuration& configuration) : configuration(configuration) {}
+
+			// methods
+			/**
+			 * \brief Zmeria odstranenie falosnych markantov a odhad reznej linie na vsetkych
+			 * dvojiciach odtlackov zadanych priecinkov.
+			 * \param args <priecinok>...
+			 * \return navratovy kod procesu
+			 */
+			int run(const std::vector<std::string>& args) const;
+
+			// static methods
+			static std::string usage();
+		};
+	}
+}
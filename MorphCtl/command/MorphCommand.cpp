@@ -0,0 +1,66 @@
+#include "MorphCommand.h"
+
+#include "../exceptions/InvalidArgument.h"
+
+#include <storage/Fingerprint.h>
+#include <storage/AlignedFingerprint.h>
+#include <utils/ImageProcessor.h>
+#include <Matcher.h>
+
+#include <iostream>
+
+using namespace cli::command;
+
+const std::string MorphCommand::name = "morph";
+
+int MorphCommand::run(const std::vector<std::string>& args) const
+{
+	if (args.size() != 3)
+	{
+		throw exception::InvalidArgument(usage());
+	}
+
+	auto processor = this->configuration.createFingerprintProcessor();
+	auto morpher = this->configuration.createMorphingProcessor(processor);
+
+	const auto morphedFingerprint = this->morph(morpher, args[0], args[1]);
+	this->write(morphedFingerprint, args[2]);
+
+	std::cout << args[2] << ".jpg" << std::endl;
+
+	return 0;
+}
+
+processing::storage::Fingerprint MorphCommand::morph(morphing::MorphingProcessor& morpher,
+	const std::string& fingerprintPath, const std::string& otherPath) const
+{
+	const auto img1 = processing::utils::ImageProcessor::read(fingerprintPath);
+	const auto img2 = processing::utils::ImageProcessor::read(otherPath);
+
+	processing::storage::Fingerprint fingerprint(img1);
+	morphing::storage::AlignedFingerprint aFingerprint(img2);
+
+	// nazov identifikuje odtlacok vo vyrovnavacej pamati otoceni
+	fingerprint.fingerName = fingerprintPath;
+	aFingerprint.fingerName = otherPath;
+
+	this->configuration.adapt(fingerprint);
+	this->configuration.adapt(aFingerprint);
+
+	return morpher.morph(aFingerprint, fingerprint);
+}
+
+void MorphCommand::write(const processing::storage::Fingerprint& fingerprint, const std::string& output, const bool templates) const
+{
+	processing::FingerprintProcessor::write(fingerprint.get(), output);
+
+	if (templates)
+	{
+		matching::Matcher::createTxtMinutiaTemplate(fingerprint, output + ".txt");
+	}
+}
+
+std::string MorphCommand::usage()
+{
+	return "morph <fingerprint> <fingerprint> <output>";
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../utils/Configuration.h"
+
+#include <string>
+#include <vector>
+
+namespace cli
+{
+	namespace command
+	{
+		/**
+		 * \brief Prikaz morfovania jednej dvojice odtlackov bez grafickeho
+		 * rozhrania. Vysledny odtlacok zapise spolu so sablonou markantov.
+		 */
+		class MorphCommand
+		{
+		private:
+			// members
+			/**
+			 * \brief Parametre spracovania a morfovania.
+			 */
+			utils::Configuration configuration;
+
+		public:
+			// static members
+			static const std::string name;
+
+			// constructors
+			explicit MorphCommand(const utils::Configuration& configuration) : configuration(configuration) {}
+
+			// methods
+			/**
+			 * \brief Zmorfuje dvojicu odtlackov.
+			 * \param args <odtlacok> <druhy odtlacok> <vystup bez pripony>
+			 * \return navratovy kod procesu
+			 */
+			int run(const std::vector<std::string>& args) const;
+			/**
+			 * \brief Nacita dvojicu odtlackov a zmorfuje ju.
+			 * \param morpher ovladac morfovania
+			 * \param fingerprintPath cesta k odtlacku
+			 * \param otherPath cesta k odtlacku, ktory bude zarovnany
+			 * \return morfovany odtlacok
+			 */
+			processing::storage::Fingerprint morph(morphing::MorphingProcessor& morpher,
+				const std::string& fingerprintPath, const std::string& otherPath) const;
+			/**
+			 * \brief Zapise morfovany odtlacok, pripadne aj jeho sablonu markantov.
+			 * \param fingerprint morfovany odtlacok
+			 * \param output cesta k vystupu bez pripony
+			 * \param templates indikator zapisu sablony markantov
+			 */
+			void write(const processing::storage::Fingerprint& fingerprint, const std::string& output, bool templates = true) const;
+
+			// static methods
+			static std::string usage();
+		};
+	}
+}
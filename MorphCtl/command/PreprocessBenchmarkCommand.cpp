@@ -0,0 +1,86 @@
+#include "PreprocessBenchmarkCommand.h"
+
+#include "../exceptions/InvalidArgument.h"
+#include "../utils/Benchmark.h"
+
+#include <storage/Fingerprint.h>
+#include <utils/ImageProcessor.h>
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+
+using namespace cli::command;
+using processing::utils::Preprocessor;
+
+const std::string PreprocessBenchmarkCommand::name = "bench-preprocess";
+
+int PreprocessBenchmarkCommand::run(const std::vector<std::string>& args) const
+{
+	if (args.empty())
+	{
+		throw exception::InvalidArgument(usage());
+	}
+
+	auto separate = this->configuration;
+	separate.useFusedPreprocessing(false);
+	auto fused = this->configuration;
+	fused.useFusedPreprocessing();
+
+	const std::array<processing::FingerprintProcessor, 2> processors = {
+		separate.createFingerprintProcessor(), fused.createFingerprintProcessor()
+	};
+
+	std::cout << "name;separate ms;fused ms;normalized difference;orientations difference;" << std::endl;
+
+	for (const auto& directory : args)
+	{
+		const auto files = utils::Benchmark::listImages(directory);
+
+		std::array<double, 2> times = {};
+		auto normalizedDifference = .0, orientationsDifference = .0;
+
+		// pracovne data su znovu pouzite pre vsetky odtlacky priecinka
+		Preprocessor::Workspace workspace;
+
+		const auto counts = utils::Benchmark::forEachImage(files, [&](const std::string& name, const std::string& file)
+		{
+			const auto img = processing::utils::ImageProcessor::read(file);
+
+			std::array<double, 2> time;
+			std::array<cv::Mat, 2> normalized, orientations;
+
+			for (auto k = 0; k < 2; k++)
+			{
+				processing::storage::Fingerprint f(img);
+				this->configuration.adapt(f);
+
+				time[k] = utils::Benchmark::measure([&] { processors[k].preprocess(f, workspace); });
+				normalized[k] = f.getNormalized();
+				orientations[k] = f.getOrientations();
+			}
+
+			const auto n = cv::norm(normalized[0], normalized[1], cv::NORM_INF);
+			const auto o = cv::norm(orientations[0], orientations[1], cv::NORM_INF);
+
+			times[0] += time[0];
+			times[1] += time[1];
+			normalizedDifference = std::max(normalizedDifference, n);
+			orientationsDifference = std::max(orientationsDifference, o);
+
+			std::cout << name << ";" << time[0] << ";" << time[1] << ";" << n << ";" << o << ";" << std::endl;
+		});
+
+		utils::Benchmark::summary(directory, counts, "fingerprints")
+			<< ", separate ms " << counts.mean(times[0]) << ", fused ms " << counts.mean(times[1])
+			<< ", max normalized difference " << normalizedDifference
+			<< ", max orientations difference " << orientationsDifference << std::endl;
+	}
+
+	return 0;
+}
+
+std::string PreprocessBenchmarkCommand::usage()
+{
+	return "bench-preprocess <directory>...";
+}
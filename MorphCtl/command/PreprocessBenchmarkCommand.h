@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../utils/Configuration.h"
+
+#include <string>
+#include <vector>
+
+namespace cli
+{
+	namespace command
+	{
+		/**
+		 * \brief Prikaz porovnania oddelenej normalizacie a odhadu orientacii so spojenym
+		 * predspracovanim. Pre kazdy odtlacok z kazdeho zadaneho priecinka vypise na
+		 * standardny vystup riadok v tvare
+		 * nazov;oddelene ms;spojene ms;normalizacia rozdiel;orientacie rozdiel.
+		 * Rozdiel je najvacsi absolutny rozdiel hodnot oboch vysledkov.
+		 * Suhrn kazdeho priecinka vypise na standardny chybovy vystup.
+		 */
+		class PreprocessBenchmarkCommand
+		{
+		private:
+			// members
+			/**
+			 * \brief Parametre spracovania odtlackov.
+			 */
+			utils::Configuration configuration;
+
+		public:
+			// static members
+			static const std::string name;
+
+			// constructors
+			explicit PreprocessBenchmarkCommand(const utils::Configuration& configuration) : configuration(configuration) {}
+
+			// methods
+			/**
+			 * \brief Porovna oba sposoby predspracovania na vsetkych odtlackoch zadanych priecinkov.
+			 * \param args <priecinok>...
+			 * \return navratovy kod procesu
+			 */
+			int run(const std::vector<std::string>& args) const;
+
+			// static methods
+			static std::string usage();
+		};
+	}
+}
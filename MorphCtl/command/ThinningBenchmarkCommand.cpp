@@ -0,0 +1,77 @@
+#include "ThinningBenchmarkCommand.h"
+
+#include "../exceptions/InvalidArgument.h"
+#include "../utils/Benchmark.h"
+
+#include <storage/Fingerprint.h>
+#include <utils/ImageProcessor.h>
+
+#include <iostream>
+
+using namespace cli::command;
+using processing::utils::ImageProcessor;
+
+const std::string ThinningBenchmarkCommand::name = "bench-thinning";
+
+int ThinningBenchmarkCommand::run(const std::vector<std::string>& args) const
+{
+	if (args.empty())
+	{
+		throw exception::InvalidArgument(usage());
+	}
+
+	auto processor = this->configuration.createFingerprintProcessor();
+
+	std::cout << "name;pixels;reference ms;fast ms;mismatch;" << std::endl;
+
+	auto mismatched = 0;
+
+	for (const auto& directory : args)
+	{
+		const auto files = utils::Benchmark::listImages(directory);
+
+		auto different = 0;
+		auto referenceTime = .0, fastTime = .0;
+
+		const auto counts = utils::Benchmark::forEachImage(files, [&](const std::string& name, const std::string& file)
+		{
+			processing::storage::Fingerprint f(ImageProcessor::read(file));
+
+			this->configuration.prepare(processor, f);
+			processor.filterFingerprint(f);
+			processing::FingerprintProcessor::binarize(f);
+
+			const auto segmentation = f.getSegmentation();
+			cv::Mat reference, fast;
+			f.getBinarized().copyTo(reference);
+			f.getBinarized().copyTo(fast);
+
+			const auto pixels = cv::countNonZero(reference);
+
+			const auto t1 = utils::Benchmark::measure([&] { ImageProcessor::thineReference(reference, segmentation); });
+			const auto t2 = utils::Benchmark::measure([&] { ImageProcessor::thine(fast, segmentation); });
+
+			cv::Mat diff;
+			cv::absdiff(reference, fast, diff);
+			const auto mismatch = cv::countNonZero(diff);
+
+			referenceTime += t1;
+			fastTime += t2;
+			different += mismatch > 0;
+
+			std::cout << name << ";" << pixels << ";" << t1 << ";" << t2 << ";" << mismatch << ";" << std::endl;
+		});
+
+		mismatched += different;
+
+		utils::Benchmark::summary(directory, counts, "fingerprints") << ", " << different << " different, reference ms "
+			<< counts.mean(referenceTime) << ", fast ms " << counts.mean(fastTime) << std::endl;
+	}
+
+	return mismatched > 0 ? 1 : 0;
+}
+
+std::string ThinningBenchmarkCommand::usage()
+{
+	return "bench-thinning <directory>...";
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../utils/Configuration.h"
+
+#include <string>
+#include <vector>
+
+namespace cli
+{
+	namespace command
+	{
+		/**
+		 * \brief Prikaz merania a overenia stencovania. Pre kazdy odtlacok z kazdeho
+		 * zadaneho priecinka vypise na standardny vystup riadok v tvare
+		 * nazov;body linii;povodne ms;rychle ms;rozdielne body.
+		 * Povodne stencovanie prechadza cely obrazok v kazdej iteracii, rychle
+		 * vyhodnocuje iba body obrysu. Suhrn kazdeho priecinka vypise na standardny
+		 * chybovy vystup, pri rozdielnych vysledkoch skonci s chybovym kodom.
+		 */
+		class ThinningBenchmarkCommand
+		{
+		private:
+			// members
+			/**
+			 * \brief Parametre spracovania odtlackov.
+			 */
+			utils::Configuration configuration;
+
+		public:
+			// static members
+			static const std::string name;
+
+			// constructors
+			explicit ThinningBenchmarkCommand(const utils::Configuration& configuration) : configuration(configuration) {}
+
+			// methods
+			/**
+			 * \brief Zmeria a porovna oba sposoby stencovania na vsetkych odtlackoch zadanych priecinkov.
+			 * \param args <priecinok>...
+			 * \return navratovy kod procesu, 1 ak sa vysledky lisia
+			 */
+			int run(const std::vector<std::string>& args) const;
+
+			// static methods
+			static std::string usage();
+		};
+	}
+}
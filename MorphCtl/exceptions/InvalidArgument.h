@@ -0,0 +1,20 @@
+#pragma once
+
+#include <exception>
+#include <string>
+
+namespace exception
+{
+	class InvalidArgument final : public std::exception
+	{
+		std::string msg;
+
+	public:
+		explicit InvalidArgument(const std::string& argument) : msg("Invalid command line argument: " + argument) {}
+
+		const char* what() const noexcept override
+		{
+			return msg.c_str();
+		}
+	};
+}
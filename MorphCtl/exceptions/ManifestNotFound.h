@@ -0,0 +1,20 @@
+#pragma once
+
+#include <exception>
+#include <string>
+
+namespace exception
+{
+	class ManifestNotFound final : public std::exception
+	{
+		std::string msg;
+
+	public:
+		explicit ManifestNotFound(const std::string& path) : msg("Manifest not found: " + path) {}
+
+		const char* what() const noexcept override
+		{
+			return msg.c_str();
+		}
+	};
+}
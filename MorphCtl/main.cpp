@@ -0,0 +1,93 @@
+#include "command/AlignBenchmarkCommand.h"
+#include "command/BatchCommand.h"
+#include "command/FrequencyBenchmarkCommand.h"
+#include "command/GaborBenchmarkCommand.h"
+#include "command/MinutiaeBenchmarkCommand.h"
+#include "command/MorphCommand.h"
+#include "command/PreprocessBenchmarkCommand.h"
+#include "command/ThinningBenchmarkCommand.h"
+#include "utils/Configuration.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	void printUsage()
+	{
+		std::cerr << "usage: morphctl <command> [options] <arguments>" << std::endl
+			<< "commands:" << std::endl
+			<< "  " << cli::command::MorphCommand::usage() << std::endl
+			<< "  " << cli::command::BatchCommand::usage() << std::endl
+			<< "  " << cli::command::AlignBenchmarkCommand::usage() << std::endl
+			<< "  " << cli::command::MinutiaeBenchmarkCommand::usage() << std::endl
+			<< "  " << cli::command::ThinningBenchmarkCommand::usage() << std::endl
+			<< "  " << cli::command::GaborBenchmarkCommand::usage() << std::endl
+			<< "  " << cli::command::FrequencyBenchmarkCommand::usage() << std::endl
+			<< "  " << cli::command::PreprocessBenchmarkCommand::usage() << std::endl
+			<< cli::utils::Configuration::usage();
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		printUsage();
+		return 1;
+	}
+
+	const std::string command = argv[1];
+	const std::vector<std::string> args(argv + 2, argv + argc);
+
+	try
+	{
+		std::vector<std::string> positional;
+		const auto configuration = cli::utils::Configuration::parse(args, positional);
+
+		// matice vsetkych prikazov sa alokuju z poolu, ak je zapnuty
+		const processing::utils::BufferPool::Scope scope(configuration.getBufferPool().get());
+
+		if (command == cli::command::MorphCommand::name)
+		{
+			return cli::command::MorphCommand(configuration).run(positional);
+		}
+		if (command == cli::command::BatchCommand::name)
+		{
+			return cli::command::BatchCommand(configuration).run(positional);
+		}
+		if (command == cli::command::AlignBenchmarkCommand::name)
+		{
+			return cli::command::AlignBenchmarkCommand(configuration).run(positional);
+		}
+		if (command == cli::command::MinutiaeBenchmarkCommand::name)
+		{
+			return cli::command::MinutiaeBenchmarkCommand(configuration).run(positional);
+		}
+		if (command == cli::command::ThinningBenchmarkCommand::name)
+		{
+			return cli::command::ThinningBenchmarkCommand(configuration).run(positional);
+		}
+		if (command == cli::command::GaborBenchmarkCommand::name)
+		{
+			return cli::command::GaborBenchmarkCommand(configuration).run(positional);
+		}
+		if (command == cli::command::FrequencyBenchmarkCommand::name)
+		{
+			return cli::command::FrequencyBenchmarkCommand(configuration).run(positional);
+		}
+		if (command == cli::command::PreprocessBenchmarkCommand::name)
+		{
+			return cli::command::PreprocessBenchmarkCommand(configuration).run(positional);
+		}
+	}
+	catch (std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	printUsage();
+	return 1;
+}
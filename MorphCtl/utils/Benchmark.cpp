@@ -0,0 +1,111 @@
+#include "Benchmark.h"
+
+#include "../exceptions/InvalidArgument.h"
+
+#include <storage/Fingerprint.h>
+#include <storage/AlignedFingerprint.h>
+#include <utils/ImageProcessor.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+using namespace cli::utils;
+
+std::vector<std::string> Benchmark::listImages(const std::string& directory)
+{
+	if (!fs::is_directory(directory))
+	{
+		throw exception::InvalidArgument(directory);
+	}
+
+	std::vector<std::string> files;
+	for (const auto& entry : fs::directory_iterator(directory))
+	{
+		if (entry.is_regular_file())
+		{
+			files.push_back(entry.path().string());
+		}
+	}
+	std::sort(files.begin(), files.end());
+
+	return files;
+}
+
+Benchmark::Counts Benchmark::forEachImage(const std::vector<std::string>& files, const ImageTask& task)
+{
+	Counts counts;
+
+	for (const auto& file : files)
+	{
+		const auto name = fs::path(file).stem().string();
+
+		try
+		{
+			task(name, file);
+			counts.processed++;
+		}
+		catch (std::exception& e)
+		{
+			counts.failed++;
+			std::cout << name << ";" << sanitize(e.what()) << ";-1;" << std::endl;
+		}
+	}
+
+	return counts;
+}
+
+Benchmark::Counts Benchmark::forEachPair(const std::vector<std::string>& files, const PairTask& task)
+{
+	Counts counts;
+
+	for (auto i = 0u; i < files.size(); i++)
+	{
+		for (auto j = i + 1; j < files.size(); j++)
+		{
+			const auto name = fs::path(files[i]).stem().string() + "_" + fs::path(files[j]).stem().string();
+
+			try
+			{
+				task(name, files[i], files[j]);
+				counts.processed++;
+			}
+			catch (std::exception& e)
+			{
+				counts.failed++;
+				std::cout << name << ";" << sanitize(e.what()) << ";-1;" << std::endl;
+			}
+		}
+	}
+
+	return counts;
+}
+
+cv::Vec3f Benchmark::align(const Configuration& configuration, const processing::FingerprintProcessor& processor,
+	const morphing::utils::FingerprintAligner& aligner, const std::string& fingerprintPath, const std::string& otherPath, double& time)
+{
+	processing::storage::Fingerprint f(processing::utils::ImageProcessor::read(fingerprintPath));
+	morphing::storage::AlignedFingerprint af(processing::utils::ImageProcessor::read(otherPath));
+
+	configuration.prepare(processor, f);
+	configuration.prepare(processor, af);
+
+	time = measure([&] { aligner.align(af, f); });
+
+	return af.getAlignment();
+}
+
+std::ostream& Benchmark::summary(const std::string& directory, const Counts& counts, const std::string& unit)
+{
+	return std::cerr << directory << ": " << counts.processed << " " << unit << ", " << counts.failed << " failed";
+}
+
+std::string Benchmark::sanitize(const std::string& text)
+{
+	auto sanitized = text;
+	std::replace_if(sanitized.begin(), sanitized.end(), [](const char c) { return c == ';' || c == '\n' || c == '\r'; }, ' ');
+
+	return sanitized;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Configuration.h"
+
+#include <opencv2/core/utility.hpp>
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cli
+{
+	namespace utils
+	{
+		/**
+		 * \brief Spolocne kroky prikazov merania: zoznam obrazkov priecinka, prechod
+		 * odtlackami alebo ich dvojicami s riadkom chyby pre kazdy neuspesny prvok,
+		 * meranie casu a suhrn priecinka na standardnom chybovom vystupe. Riadok chyby
+		 * ma rovnako ako vystup davky tvar nazov;chyba;-1.
+		 */
+		class Benchmark
+		{
+		public:
+			/**
+			 * \brief Pocty spracovanych a neuspesnych prvkov priecinka.
+			 */
+			struct Counts
+			{
+				int processed = 0;
+				int failed = 0;
+
+				/**
+				 * \brief Priemer hodnoty na spracovany prvok.
+				 * \param total sucet hodnoty
+				 * \return priemer, 0 ak nebol spracovany ziadny prvok
+				 */
+				double mean(const double total) const { return this->processed > 0 ? total / this->processed : .0; }
+			};
+
+			/**
+			 * \brief Uloha nad jednym odtlackom (nazov, cesta).
+			 */
+			using ImageTask = std::function<void(const std::string&, const std::string&)>;
+			/**
+			 * \brief Uloha nad dvojicou odtlackov (nazov, cesta k odtlacku, cesta k druhemu odtlacku).
+			 */
+			using PairTask = std::function<void(const std::string&, const std::string&, const std::string&)>;
+
+			// static methods
+			/**
+			 * \brief Zoznam suborov priecinka zoradeny podla cesty.
+			 * \param directory priecinok
+			 * \return cesty k suborom
+			 */
+			static std::vector<std::string> listImages(const std::string& directory);
+			/**
+			 * \brief Spusti ulohu pre kazdy odtlacok, vynimka ulohy sa vypise ako riadok chyby.
+			 * \param files cesty k odtlackom
+			 * \param task uloha
+			 * \return pocty spracovanych a neuspesnych odtlackov
+			 */
+			static Counts forEachImage(const std::vector<std::string>& files, const ImageTask& task);
+			/**
+			 * \brief Spusti ulohu pre kazdu dvojicu odtlackov, vynimka ulohy sa vypise ako riadok chyby.
+			 * \param files cesty k odtlackom
+			 * \param task uloha
+			 * \return pocty spracovanych a neuspesnych dvojic
+			 */
+			static Counts forEachPair(const std::vector<std::string>& files, const PairTask& task);
+			/**
+			 * \brief Zmeria cas ulohy.
+			 * \param task uloha
+			 * \return cas v ms
+			 */
+			template <typename Task>
+			static double measure(Task&& task);
+			/**
+			 * \brief Spracuje dvojicu odtlackov a zmeria jej zarovnanie.
+			 * \param configuration parametre spracovania
+			 * \param processor ovladac spracovania odtlackov
+			 * \param aligner nastroj zarovnania
+			 * \param fingerprintPath cesta k odtlacku
+			 * \param otherPath cesta k zarovnavanemu odtlacku
+			 * \param time sem sa ulozi cas zarovnania v ms
+			 * \return zarovnanie (x, y, uhol)
+			 */
+			static cv::Vec3f align(const Configuration& configuration, const processing::FingerprintProcessor& processor,
+				const morphing::utils::FingerprintAligner& aligner, const std::string& fingerprintPath, const std::string& otherPath, double& time);
+			/**
+			 * \brief Zacne suhrn priecinka na standardnom chybovom vystupe, volajuci
+			 * doplni vlastne hodnoty a koniec riadku.
+			 * \param directory priecinok
+			 * \param counts pocty prvkov
+			 * \param unit nazov prvkov
+			 * \return standardny chybovy vystup
+			 */
+			static std::ostream& summary(const std::string& directory, const Counts& counts, const std::string& unit);
+			/**
+			 * \brief Nahradi oddelovace a konce riadkov v texte medzerou, aby text
+			 * nerozbil riadkovy format vystupu.
+			 * \param text text, napr. popis vynimky
+			 * \return upraveny text
+			 */
+			static std::string sanitize(const std::string& text);
+		};
+	}
+}
+
+
+template <typename Task>
+double cli::utils::Benchmark::measure(Task&& task)
+{
+	cv::TickMeter tm; tm.start();
+	task();
+	tm.stop();
+
+	return tm.getTimeMilli();
+}
@@ -0,0 +1,249 @@
+#include "Configuration.h"
+
+#include "../exceptions/InvalidArgument.h"
+
+#include <storage/Fingerprint.h>
+
+#include <sstream>
+
+using namespace cli::utils;
+
+processing::FingerprintProcessor Configuration::createFingerprintProcessor() const
+{
+	processing::utils::OrientationsEstimator orientations;
+	orientations
+		.setBlockSize(this->blockSize)
+		.useLowPassFilter()
+		.useIntegralImage(this->integralOrientations);
+
+	const auto frequencies = this->createFrequenciesEstimator();
+
+	const auto filter = this->createGaborFilter();
+
+	processing::utils::MinutiaeEstimator minutiaes;
+	minutiaes
+		.setBlockSize(this->blockSize);
+
+	const processing::utils::FakeMinutiaeDetector detector;
+
+	processing::FingerprintProcessor processor(orientations, frequencies, filter, minutiaes, detector);
+	processor.useFusedPreprocessing(this->fusedPreprocessing);
+
+	return processor;
+}
+
+processing::utils::GaborFilter Configuration::createGaborFilter() const
+{
+	processing::utils::GaborFilter filter;
+	filter
+		.setDeviation(this->deviation)
+		.setBank(this->bank)
+		.composite(this->gaborComposite)
+		.setCompositeWavelengths(this->gaborCompositeWavelengths)
+		.blendComposite(this->gaborBlend);
+
+	return filter;
+}
+
+processing::utils::FrequenciesEstimator Configuration::createFrequenciesEstimator() const
+{
+	processing::utils::FrequenciesEstimator frequencies;
+	frequencies
+		.setBlockSize(4)
+		.setWindowSize(this->windowSize)
+		.setOrientationBins(this->signatureBins)
+		.setMethod(this->spectralFrequencies
+			? processing::utils::FrequenciesEstimator::SPECTRUM
+			: processing::utils::FrequenciesEstimator::SIGNATURE)
+		.interpolate();
+
+	return frequencies;
+}
+
+morphing::utils::FingerprintAligner Configuration::createFingerprintAligner(processing::FingerprintProcessor& processor) const
+{
+	morphing::utils::FingerprintAligner aligner(processor);
+	aligner
+		.setTranslationStep(this->blockSize)
+		.setRotationStep(this->rotationStep)
+		.setTrashHold(this->trashHoldAligner)
+		.parallel(this->parallel)
+		.setCoarseScale(this->coarseScale)
+		.setCoarseCandidates(this->coarseCandidates)
+		.correlation(this->fft)
+		.setCorrelationPeaks(this->fftPeaks)
+		.bound(this->bound)
+		.setRotationCache(this->rotationCache);
+
+	return aligner;
+}
+
+morphing::utils::CutlineEstimator Configuration::createCutlineEstimator(processing::FingerprintProcessor& processor) const
+{
+	morphing::utils::CutlineEstimator cutline(processor);
+	cutline
+		.setRotationStep(static_cast<float>(CV_PI / this->lines))
+		.setMaxDistance(this->dmax)
+		.useAdaptiveMethod(this->adaptive)
+		.parallel(this->parallel);
+
+	if (this->dynamic)
+	{
+		cutline.useDynamicCutline(true);
+		cutline.setArea(this->area);
+	}
+
+	return cutline;
+}
+
+morphing::MorphingProcessor Configuration::createMorphingProcessor(processing::FingerprintProcessor& processor) const
+{
+	auto aligner = this->createFingerprintAligner(processor);
+	auto cutline = this->createCutlineEstimator(processor);
+
+	morphing::utils::TemplateGenerator generator;
+	generator
+		.setBorder(this->border);
+
+	morphing::MorphingProcessor morpher(processor, aligner, cutline, generator);
+	morpher.setTemplateBackground(this->background);
+
+	return morpher;
+}
+
+void Configuration::adapt(processing::storage::Fingerprint& fingerprint) const
+{
+	processing::FingerprintProcessor::adapt(fingerprint, this->blockSize, this->windowSize, this->trashHoldSegmentation);
+}
+
+void Configuration::prepare(const processing::FingerprintProcessor& processor, processing::storage::Fingerprint& fingerprint) const
+{
+	this->adapt(fingerprint);
+
+	processor.preprocess(fingerprint);
+	processor.estimateFrequencies(fingerprint);
+	processor.applyRegionMask(fingerprint);
+}
+
+Configuration Configuration::parse(const std::vector<std::string>& args, std::vector<std::string>& positional)
+{
+	Configuration configuration;
+
+	for (auto arg = args.begin(); arg != args.end(); ++arg)
+	{
+		if (arg->rfind("--", 0) != 0)
+		{
+			positional.emplace_back(*arg);
+			continue;
+		}
+
+		if (*arg == "--dynamic") { configuration.dynamic = true; continue; }
+		if (*arg == "--adaptive") { configuration.adaptive = true; continue; }
+		if (*arg == "--parallel") { configuration.parallel = true; continue; }
+		if (*arg == "--fft") { configuration.fft = true; continue; }
+		if (*arg == "--no-bound") { configuration.bound = false; continue; }
+		if (*arg == "--templates") { configuration.templates = true; continue; }
+		if (*arg == "--spectral-frequencies") { configuration.spectralFrequencies = true; continue; }
+		if (*arg == "--integral-orientations") { configuration.integralOrientations = true; continue; }
+		if (*arg == "--fused-preprocess") { configuration.fusedPreprocessing = true; continue; }
+		if (*arg == "--gabor-bank") { configuration.gaborBank = true; continue; }
+		if (*arg == "--gabor-composite") { configuration.gaborComposite = true; continue; }
+		if (*arg == "--gabor-blend") { configuration.gaborBlend = true; continue; }
+
+		const auto name = *arg;
+		if (++arg == args.end())
+		{
+			throw exception::InvalidArgument(name);
+		}
+
+		std::stringstream value(*arg);
+		if (name == "--block-size") value >> configuration.blockSize;
+		else if (name == "--window-size") value >> configuration.windowSize;
+		else if (name == "--segmentation") value >> configuration.trashHoldSegmentation;
+		else if (name == "--xsig-bins") value >> configuration.signatureBins;
+		else if (name == "--deviation") value >> configuration.deviation;
+		else if (name == "--alignment") value >> configuration.trashHoldAligner;
+		else if (name == "--rotation-step") value >> configuration.rotationStep;
+		else if (name == "--lines") value >> configuration.lines;
+		else if (name == "--dmax") value >> configuration.dmax;
+		else if (name == "--area") value >> configuration.area;
+		else if (name == "--border") value >> configuration.border;
+		else if (name == "--background") value >> configuration.background;
+		else if (name == "--workers") value >> configuration.workers;
+		else if (name == "--coarse-scale") value >> configuration.coarseScale;
+		else if (name == "--coarse-top") value >> configuration.coarseCandidates;
+		else if (name == "--fft-peaks") value >> configuration.fftPeaks;
+		else if (name == "--rotation-cache") value >> configuration.rotationCacheSize;
+		else if (name == "--buffer-pool") value >> configuration.bufferPoolSize;
+		else if (name == "--gabor-angles") value >> configuration.gaborOrientations;
+		else if (name == "--gabor-periods") value >> configuration.gaborWavelengths;
+		else if (name == "--gabor-top") value >> configuration.gaborCompositeWavelengths;
+		else if (name == "--mode") value >> configuration.benchmarkMode;
+		else throw exception::InvalidArgument(name);
+
+		if (value.fail() || !value.eof())
+		{
+			throw exception::InvalidArgument(name + " " + *arg);
+		}
+	}
+
+	if (configuration.bufferPoolSize > 0)
+	{
+		configuration.bufferPool = std::make_shared<processing::utils::BufferPool>(
+			static_cast<std::size_t>(configuration.bufferPoolSize) * 1024 * 1024);
+	}
+
+	if (configuration.rotationCacheSize > 0)
+	{
+		configuration.rotationCache = std::make_shared<morphing::utils::RotationCache>(
+			static_cast<std::size_t>(configuration.rotationCacheSize) * 1024 * 1024);
+	}
+
+	if (configuration.gaborBank || configuration.gaborComposite)
+	{
+		configuration.bank = std::make_shared<processing::utils::GaborBank>(
+			configuration.gaborOrientations, configuration.gaborWavelengths);
+	}
+
+	return configuration;
+}
+
+std::string Configuration::usage()
+{
+	return
+		"options:\n"
+		"  --block-size <int>      block size (12)\n"
+		"  --window-size <int>     frequency window size (30)\n"
+		"  --segmentation <float>  segmentation threshold (0.003)\n"
+		"  --xsig-bins <int>       x-signature orientation bins, 0 samples exactly (0)\n"
+		"  --spectral-frequencies  estimate ridge frequencies from window spectra\n"
+		"  --deviation <int>       gabor deviation (4)\n"
+		"  --alignment <float>     minimal common area of aligned fingerprints (0.7)\n"
+		"  --rotation-step <int>   alignment rotation step in degrees (9)\n"
+		"  --lines <int>           number of cutline rotations (60)\n"
+		"  --dmax <int>            maximal minutiae distance from cutline (30)\n"
+		"  --area <int>            dynamic cutline search area (64)\n"
+		"  --border <int>          blurred border width (16)\n"
+		"  --background <int>      template background color (255)\n"
+		"  --dynamic               use dynamic cutline\n"
+		"  --adaptive              use adaptive cutline scoring\n"
+		"  --parallel              search alignment and cutline candidates in parallel\n"
+		"  --coarse-scale <int>    coarse-to-fine alignment step multiplier, 1 disables (1)\n"
+		"  --coarse-top <int>      coarse alignments refined at full resolution (3)\n"
+		"  --fft                   search alignment translations by FFT cross-correlation\n"
+		"  --fft-peaks <int>       correlation peaks rescored directly per rotation (4)\n"
+		"  --no-bound              disable upper bound pruning of alignment translations\n"
+		"  --rotation-cache <int>  rotated orientation cache budget in MB, 0 disables (64)\n"
+		"  --buffer-pool <int>     size classed matrix buffer pool budget in MB, 0 disables (0)\n"
+		"  --integral-orientations estimate block orientations from integral images\n"
+		"  --fused-preprocess      normalize and compute gradients in one banded pass\n"
+		"  --gabor-bank            filter with a bank of quantized gabor kernels\n"
+		"  --gabor-composite       compose gabor output from whole image kernel responses\n"
+		"  --gabor-angles <int>    gabor bank orientations (32)\n"
+		"  --gabor-periods <int>   gabor bank ridge wavelengths (16)\n"
+		"  --gabor-top <int>       composite wavelengths filtered per orientation (2)\n"
+		"  --gabor-blend           blend the two composite responses around each pixel wavelength\n"
+		"  --templates             batch: write minutiae templates (morph always writes one)\n"
+		"  --workers <int>         batch worker threads (number of cores)\n"
+		"  --mode <name>           bench-align: compare coarse, fft or bound against plain search\n";
+}
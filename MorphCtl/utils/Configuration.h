@@ -0,0 +1,294 @@
+#pragma once
+
+#include <FingerprintProcessor.h>
+#include <MorphingProcessor.h>
+#include <utils/BufferPool.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace processing
+{
+	namespace storage
+	{
+		class Fingerprint;
+	}
+}
+
+namespace cli
+{
+	namespace utils
+	{
+		/**
+		 * \brief Parametre spracovania a morfovania odtlackov nastavitelne
+		 * z prikazoveho riadku. Predvolene hodnoty zodpovedaju nastaveniu
+		 * testovacich behov v DemoApp.
+		 */
+		class Configuration
+		{
+		private:
+			// members
+			/**
+			 * \brief Velkost bloku odtlacku.
+			 */
+			int blockSize = 12;
+			/**
+			 * \brief Velkost okna pri odhade frekvencii.
+			 */
+			int windowSize = 30;
+			/**
+			 * \brief Prah segmentacie odtlacku.
+			 */
+			float trashHoldSegmentation = 0.003f;
+			/**
+			 * \brief Pocet kvantovanych orientacii tabuliek x-signatury, 0 vzorkuje presne.
+			 */
+			int signatureBins = 0;
+			/**
+			 * \brief Indikator odhadu frekvencii zo spektra okien.
+			 */
+			bool spectralFrequencies = false;
+			/**
+			 * \brief Odchylka Gaborovho filtra.
+			 */
+			int deviation = 4;
+			/**
+			 * \brief Indikator odhadu orientacii z integralnych obrazov.
+			 */
+			bool integralOrientations = false;
+			/**
+			 * \brief Indikator spojeneho predspracovania odtlackov.
+			 */
+			bool fusedPreprocessing = false;
+			/**
+			 * \brief Minimalna spolocna plocha zarovnanych odtlackov.
+			 */
+			float trashHoldAligner = 0.7f;
+			/**
+			 * \brief Krok rotacie pri zarovnavani v stupnoch.
+			 */
+			int rotationStep = 9;
+			/**
+			 * \brief Pocet skumanych natoceni reznej linie.
+			 */
+			int lines = 60;
+			/**
+			 * \brief Maximalna vzdialenost markantov od reznej linie.
+			 */
+			int dmax = 30;
+			/**
+			 * \brief Velkost oblasti hladania dynamickej reznej linie.
+			 */
+			int area = 64;
+			/**
+			 * \brief Sirka rozmazaneho okraju morfovaneho odtlacku.
+			 */
+			int border = 16;
+			/**
+			 * \brief Farba pozadia morfovaneho odtlacku.
+			 */
+			int background = 255;
+			/**
+			 * \brief Indikator pouzitia dynamickej reznej linie.
+			 */
+			bool dynamic = false;
+			/**
+			 * \brief Indikator pouzitia adaptivnej metody ohodnotenia linie.
+			 */
+			bool adaptive = false;
+			/**
+			 * \brief Indikator paralelneho prehladavania pri zarovnavani a odhade reznej linie.
+			 */
+			bool parallel = false;
+			/**
+			 * \brief Nasobok krokov hrubeho prehladavania pri zarovnavani, 1 vypina
+			 * hierarchicke prehladavanie.
+			 */
+			int coarseScale = 1;
+			/**
+			 * \brief Pocet zjemnovanych zarovnani hrubeho prehladavania.
+			 */
+			int coarseCandidates = 3;
+			/**
+			 * \brief Indikator prehladavania posunuti korelaciou pomocou FFT pri zarovnavani.
+			 */
+			bool fft = false;
+			/**
+			 * \brief Pocet posunuti korelacie kazdeho otocenia ohodnotenych priamo.
+			 */
+			int fftPeaks = 4;
+			/**
+			 * \brief Indikator orezavania prehladavania posunuti hornym odhadom podobnosti.
+			 */
+			bool bound = true;
+			/**
+			 * \brief Pamatovy rozpocet poolu bufferov matic v MB, 0 ho vypina.
+			 */
+			int bufferPoolSize = 0;
+			/**
+			 * \brief Pool bufferov matic. Je deklarovany pred zdielanymi nastrojmi,
+			 * aby ich matice uvolnene pri zaniku konfiguracie este nasli svoj alokator.
+			 */
+			std::shared_ptr<processing::utils::BufferPool> bufferPool;
+			/**
+			 * \brief Pamatovy rozpocet vyrovnavacej pamate otoceni v MB, 0 ju vypina.
+			 */
+			int rotationCacheSize = 64;
+			/**
+			 * \brief Vyrovnavacia pamat otoceni zdielana vsetkymi nastrojmi zarovnania
+			 * vytvorenymi z tejto konfiguracie.
+			 */
+			std::shared_ptr<morphing::utils::RotationCache> rotationCache;
+			/**
+			 * \brief Indikator filtrovania kvantovanymi Gaborovymi jadrami.
+			 */
+			bool gaborBank = false;
+			/**
+			 * \brief Pocet kvantovanych orientacii Gaborovych jadier.
+			 */
+			int gaborOrientations = 32;
+			/**
+			 * \brief Pocet kvantovanych vlnovych dlzok Gaborovych jadier.
+			 */
+			int gaborWavelengths = 16;
+			/**
+			 * \brief Indikator skladania vylepseneho odtlacku z odoziev celeho obrazku
+			 * na jadra banky.
+			 */
+			bool gaborComposite = false;
+			/**
+			 * \brief Najvacsi pocet vlnovych dlzok filtrovanych pre jednu orientaciu pri skladani odoziev.
+			 */
+			int gaborCompositeWavelengths = 2;
+			/**
+			 * \brief Indikator prelinania odoziev dvoch ohranicujucich vlnovych dlzok pri skladani odoziev.
+			 */
+			bool gaborBlend = false;
+			/**
+			 * \brief Banka Gaborovych jadier zdielana vsetkymi filtrami vytvorenymi
+			 * z tejto konfiguracie.
+			 */
+			std::shared_ptr<processing::utils::GaborBank> bank;
+			/**
+			 * \brief Pocet pracovnych vlakien davkoveho spracovania, 0 znamena
+			 * pocet dostupnych jadier.
+			 */
+			unsigned int workers = 0;
+			/**
+			 * \brief Indikator zapisu sablon markantov v davke, prikaz morph ju zapisuje vzdy.
+			 */
+			bool templates = false;
+			/**
+			 * \brief Porovnavany sposob zarovnania prikazu bench-align, prazdny meria paralelne zarovnanie.
+			 */
+			std::string benchmarkMode;
+
+		public:
+			// constructors
+			Configuration() = default;
+
+			// methods
+			/**
+			 * \brief Vytvori ovladac spracovania odtlackov podla konfiguracie.
+			 * \return ovladac spracovania odtlackov
+			 */
+			processing::FingerprintProcessor createFingerprintProcessor() const;
+			/**
+			 * \brief Vytvori Gaborov filter podla konfiguracie.
+			 * \return Gaborov filter
+			 */
+			processing::utils::GaborFilter createGaborFilter() const;
+			/**
+			 * \brief Vytvori odhad frekvencii podla konfiguracie.
+			 * \return odhad frekvencii
+			 */
+			processing::utils::FrequenciesEstimator createFrequenciesEstimator() const;
+			/**
+			 * \brief Vytvori nastroj zarovnania odtlackov podla konfiguracie.
+			 * \param processor ovladac spracovania odtlackov
+			 * \return nastroj zarovnania odtlackov
+			 */
+			morphing::utils::FingerprintAligner createFingerprintAligner(processing::FingerprintProcessor& processor) const;
+			/**
+			 * \brief Vytvori nastroj odhadu reznej linie podla konfiguracie.
+			 * \param processor ovladac spracovania odtlackov
+			 * \return nastroj odhadu reznej linie
+			 */
+			morphing::utils::CutlineEstimator createCutlineEstimator(processing::FingerprintProcessor& processor) const;
+			/**
+			 * \brief Vytvori ovladac morfovania odtlackov podla konfiguracie.
+			 * \param processor ovladac spracovania odtlackov
+			 * \return ovladac morfovania odtlackov
+			 */
+			morphing::MorphingProcessor createMorphingProcessor(processing::FingerprintProcessor& processor) const;
+			/**
+			 * \brief Nastavi odtlacku parametre spracovania.
+			 * \param fingerprint odtlacok
+			 */
+			void adapt(processing::storage::Fingerprint& fingerprint) const;
+			/**
+			 * \brief Pripravi odtlacok na zarovnanie, tzn. vykona vsetky kroky
+			 * spracovania, ktore zarovnaniu predchadzaju pri morfovani.
+			 * \param processor ovladac spracovania odtlackov
+			 * \param fingerprint odtlacok
+			 */
+			void prepare(const processing::FingerprintProcessor& processor, processing::storage::Fingerprint& fingerprint) const;
+
+			// static methods
+			/**
+			 * \brief Spracuje volby prikazoveho riadku v tvare --nazov hodnota.
+			 * Argumenty, ktore nie su volbami, su vratene v poradi v akom boli zadane.
+			 * \param args argumenty prikazoveho riadku
+			 * \param positional pozicne argumenty
+			 * \return konfiguracia
+			 */
+			static Configuration parse(const std::vector<std::string>& args, std::vector<std::string>& positional);
+			/**
+			 * \brief Popis volieb konfiguracie pre vypis pouzitia.
+			 * \return popis volieb
+			 */
+			static std::string usage();
+
+			// getters
+			int getBlockSize() const { return this->blockSize; }
+			int getWindowSize() const { return this->windowSize; }
+			bool isDynamic() const { return this->dynamic; }
+			bool isAdaptive() const { return this->adaptive; }
+			bool isParallel() const { return this->parallel; }
+			int getCoarseScale() const { return this->coarseScale; }
+			bool isFft() const { return this->fft; }
+			bool isBound() const { return this->bound; }
+			std::shared_ptr<morphing::utils::RotationCache> getRotationCache() const { return this->rotationCache; }
+			std::shared_ptr<processing::utils::BufferPool> getBufferPool() const { return this->bufferPool; }
+			int getDeviation() const { return this->deviation; }
+			bool usesIntegralOrientations() const { return this->integralOrientations; }
+			bool usesFusedPreprocessing() const { return this->fusedPreprocessing; }
+			bool usesSpectralFrequencies() const { return this->spectralFrequencies; }
+			std::shared_ptr<processing::utils::GaborBank> getGaborBank() const { return this->bank; }
+			bool isGaborComposite() const { return this->gaborComposite; }
+			bool isGaborBlend() const { return this->gaborBlend; }
+			unsigned int getWorkers() const { return this->workers; }
+			bool writesTemplates() const { return this->templates; }
+			const std::string& getBenchmarkMode() const { return this->benchmarkMode; }
+
+			// setters
+			Configuration& setBlockSize(const int blockSize) { this->blockSize = blockSize; return *this; }
+			Configuration& setWindowSize(const int windowSize) { this->windowSize = windowSize; return *this; }
+			Configuration& useDynamicCutline(const bool dynamic = true) { this->dynamic = dynamic; return *this; }
+			Configuration& useAdaptiveMethod(const bool adaptive = true) { this->adaptive = adaptive; return *this; }
+			Configuration& useParallelAlignment(const bool parallel = true) { this->parallel = parallel; return *this; }
+			Configuration& setCoarseScale(const int coarseScale) { this->coarseScale = coarseScale; return *this; }
+			Configuration& useFftAlignment(const bool fft = true) { this->fft = fft; return *this; }
+			Configuration& useSpectralFrequencies(const bool spectralFrequencies = true) { this->spectralFrequencies = spectralFrequencies; return *this; }
+			Configuration& useIntegralOrientations(const bool integralOrientations = true) { this->integralOrientations = integralOrientations; return *this; }
+			Configuration& useFusedPreprocessing(const bool fusedPreprocessing = true) { this->fusedPreprocessing = fusedPreprocessing; return *this; }
+			Configuration& setGaborBank(const std::shared_ptr<processing::utils::GaborBank>& bank) { this->bank = bank; return *this; }
+			Configuration& useGaborComposite(const bool gaborComposite = true) { this->gaborComposite = gaborComposite; return *this; }
+			Configuration& useGaborBlend(const bool gaborBlend = true) { this->gaborBlend = gaborBlend; return *this; }
+			Configuration& setWorkers(const unsigned int workers) { this->workers = workers; return *this; }
+			Configuration& writeTemplates(const bool templates) { this->templates = templates; return *this; }
+			Configuration& setBenchmarkMode(const std::string& benchmarkMode) { this->benchmarkMode = benchmarkMode; return *this; }
+		};
+	}
+}
@@ -0,0 +1,65 @@
+#include "Manifest.h"
+
+#include "../exceptions/InvalidArgument.h"
+#include "../exceptions/ManifestNotFound.h"
+
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+using namespace cli::utils;
+
+Manifest Manifest::read(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		throw exception::ManifestNotFound(path);
+	}
+
+	Manifest manifest;
+	std::set<std::string> names;
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (!line.empty() && line.back() == '\r')
+		{
+			line.pop_back();
+		}
+		
+		if (line.empty() || line[0] == '#')
+		{
+			continue;
+		}
+
+		std::stringstream ss(line);
+		Entry entry;
+		std::getline(ss, entry.fingerprint, ';');
+		std::getline(ss, entry.other, ';');
+		std::getline(ss, entry.name, ';');
+
+		if (entry.fingerprint.empty() || entry.other.empty())
+		{
+			throw exception::InvalidArgument(line);
+		}
+
+		if (entry.name.empty())
+		{
+			entry.name = fs::path(entry.fingerprint).stem().string() + "_" + fs::path(entry.other).stem().string();
+		}
+
+		// dve dvojice s rovnakym nazvom by paralelne zapisovali ten isty vysledok
+		if (!names.insert(entry.name).second)
+		{
+			throw exception::InvalidArgument(line);
+		}
+
+		manifest.entries.emplace_back(entry);
+	}
+
+	return manifest;
+}
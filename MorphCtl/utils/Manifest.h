@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace cli
+{
+	namespace utils
+	{
+		/**
+		 * \brief Zoznam dvojic odtlackov urcenych na morfovanie. Kazdy riadok
+		 * manifestu obsahuje cesty k dvom odtlackom a volitelne nazov vysledku,
+		 * oddelene bodkociarkou. Predvoleny nazov je nazov_nazov odtlackov, nazvy
+		 * musia byt jedinecne. Prazdne riadky a riadky zacinajuce znakom #
+		 * su ignorovane.
+		 */
+		class Manifest
+		{
+		public:
+			/**
+			 * \brief Jedna dvojica odtlackov manifestu.
+			 */
+			struct Entry
+			{
+				std::string fingerprint;
+				std::string other;
+				std::string name;
+			};
+
+		private:
+			// members
+			/**
+			 * \brief Dvojice odtlackov v poradi manifestu.
+			 */
+			std::vector<Entry> entries;
+
+		public:
+			// constructors
+			Manifest() = default;
+
+			// static methods
+			/**
+			 * \brief Nacita manifest zo suboru. Riadok s opakovanym nazvom vysledku
+			 * je neplatny argument.
+			 * \param path cesta k manifestu
+			 * \return manifest
+			 */
+			static Manifest read(const std::string& path);
+
+			// getters
+			const std::vector<Entry>& getEntries() const { return this->entries; }
+			std::size_t size() const { return this->entries.size(); }
+		};
+	}
+}
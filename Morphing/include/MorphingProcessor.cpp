@@ -11,18 +11,15 @@ using namespace morphing::utils;
 using namespace morphing;
 using namespace cv;
 
-std::string MorphingProcessor::path = "C:\\Users\\Denis\\Desktop\\Results\\morphing\\synthetic\\";
+std::string MorphingProcessor::path = "Results/morphing/";
 
 MorphingProcessor::MorphingProcessor(FingerprintProcessor& processor, FingerprintAligner& aligner, CutlineEstimator& cutline, TemplateGenerator& generator)
 	: processor(processor), aligner(aligner), cutline(cutline), generator(generator) {}
 
 Fingerprint MorphingProcessor::morph(AlignedFingerprint& af, Fingerprint& f)
 {
-	this->processor.normalize(f);
-	this->processor.normalize(af);
-	
-	this->processor.estimateOrientations(f);
-	this->processor.estimateOrientations(af);
+	this->processor.preprocess(f);
+	this->processor.preprocess(af);
 
 	this->processor.estimateFrequencies(f);
 	this->processor.estimateFrequencies(af);
@@ -45,19 +42,19 @@ Fingerprint MorphingProcessor::morph(AlignedFingerprint& af, Fingerprint& f)
 
 void MorphingProcessor::writeAligned(const AlignedFingerprint& af, const Fingerprint& f, const std::string& filename) const
 {
-	std::stringstream ss; ss.str(""); ss << path << "1_aligned\\" << filename;
+	std::stringstream ss; ss.str(""); ss << path << "1_aligned/" << filename;
 	this->aligner.write(af, f, ss.str());
 }
 
 void MorphingProcessor::writeCutline(const AlignedFingerprint& af, const Fingerprint& f, const std::string& filename)
 {
-	std::stringstream ss; ss.str(""); ss << path << "2_cutline\\" << filename;
+	std::stringstream ss; ss.str(""); ss << path << "2_cutline/" << filename;
 	this->cutline.write(af, f, ss.str());
 }
 
 void MorphingProcessor::writeMorphed(const Fingerprint& f, const std::string& filename) const
 {
-	std::stringstream ss; ss.str(""); ss << path << "3_morphed\\" << filename;
+	std::stringstream ss; ss.str(""); ss << path << "3_morphed/" << filename;
 	this->generator.write(f, ss.str());
 }
 
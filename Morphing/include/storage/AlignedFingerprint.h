@@ -69,7 +69,7 @@ inline morphing::storage::AlignedFingerprint::AlignedFingerprint(const AlignedFi
 
 inline void morphing::storage::AlignedFingerprint::clear()
 {
-	this->aligned = Mat(10, 10, CV_32F);
+	this->aligned.release();
 	this->alignment = cv::Vec3f();
 	this->cutline = utils::storage::Cutline();
 
@@ -79,14 +79,16 @@ inline void morphing::storage::AlignedFingerprint::clear()
 
 	this->enhanced = false;
 
-	this->normalized = Mat(10, 10, CV_32F);
-	this->segmentation = Mat(10, 10, CV_32F);
-	this->orientations = Mat(10, 10, CV_32F);
-	this->frequencies = Mat(10, 10, CV_32F);
-	this->thinned = Mat(10, 10, CV_32F);
-	this->filtered = Mat(10, 10, CV_32F);
-	this->binarized = Mat(10, 10, CV_32F);
+	// uvolnenie bez zastupnych matic, buffre sa mozu vratit do alokatora
+	this->normalized.release();
+	this->segmentation.release();
+	this->orientations.release();
+	this->frequencies.release();
+	this->thinned.release();
+	this->filtered.release();
+	this->binarized.release();
+	this->minutiaeTracing.release();
 	this->minutiaes = std::vector<processing::utils::storage::Minutiae>();
 
-	this->regionMask = processing::utils::RegionMask(Mat(10, 10, CV_32F));
+	this->regionMask = processing::utils::RegionMask();
 }
@@ -3,6 +3,7 @@
 #include <storage/Minutiae.h>
 
 #include <opencv2/core/matx.hpp>
+#include <array>
 #include <vector>
 
 namespace morphing
@@ -34,6 +35,12 @@ namespace morphing
 				 * \brief Markanty negativnej strany zarovnaneho odtlacku.
 				 */
 				std::vector<processing::utils::storage::Minutiae> negAfMin;
+				/**
+				 * \brief Kardinality markantov na stranach odtlacku a zarovnaneho odtlacku
+				 * v poradi pozitivna a negativna strana odtlacku, pozitivna a negativna strana
+				 * zarovnaneho odtlacku. Pri prehladavani linii sa markanty nekopiruju.
+				 */
+				std::array<int, 4> cardinality = { 0, 0, 0, 0 };
 
 				float sO;
 				float sV;
@@ -68,10 +75,10 @@ namespace morphing
 				 * Metody urcene pre ziskanie kardinality marknatov na jednotlivych
 				 * stranach odtlackov
 				 */
-				int getPosFCardinality() const { return this->posFMin.size(); }
-				int getNegFCardinality() const { return this->negFMin.size(); }
-				int getPosAfCardinality() const { return this->posAfMin.size(); }
-				int getNegAfCardinality() const { return this->negAfMin.size(); }
+				int getPosFCardinality() const { return this->cardinality[0]; }
+				int getNegFCardinality() const { return this->cardinality[1]; }
+				int getPosAfCardinality() const { return this->cardinality[2]; }
+				int getNegAfCardinality() const { return this->cardinality[3]; }
 				float getSO() const { return this->sO; }
 				float getSV() const { return this->sV; }
 				float getSM() const { return this->sM; }
@@ -79,10 +86,11 @@ namespace morphing
 				
 				//setters
 				Cutline& setDMax(const int dmax) { this->dmax = dmax; return *this; }
-				Cutline& setPosFMin(const std::vector<processing::utils::storage::Minutiae>& mins) { this->posFMin = mins; return *this; }
-				Cutline& setNegFMin(const std::vector<processing::utils::storage::Minutiae>& mins) { this->negFMin = mins; return *this; }
-				Cutline& setPosAfMin(const std::vector<processing::utils::storage::Minutiae>& mins) { this->posAfMin = mins; return *this; }
-				Cutline& setNegAfMin(const std::vector<processing::utils::storage::Minutiae>& mins) { this->negAfMin = mins; return *this; }
+				Cutline& setPosFMin(const std::vector<processing::utils::storage::Minutiae>& mins) { this->posFMin = mins; this->cardinality[0] = mins.size(); return *this; }
+				Cutline& setNegFMin(const std::vector<processing::utils::storage::Minutiae>& mins) { this->negFMin = mins; this->cardinality[1] = mins.size(); return *this; }
+				Cutline& setPosAfMin(const std::vector<processing::utils::storage::Minutiae>& mins) { this->posAfMin = mins; this->cardinality[2] = mins.size(); return *this; }
+				Cutline& setNegAfMin(const std::vector<processing::utils::storage::Minutiae>& mins) { this->negAfMin = mins; this->cardinality[3] = mins.size(); return *this; }
+				Cutline& setCardinality(const int posF, const int negF, const int posAf, const int negAf) { this->cardinality = { posF, negF, posAf, negAf }; return *this; }
 				Cutline& setSO(const float sO) { this->sO = sO; return *this; }
 				Cutline& setSV(const float sV) { this->sV = sV; return *this; }
 				Cutline& setSM(const float sM) { this->sM = sM; return *this; }
@@ -93,10 +101,10 @@ namespace morphing
 				 * Metody urcene k navyseniu kardinality markantov na jednotlivych
 				 * stranach odtlackov.
 				 */
-				Cutline& addPosFMin(const processing::utils::storage::Minutiae& min) { this->posFMin.push_back(min); return *this; }
-				Cutline& addNegFMin(const processing::utils::storage::Minutiae& min) { this->negFMin.push_back(min); return *this; }
-				Cutline& addPosAfMin(const processing::utils::storage::Minutiae& min) { this->posAfMin.push_back(min); return *this; }
-				Cutline& addNegAfMin(const processing::utils::storage::Minutiae& min) { this->negAfMin.push_back(min); return *this; }
+				Cutline& addPosFMin(const processing::utils::storage::Minutiae& min) { this->posFMin.push_back(min); this->cardinality[0]++; return *this; }
+				Cutline& addNegFMin(const processing::utils::storage::Minutiae& min) { this->negFMin.push_back(min); this->cardinality[1]++; return *this; }
+				Cutline& addPosAfMin(const processing::utils::storage::Minutiae& min) { this->posAfMin.push_back(min); this->cardinality[2]++; return *this; }
+				Cutline& addNegAfMin(const processing::utils::storage::Minutiae& min) { this->negAfMin.push_back(min); this->cardinality[3]++; return *this; }
 				
 			};
 		}
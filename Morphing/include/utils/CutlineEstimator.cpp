@@ -1,11 +1,16 @@
 #include "CutlineEstimator.h"
 #include "storage/AlignedFingerprint.h"
 #include "FingerprintAligner.h"
+#include "SimilarityKernel.h"
 #include "MorphingProcessor.h"
 
 #include <utils/ImageProcessor.h>
 #include <storage/Fingerprint.h>
 
+#include <algorithm>
+#include <map>
+#include <numeric>
+
 using namespace processing::storage;
 using namespace processing::utils::storage;
 using namespace processing::utils;
@@ -15,7 +20,7 @@ using namespace morphing::storage;
 using namespace morphing::utils;
 using namespace cv;
 
-int CutlineEstimator::displayed = 0;
+std::atomic<int> CutlineEstimator::displayed(0);
 const std::string CutlineEstimator::class_name = "CutlineEstimator::";
 
 CutlineEstimator::CutlineEstimator(FingerprintProcessor& processor) { }
@@ -55,23 +60,16 @@ void CutlineEstimator::compute(AlignedFingerprint& af, Fingerprint& f)
 	const auto mins = filtered[0];
 	const auto aMins = filtered[1];
 
-	auto maxCutlineScore = .0;
+	const auto overlap = this->overlap(af, f, afPos, fPos, bb);
+
+	std::vector<Vec3f> lines;
 	for (auto rotation = .0f; rotation < CV_PI; rotation += this->rotStep)
 	{
 		// toto je spravne
-		const auto line = this->estimateCutline(rotation, bb[0].x + (bb[1].x - bb[0].x) / 2, bb[0].y + (bb[1].y - bb[0].y) / 2);
-
-		Cutline cLine(line);
-
-		const auto s = this->score(af, f, afPos, fPos, cLine, bb, mins, aMins);
-
-		if (s > maxCutlineScore)
-		{
-			maxCutlineScore = s;
-			this->cutline = cLine;
-			this->cutline.setDMax(this->dmax);
-		}
+		lines.push_back(this->estimateCutline(rotation, bb[0].x + (bb[1].x - bb[0].x) / 2, bb[0].y + (bb[1].y - bb[0].y) / 2));
 	}
+
+	this->search(lines, overlap, mins, aMins);
 }
 
 void CutlineEstimator::computeDynamic(AlignedFingerprint& af, Fingerprint& f)
@@ -87,13 +85,15 @@ void CutlineEstimator::computeDynamic(AlignedFingerprint& af, Fingerprint& f)
 	const auto mins = filtered[0];
 	const auto aMins = filtered[1];
 
+	const auto overlap = this->overlap(af, f, afPos, fPos, bb);
+
 	const std::array<std::array<int, 2>, 9> shifts = { {
 		{0, 1}, {-1, 1}, {-1, 0},
 		{-1, -1}, {0, -1}, {0, 0},
 		{1, -1}, {1, 0}, {1, 1},
 	} };
 
-	auto maxCutlineScore = .0;
+	std::vector<Vec3f> lines;
 	auto centroid = Vec2b(bb[0].x + (bb[1].x - bb[0].x) / 2, bb[0].y + (bb[1].y - bb[0].y) / 2);
 	for (const auto& shift: shifts)
 	{
@@ -108,20 +108,106 @@ void CutlineEstimator::computeDynamic(AlignedFingerprint& af, Fingerprint& f)
 
 		for (auto rotation = .0f; rotation < CV_PI; rotation += this->rotStep)
 		{
-			const auto line = this->estimateCutline(rotation, region[0], region[1]);
+			lines.push_back(this->estimateCutline(rotation, region[0], region[1]));
+		}
+	}
+
+	this->search(lines, overlap, mins, aMins);
+}
+
+void CutlineEstimator::search(const std::vector<Vec3f>& lines, const Overlap& overlap, const std::vector<Minutiae>& minutiae,
+	const std::vector<Minutiae>& aMinutiae)
+{
+	// linie s rovnakym otocenim maju rovnaku normalu a lisia sa len posunutim
+	std::vector<std::vector<int>> groups;
+	std::map<std::pair<float, float>, int> normals;
+	for (auto l = 0u; l < lines.size(); l++)
+	{
+		const auto normal = normals.emplace(std::make_pair(lines[l][0], lines[l][1]), static_cast<int>(groups.size()));
+		if (normal.second)
+		{
+			groups.emplace_back();
+		}
+		groups[normal.first->second].push_back(l);
+	}
+
+	// kazda linia sa ohodnoti do vlastneho miesta, vlakna tak nic nezdielaju
+	std::vector<Cutline> cutlines(lines.begin(), lines.end());
+	std::vector<float> scores(lines.size());
+
+	const auto scoreGroups = [&](const Range& range)
+	{
+		for (auto g = range.start; g < range.end; g++)
+		{
+			const auto& group = groups[g];
 
-			Cutline cLine(line);
+			// zoradenie blokov sa oplati, len ak ho vyuzije viac linii
+			Projection projection;
+			if (group.size() > 1)
+			{
+				projection = this->project(overlap, lines[group.front()]);
+			}
 
-			const auto s = this->score(af, f, afPos, fPos, cLine, bb, mins, aMins);
+			const auto positions = this->project(minutiae, lines[group.front()]);
+			const auto aPositions = this->project(aMinutiae, lines[group.front()]);
 
-			if (s > maxCutlineScore)
+			for (const auto l : group)
 			{
-				maxCutlineScore = s;
-				this->cutline = cLine;
-				this->cutline.setDMax(this->dmax);
+				SimilarityKernel::Band band;
+				if (group.size() > 1)
+				{
+					band = this->band(projection, lines[l]);
+				}
+				else
+				{
+					SimilarityKernel::band(lines[l], static_cast<float>(this->dmax), overlap.x.data(), overlap.y.data(), overlap.validity.data(),
+						overlap.orientationSimilarity.data(), overlap.frequencySimilarity.data(), static_cast<int>(overlap.x.size()), band);
+				}
+
+				const auto card = this->minutiaeCardinality(positions, lines[l]);
+				const auto aCard = this->minutiaeCardinality(aPositions, lines[l]);
+				cutlines[l].setCardinality(card[0], card[1], aCard[0], aCard[1]);
+
+				scores[l] = this->score(band, cutlines[l]);
 			}
 		}
+	};
+
+	if (this->isParallel())
+	{
+		parallel_for_(Range(0, static_cast<int>(groups.size())), scoreGroups);
+	}
+	else
+	{
+		scoreGroups(Range(0, static_cast<int>(groups.size())));
+	}
+
+	// prva najlepsia linia v poradi prehladavania, rovnako ako pri seriovom prehladavani
+	auto maxCutlineScore = .0;
+	auto best = -1;
+	for (auto l = 0u; l < lines.size(); l++)
+	{
+		if (scores[l] > maxCutlineScore)
+		{
+			maxCutlineScore = scores[l];
+			best = l;
+		}
 	}
+
+	if (best < 0)
+	{
+		return;
+	}
+
+	// markanty vybranej linie su potrebne pri generovani sablony
+	this->cutline = cutlines[best];
+	this->cutline.setDMax(this->dmax);
+
+	const auto minutiaesCard = this->minutiaeCardinality(this->cutline, minutiae);
+	const auto aMinutiaesCard = this->minutiaeCardinality(this->cutline, aMinutiae);
+	this->cutline
+		.setPosFMin(minutiaesCard[0]).setNegFMin(minutiaesCard[1])
+		.setPosAfMin(aMinutiaesCard[0]).setNegAfMin(aMinutiaesCard[1]);
 }
 
 Vec3f CutlineEstimator::estimateCutline(const float rotation, const float regionLength, const float regionStep) const
@@ -138,24 +224,19 @@ float CutlineEstimator::distance(const Vec3f& line, const Point& p)
 	return abs(line[0] * p.x + line[1] * p.y + line[2]) / sqrt(pow(line[0], 2) + pow(line[1], 2));
 }
 
-float CutlineEstimator::score(const AlignedFingerprint& af, const Fingerprint& f, const Point& afPos, const Point& fPos,
-	Cutline& cLine, const std::vector<Point>& bb, const std::vector<Minutiae>& minutiae, const std::vector<Minutiae>& aMinutiae) const
+CutlineEstimator::Overlap CutlineEstimator::overlap(const AlignedFingerprint& af, const Fingerprint& f, const Point& afPos, const Point& fPos,
+	const std::vector<Point>& bb) const
 {
 	const auto o = f.getOrientations();
 	const auto oa = af.getOrientations();
 	const auto v = f.getFrequencies();
 	const auto va = af.getFrequencies();
 
-	auto orientationValidity = .0f;
-	auto orientationSimilarity = .0f;
+	const auto maxF = af.getMaxF() > f.getMaxF() ? af.getMaxF() : f.getMaxF();
+	const auto minF = af.getMinF() < f.getMinF() ? af.getMinF() : f.getMinF();
+
+	Overlap overlap;
 
-	auto frequencySimilarity = 0.f;
-	
-	auto oNum = .0f;
-	auto oNom = .0f;
-	auto vNum = .0f;
-	auto vNom = .0f;
-	
 	const auto blockSize = f.getBlockSize();
 	for (auto k = bb[0].y + blockSize / 2; k < bb[1].y; k += blockSize)
 	{
@@ -164,40 +245,99 @@ float CutlineEstimator::score(const AlignedFingerprint& af, const Fingerprint& f
 			const auto r1 = oa.at<Vec2f>(k - afPos.y, l - afPos.x)[1];
 			const auto r2 = o.at<Vec2f>(k - fPos.y, l - fPos.x)[1];
 
-			const auto d = this->distance(cLine, Point(l, k));
-
-			// ak sme v popredi odtlacku a do vzdialenosti dmax, ohodnotim reznu liniu v ramci orientacii a frekvencii
-			if (d <= this->dmax && r1 > .0f && r2 > .0f)
+			// ak sme v popredi odtlacku, zapamatam si podobnost orientacii a frekvencii
+			if (r1 > .0f && r2 > .0f)
 			{
 				const auto o1 = oa.at<Vec2f>(k - afPos.y, l - afPos.x)[0];
 				const auto o2 = o.at<Vec2f>(k - fPos.y, l - fPos.x)[0];
 
 				const auto v1 = va.at<float>(k - afPos.y, l - afPos.x);
 				const auto v2 = v.at<float>(k - fPos.y, l - fPos.x);
-				
-				const auto maxF = af.getMaxF() > f.getMaxF() ? af.getMaxF() : f.getMaxF();
-				const auto minF = af.getMinF() < f.getMinF() ? af.getMinF() : f.getMinF();
-
-				orientationValidity = (r1 + r2);
-				orientationSimilarity = static_cast<float>(1.0 - 2.0 * abs(o1 - o2) / CV_PI);
-				
-				oNum += orientationValidity * orientationSimilarity;
-				oNom += orientationValidity;
-
-				frequencySimilarity = 1 - abs(v1 - v2) / (maxF - minF);
-				
-				vNum += frequencySimilarity;
-				vNom += 1;
+
+				overlap.x.push_back(static_cast<float>(l));
+				overlap.y.push_back(static_cast<float>(k));
+				overlap.validity.push_back(r1 + r2);
+				overlap.orientationSimilarity.push_back(static_cast<float>(1.0 - 2.0 * abs(o1 - o2) / CV_PI));
+				overlap.frequencySimilarity.push_back(1 - abs(v1 - v2) / (maxF - minF));
 			}
 		}
 	}
-	
-	// zistim kardinalitu markantov 
-	const auto minutiaesCard = this->minutiaeCardinality(cLine, minutiae);
-	const auto aMinutiaesCard = this->minutiaeCardinality(cLine, aMinutiae);
-	cLine
-		.setPosFMin(minutiaesCard[0]).setNegFMin(minutiaesCard[1])
-		.setPosAfMin(aMinutiaesCard[0]).setNegAfMin(aMinutiaesCard[1]);
+
+	return overlap;
+}
+
+CutlineEstimator::Projection CutlineEstimator::project(const Overlap& overlap, const Vec3f& line) const
+{
+	const auto count = overlap.x.size();
+
+	// priemet je pocitany rovnako ako vo vzdialenosti od linie, aby boli bloky pasu totozne
+	std::vector<float> offsets(count);
+	for (auto i = 0u; i < count; i++)
+	{
+		offsets[i] = line[0] * overlap.x[i] + line[1] * overlap.y[i];
+	}
+
+	std::vector<int> order(count);
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&offsets](const int i1, const int i2) { return offsets[i1] < offsets[i2]; });
+
+	Projection projection;
+	projection.offsets.resize(count);
+	projection.orientation.assign(count + 1, .0);
+	projection.validity.assign(count + 1, .0);
+	projection.frequency.assign(count + 1, .0);
+
+	for (auto k = 0u; k < count; k++)
+	{
+		const auto i = order[k];
+
+		projection.offsets[k] = offsets[i];
+		projection.orientation[k + 1] = projection.orientation[k] + overlap.validity[i] * overlap.orientationSimilarity[i];
+		projection.validity[k + 1] = projection.validity[k] + overlap.validity[i];
+		projection.frequency[k + 1] = projection.frequency[k] + overlap.frequencySimilarity[i];
+	}
+
+	return projection;
+}
+
+SimilarityKernel::Band CutlineEstimator::band(const Projection& projection, const Vec3f& line) const
+{
+	const auto dmax = static_cast<float>(this->dmax);
+	const auto norm = std::sqrt(line[0] * line[0] + line[1] * line[1]);
+	const auto& offsets = projection.offsets;
+
+	// vzdialenost od linie v poradi priemetov najprv klesa a potom rastie,
+	// pas je preto usek medzi prvym a poslednym blokom do vzdialenosti dmax
+	const auto begin = std::partition_point(offsets.begin(), offsets.end(), [&](const float p)
+	{
+		const auto e = p + line[2];
+		return e < 0 && std::abs(e) / norm > dmax;
+	});
+	const auto end = std::partition_point(begin, offsets.end(), [&](const float p)
+	{
+		const auto e = p + line[2];
+		return e < 0 || std::abs(e) / norm <= dmax;
+	});
+
+	const auto first = begin - offsets.begin();
+	const auto last = end - offsets.begin();
+
+	SimilarityKernel::Band band;
+	band.orientation = static_cast<float>(projection.orientation[last] - projection.orientation[first]);
+	band.validity = static_cast<float>(projection.validity[last] - projection.validity[first]);
+	band.frequency = static_cast<float>(projection.frequency[last] - projection.frequency[first]);
+	band.blocks = static_cast<int>(last - first);
+
+	return band;
+}
+
+float CutlineEstimator::score(const SimilarityKernel::Band& band, Cutline& cLine) const
+{
+	// bloky do vzdialenosti dmax ohodnotia reznu liniu v ramci orientacii a frekvencii
+	const auto oNum = band.orientation;
+	const auto oNom = band.validity;
+	const auto vNum = band.frequency;
+	const auto vNom = static_cast<float>(band.blocks);
 
 	float fAfScore = 0;
 	float afFScore = 0;
@@ -206,14 +346,12 @@ float CutlineEstimator::score(const AlignedFingerprint& af, const Fingerprint& f
 	{
 		fAfScore = this->minutiaeScore2(cLine.getPosFCardinality(), cLine.getNegAfCardinality());
 		afFScore = this->minutiaeScore2(cLine.getPosAfCardinality(), cLine.getNegFCardinality());
-		std::cout << "adaptive" << std::endl;
 	}
 	else
 	{
 		// zistim ohodnotenie kardinalit markantov pre rozdelenia reznou liniou
 		fAfScore = this->minutiaeScore(cLine.getPosFCardinality(), cLine.getNegAfCardinality());
 		afFScore = this->minutiaeScore(cLine.getPosAfCardinality(), cLine.getNegFCardinality());
-		std::cout << "original" << std::endl;
 	}
 
 	cLine.setSeparation(fAfScore, afFScore);
@@ -234,6 +372,49 @@ float CutlineEstimator::score(const AlignedFingerprint& af, const Fingerprint& f
 	return eval;
 }
 
+std::vector<Point> CutlineEstimator::project(const std::vector<Minutiae>& minutiaes, const Vec3f& line) const
+{
+	std::vector<std::pair<float, Point>> offsets;
+	offsets.reserve(minutiaes.size());
+
+	// priemet je pocitany rovnako ako strana a vzdialenost od linie
+	for (const auto& minutia : minutiaes)
+	{
+		const auto pos = minutia.getPosition();
+		offsets.emplace_back(line[0] * pos.x + line[1] * pos.y, pos);
+	}
+
+	std::sort(offsets.begin(), offsets.end(), [](const std::pair<float, Point>& p1, const std::pair<float, Point>& p2)
+	{
+		return p1.first < p2.first;
+	});
+
+	std::vector<Point> positions;
+	positions.reserve(offsets.size());
+	for (const auto& offset : offsets)
+	{
+		positions.push_back(offset.second);
+	}
+
+	return positions;
+}
+
+std::array<int, 2> CutlineEstimator::minutiaeCardinality(const std::vector<Point>& positions, const Vec3f& line) const
+{
+	// v poradi priemetov su najprv markanty na pozitivnej strane so vzdialenostou klesajucou
+	// k linii a potom markanty na negativnej strane so vzdialenostou rastucou
+	const auto positive = std::partition_point(positions.begin(), positions.end(), [&](const Point& pos)
+	{
+		return isPositive(line, pos) && (!this->adaptiveMethod || distance(line, pos) >= this->dmax);
+	});
+	const auto negative = std::partition_point(positive, positions.end(), [&](const Point& pos)
+	{
+		return isPositive(line, pos) || (this->adaptiveMethod && distance(line, pos) < this->dmax);
+	});
+
+	return { static_cast<int>(positive - positions.begin()), static_cast<int>(positions.end() - negative) };
+}
+
 bool CutlineEstimator::isPositive(const Vec3f& line, const Point& pos)
 {
 	if (line[0] * pos.x + line[1] * pos.y + line[2] < 0)
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "storage/Cutline.h"
+#include "SimilarityKernel.h"
 
 #include <FingerprintProcessor.h>
 
+#include <atomic>
+
 namespace processing
 {
 	namespace storage
@@ -36,6 +39,59 @@ namespace morphing
 		class CutlineEstimator
 		{
 		private:
+			/**
+			 * \brief Bloky prekrytia odtlackov, ktore lezia v popredi oboch odtlackov.
+			 * Hodnoty su ulozene v samostatnych poliach v poradi prechadzania blokov.
+			 */
+			struct Overlap
+			{
+				/**
+				 * \brief x-ove suradnice stredov blokov v suradniciach zarovnania.
+				 */
+				std::vector<float> x;
+				/**
+				 * \brief y-ove suradnice stredov blokov v suradniciach zarovnania.
+				 */
+				std::vector<float> y;
+				/**
+				 * \brief Sucet regionov oboch odtlackov v bloku.
+				 */
+				std::vector<float> validity;
+				/**
+				 * \brief Podobnost orientacii v bloku.
+				 */
+				std::vector<float> orientationSimilarity;
+				/**
+				 * \brief Podobnost frekvencii v bloku.
+				 */
+				std::vector<float> frequencySimilarity;
+			};
+
+			/**
+			 * \brief Bloky prekrytia zoradene podla priemetu na normalu reznej linie
+			 * s prefixovymi suctami podobnosti. Pas okolo kazdej linie s touto normalou
+			 * je suvisly usek priemetov, jeho sumy su rozdielom dvoch prefixovych suctov.
+			 */
+			struct Projection
+			{
+				/**
+				 * \brief Priemety a * x + b * y stredov blokov, vzostupne.
+				 */
+				std::vector<float> offsets;
+				/**
+				 * \brief Prefixove sucty vahovanych podobnosti orientacii.
+				 */
+				std::vector<double> orientation;
+				/**
+				 * \brief Prefixove sucty vah orientacii.
+				 */
+				std::vector<double> validity;
+				/**
+				 * \brief Prefixove sucty podobnosti frekvencii.
+				 */
+				std::vector<double> frequency;
+			};
+
 			// members
 			/**
 			 * \brief Maximalna vzdialenost od reznej linie.
@@ -66,6 +122,10 @@ namespace morphing
 			 * \brief Indikator pouzitia povodnej metody.
 			 */
 			bool adaptiveMethod = false;
+			/**
+			 * \brief Indikator paralelneho ohodnotenia reznych linii.
+			 */
+			bool parallelSearch = false;
 			
 			/**
 			 * \brief Rezna linia.
@@ -89,7 +149,7 @@ namespace morphing
 			/**
 			 * \brief Pocet zobrazeni v ramci jedneho behu.
 			 */
-			static int displayed;
+			static std::atomic<int> displayed;
 
 			// methods
 			/**
@@ -115,21 +175,67 @@ namespace morphing
 			 */
 			cv::Vec3f estimateCutline(float rotation, float regionLength, float regionStep) const;
 			/**
-			 * \brief Ohodnoti reznu linie, na zaklade informacii extrahovanych z odtlacku
-			 * za pomoci preddefinovanych vah.
+			 * \brief Ohodnoti vsetky rezne linie, v paralelnom rezime rozdelene medzi vlakna,
+			 * a ulozi prvu najlepsie ohodnotenu v poradi linii. Linie s rovnakym otocenim
+			 * zdielaju jeden priemet blokov prekrytia a markantov. Markanty su rozdelene
+			 * len pre vybranu liniu.
+			 * \param lines rezne linie v poradi prehladavania
+			 * \param overlap bloky prekrytia
+			 * \param minutiae markanty odtlacku
+			 * \param aMinutiae markanty zarovnaneho odtlacku
+			 */
+			void search(const std::vector<cv::Vec3f>& lines, const Overlap& overlap,
+				const std::vector<processing::utils::storage::Minutiae>& minutiae, const std::vector<processing::utils::storage::Minutiae>& aMinutiae);
+			/**
+			 * \brief Vyberie bloky prekrytia a spocita ich podobnosti, ktore su pre
+			 * vsetky rezne linie rovnake.
 			 * \param af zarovnany odtlacok
 			 * \param f odtalcok
 			 * \param afPos pozicia zarovnaneho odtlacku
 			 * \param fPos pozicia odtlacku
-			 * \param cLine rezna linia urcena k ohodnoteniu
 			 * \param bb "2D bounding box" prekrytia
-			 * \param minutiae markanty odtlacku
-			 * \param aMinutiae markanty zarovnaneho odtlacku
+			 * \return bloky prekrytia
+			 */
+			Overlap overlap(const morphing::storage::AlignedFingerprint& af, const processing::storage::Fingerprint& f,
+				const cv::Point& afPos, const cv::Point& fPos, const std::vector<cv::Point>& bb) const;
+			/**
+			 * \brief Zoradi bloky prekrytia podla priemetu na normalu linie.
+			 * \param overlap bloky prekrytia
+			 * \param line linia urcujuca normalu
+			 * \return priemet blokov prekrytia
+			 */
+			Projection project(const Overlap& overlap, const cv::Vec3f& line) const;
+			/**
+			 * \brief Spocita sumy blokov do vzdialenosti dmax od linie z priemetu blokov
+			 * na jej normalu. Bloky pasu su rovnake ako pri priamom prechode blokov.
+			 * \param projection priemet blokov prekrytia na normalu linie
+			 * \param line rezna linia
+			 * \return sumy pasu okolo reznej linie
+			 */
+			SimilarityKernel::Band band(const Projection& projection, const cv::Vec3f& line) const;
+			/**
+			 * \brief Zoradi pozicie markantov podla priemetu na normalu linie.
+			 * \param minutiaes markanty
+			 * \param line linia urcujuca normalu
+			 * \return pozicie markantov zoradene podla priemetu
+			 */
+			std::vector<cv::Point> project(const std::vector<processing::utils::storage::Minutiae>& minutiaes, const cv::Vec3f& line) const;
+			/**
+			 * \brief Spocita markanty na jednotlivych stranach reznej linie z pozicii zoradenych
+			 * podla priemetu na jej normalu. Rozdelenie je rovnake ako pri minutiaeCardinality.
+			 * \param positions pozicie markantov zoradene podla priemetu na normalu linie
+			 * \param line rezna linia
+			 * \return kardinalita markantov na pozitivnej a negativnej strane
+			 */
+			std::array<int, 2> minutiaeCardinality(const std::vector<cv::Point>& positions, const cv::Vec3f& line) const;
+			/**
+			 * \brief Ohodnoti reznu linie, na zaklade informacii extrahovanych z odtlacku
+			 * za pomoci preddefinovanych vah.
+			 * \param band sumy blokov prekrytia do vzdialenosti dmax od linie
+			 * \param cLine rezna linia urcena k ohodnoteniu, s nastavenymi kardinalitami markantov
 			 * \return 
 			 */
-			float score(const morphing::storage::AlignedFingerprint& af, const processing::storage::Fingerprint& f,
-				const cv::Point& afPos, const cv::Point& fPos, storage::Cutline& cLine, const std::vector<cv::Point>& bb,
-				const std::vector<processing::utils::storage::Minutiae>& minutiae, const std::vector<processing::utils::storage::Minutiae>& aMinutiae) const;
+			float score(const SimilarityKernel::Band& band, storage::Cutline& cLine) const;
 			/**
 			 * \brief Separuje markanty na jednotlive strany reznej linie.
 			 * \param line rezna linia
@@ -250,6 +356,7 @@ namespace morphing
 			
 			// getters
 			bool isVerbose() const { return this->verboseOutput; }
+			bool isParallel() const { return this->parallelSearch; }
 			int getMaxDistance() const { return this->dmax; }
 			float getRotationStep() const { return this->rotStep; }
 			float getOWeight() const { return this->oWeight; }
@@ -266,6 +373,7 @@ namespace morphing
 			CutlineEstimator& setArea(const int area) { this->area = area; return *this; }
 			CutlineEstimator& useDynamicCutline(const bool dynamicCutline = true) { this->dynamicCutline = dynamicCutline; return *this; }
 			CutlineEstimator& useAdaptiveMethod(const bool adaptiveMethod = true) { this->adaptiveMethod = adaptiveMethod; return *this; }
+			CutlineEstimator& parallel(const bool parallelSearch = true) { this->parallelSearch = parallelSearch; return *this; }
 			
 		};
 	}
@@ -1,17 +1,25 @@
 #include "FingerprintAligner.h"
+#include "OrientationCorrelator.h"
+#include "SimilarityKernel.h"
 #include "storage/AlignedFingerprint.h"
 
 #include <utils/ImageProcessor.h>
 #include <storage/Fingerprint.h>
 
+#include <algorithm>
+#include <tuple>
+
 using namespace morphing::storage;
 using namespace morphing::utils;
 using namespace processing::storage;
+using namespace processing::utils::storage;
 using namespace processing::utils;
 using namespace processing;
 using namespace cv;
 
-int FingerprintAligner::displayed = 0;
+std::atomic<int> FingerprintAligner::displayed(0);
+const int FingerprintAligner::bandRows = 4;
+const float FingerprintAligner::boundTolerance = 1e-5f;
 const std::string FingerprintAligner::class_name = "FingerprintAligner::";
 
 FingerprintAligner::FingerprintAligner(FingerprintProcessor& processor) : processor(processor) { }
@@ -25,14 +33,13 @@ void FingerprintAligner::accurateAlign(AlignedFingerprint& af, Fingerprint& f)
 	auto pos = Vec3f(.0f, .0f, .0f);
 
 	auto aligned = AlignedFingerprint(af);
+	Preprocessor::Workspace workspace;
 
 	for (auto angle = -90; angle <= 90; angle += this->rotationStep)
 	{
 		*static_cast<Mat*>(&aligned) = ImageProcessor::rotate(af, angle);
 
-		this->processor.normalize(aligned);
-		
-		this->processor.estimateOrientations(aligned);
+		this->processor.preprocess(aligned, workspace);
 		auto oa = aligned.getOrientations();
 
 		// o polovicu zmensim prehladavanie
@@ -41,6 +48,8 @@ void FingerprintAligner::accurateAlign(AlignedFingerprint& af, Fingerprint& f)
 
 		// o polovicu odtlacku shiftnem poziciu odtlacku
 		const Point fPos(cols / 2 * this->translationStep, rows / 2 * this->translationStep);
+
+		const auto blocks = referenceBlocks(oa.size(), aligned.getBlocks(), o.size(), f.getBlocks());
 		
 		for (auto i = 0; i < rows; i++)
 		{
@@ -49,7 +58,7 @@ void FingerprintAligner::accurateAlign(AlignedFingerprint& af, Fingerprint& f)
 				// pozicia zarovnavaneho
 				const Point afPos(j * this->translationStep, i * this->translationStep);
 
-				const auto s = similarity(aligned, f, afPos, fPos);
+				const auto s = this->similarity(oa, o, aligned.getBlockSize(), 1, blocks, afPos, fPos);
 	
 				if (maxSimilarity < s)
 				{
@@ -78,60 +87,87 @@ void FingerprintAligner::accurateAlign(AlignedFingerprint& af, Fingerprint& f)
 
 void FingerprintAligner::align(AlignedFingerprint& af, Fingerprint& f) const
 {
-	auto o = f.getOrientations();
 	auto oa = af.getOrientations();
 	auto na = af.getNormalized();
 	auto va = af.getFrequencies();
 	auto ra = af.getRegionMask();
 
-	auto maxSimilarity = .0f;
-	auto pos = Vec3f(.0f, .0f, .0f);
+	const auto blockSize = af.getBlockSize();
 
-	auto aligned = AlignedFingerprint(af);
-	std::vector<Point> identity;
-	for (auto angle = -90; angle <= 90; angle += this->rotationStep)
+	const auto field = BlockField(f.getOrientations(), blockSize);
+	const auto blocks = f.getBlocks();
+
+	const auto rotations = this->rotations(oa, blockSize, af.fingerName);
+
+	// korelacia pracuje s posunutiami po celych blokoch
+	const auto blockAligned = this->translationStep % blockSize == 0;
+
+	std::vector<Candidate> candidates;
+	if (this->isCorrelation() && blockAligned)
+	{
+		candidates = this->correlate(rotations, f, field, blocks);
+	}
+	else if (this->isHierarchical())
 	{
-		// segmentacia odtlacku
-		std::vector<Point> ol;
-		auto oar = rotateOrientations(oa, angle, ol);
-		*static_cast<Mat*>(&aligned) = Mat::zeros(oar.size(), af.type());
-		aligned.setOrientations(oar);
+		const auto scale = this->coarseScale;
 
-		// zaistenie velkosti celej oblasti zarovnanvani vramci oboch odtlackov
-		const auto rows = oar.rows / this->translationStep / 2 + f.rows / this->translationStep / 2;
-		const auto cols = oar.cols / this->translationStep / 2 + f.cols / this->translationStep / 2;
+		// hrube prehladavanie, kazde scale-te otocenie, posunutie aj blok
+		std::vector<Rotation> coarse;
+		for (auto r = 0u; r < rotations.size(); r += scale)
+		{
+			auto rotation = rotations[r];
+			rotation.blocks = rotation.field.blocks(scale);
+			coarse.push_back(rotation);
+		}
 
-		const Point fPos(cols / 2 * this->translationStep, rows / 2 * this->translationStep);
+		const auto coarseTiles = this->tiles(coarse, f.size(), bandRows * scale, scale);
+		const auto coarseBlocks = field.blocks(scale);
 
-		for (auto i = 0; i < rows; i++)
+		std::vector<Candidate> best(coarse.size());
+		for (auto r = 0u; r < coarse.size(); r++)
 		{
-			for (auto j = 0; j < cols; j++)
+			best[r].rotation = r * scale;
+		}
+		for (const auto& candidate : this->search(coarseTiles, coarse, f, field, coarseBlocks, scale, false))
+		{
+			if (best[candidate.rotation].similarity < candidate.similarity)
 			{
-				// skacem po blokoch
-				const Point afPos(j * this->translationStep, i * this->translationStep);
+				best[candidate.rotation].similarity = candidate.similarity;
+				best[candidate.rotation].offset = candidate.offset;
+			}
+		}
 
-				const auto bb = overlay(fPos, afPos, f.size(), oar.size());
-				const auto overlapped = ((bb[1].x - bb[0].x) / f.getBlockSize()) * ((bb[1].y - bb[0].y) / f.getBlockSize());
+		// zjemnenie v plnom rozliseni okolo najlepsich hrubych zarovnani
+		const auto tiles = this->refinement(rotations, best, f.size());
+		candidates = this->search(tiles, rotations, f, field, blocks, 1, true);
+	}
+	else
+	{
+		const auto tiles = this->tiles(rotations, f.size(), bandRows);
+		candidates = this->search(tiles, rotations, f, field, blocks, 1, true);
+	}
 
-				if (this->negligibleArea(overlapped, aligned, f))
-				{
-					continue;
-				}
-				
-				const auto s = similarity(aligned, f, afPos, fPos);
+	// pri zhode vyhra zarovnanie, ktore seriove prehladavanie navstivi prve: mensie otocenie,
+	// potom riadok a stlpec posunutia; okna zjemnenia sa prekryvaju, poradie casti preto nestaci
+	Candidate best;
+	for (const auto& candidate : candidates)
+	{
+		if (best.similarity < candidate.similarity || (candidate.similarity > .0f && best.similarity == candidate.similarity
+			&& std::make_tuple(candidate.rotation, candidate.offset.y, candidate.offset.x) < std::make_tuple(best.rotation, best.offset.y, best.offset.x)))
+		{
+			best = candidate;
+		}
+	}
 
-				if (maxSimilarity < s)
-				{
-					maxSimilarity = s;
-					pos = Vec3f(afPos.x - fPos.x, afPos.y - fPos.y, angle);
+	std::vector<Point> identity;
+	if (best.similarity > .0f)
+	{
+		const auto& rotation = rotations[best.rotation];
+		identity = rotation.identity;
 
-					identity = ol;
-					
-					af.setOrientations(oar);
-					af.setAlignment(pos[0], pos[1], pos[2]);
-				}
-			}
-		}
+		// otocenie z vyrovnavacej pamate nema pixelove orientacie, dopocitam len vitazne
+		af.setOrientations(rotation.orientations.empty() ? rotateOrientations(oa, rotation.angle, identity) : rotation.orientations);
+		af.setAlignment(best.offset.x, best.offset.y, rotation.angle);
 	}
 
 	// otocim a orezem ostatne vlastnosti tak aby boli vhodne k zarovnanemu odtlacku
@@ -160,13 +196,364 @@ void FingerprintAligner::align(AlignedFingerprint& af, Fingerprint& f) const
 	}
 }
 
-float FingerprintAligner::similarity(AlignedFingerprint& af, Fingerprint& f, const Point& afPos, const Point& fPos) const
+std::vector<FingerprintAligner::Rotation> FingerprintAligner::rotations(const Mat& oa, const int blockSize, const std::string& name) const
+{
+	// pixelove orientacie su potrebne, ak posunutia nelezia na hraniciach blokov
+	const auto cached = this->rotationCache && !name.empty() && this->translationStep % blockSize == 0;
+
+	std::vector<Rotation> rotations;
+	for (auto angle = -90; angle <= 90; angle += this->rotationStep)
+	{
+		rotations.push_back({ angle, Mat(), BlockField(), std::vector<Point>(), 0 });
+	}
+
+	const auto rotate = [&](const Range& range)
+	{
+		for (auto r = range.start; r < range.end; r++)
+		{
+			auto& rotation = rotations[r];
+
+			RotationCache::Entry entry;
+			if (cached && this->rotationCache->find(name, rotation.angle, blockSize, entry))
+			{
+				rotation.field = entry.field;
+				rotation.identity = entry.identity;
+				rotation.blocks = entry.blocks;
+				continue;
+			}
+			
+			// segmentacia odtlacku
+			rotation.orientations = rotateOrientations(oa, rotation.angle, rotation.identity);
+			rotation.field = BlockField(rotation.orientations, blockSize);
+			rotation.blocks = rotation.field.blocks();
+
+			if (cached)
+			{
+				this->rotationCache->insert(name, rotation.angle, blockSize, { rotation.field, rotation.identity, rotation.blocks });
+			}
+		}
+	};
+
+	if (this->isParallel())
+	{
+		parallel_for_(Range(0, static_cast<int>(rotations.size())), rotate);
+	}
+	else
+	{
+		rotate(Range(0, static_cast<int>(rotations.size())));
+	}
+
+	return rotations;
+}
+
+Size FingerprintAligner::translations(const Size& oarSize, const Size& fSize) const
+{
+	// zaistenie velkosti celej oblasti zarovnanvani vramci oboch odtlackov
+	const auto rows = oarSize.height / this->translationStep / 2 + fSize.height / this->translationStep / 2;
+	const auto cols = oarSize.width / this->translationStep / 2 + fSize.width / this->translationStep / 2;
+
+	return { cols, rows };
+}
+
+std::vector<FingerprintAligner::Tile> FingerprintAligner::tiles(const std::vector<Rotation>& rotations, const Size& fSize, 
+	const int rows, const int stride) const
+{
+	std::vector<Tile> tiles;
+	for (auto r = 0u; r < rotations.size(); r++)
+	{
+		const auto grid = this->translations(rotations[r].field.getSize(), fSize);
+
+		for (auto top = 0; top < grid.height; top += rows)
+		{
+			tiles.push_back({ r, top, std::min(top + rows, grid.height), 0, grid.width, stride });
+		}
+	}
+
+	return tiles;
+}
+
+std::vector<FingerprintAligner::Tile> FingerprintAligner::refinement(const std::vector<Rotation>& rotations, std::vector<Candidate> candidates, 
+	const Size& fSize) const
+{
+	const auto scale = this->coarseScale;
+
+	// najlepsie hrube zarovnania, pri zhode rozhoduje poradie otocenia
+	std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& c1, const Candidate& c2)
+	{
+		return c1.similarity > c2.similarity;
+	});
+
+	std::vector<Tile> tiles;
+	for (auto c = 0u; c < candidates.size() && c < static_cast<std::size_t>(this->coarseCandidates); c++)
+	{
+		const auto& candidate = candidates[c];
+		if (candidate.similarity <= .0f)
+		{
+			break;
+		}
+
+		// okolie o velkosti jedneho hrubeho kroku na kazdu stranu
+		for (auto d = -scale; d <= scale; d++)
+		{
+			const auto r = static_cast<int>(candidate.rotation) + d;
+			if (r < 0 || r >= static_cast<int>(rotations.size()))
+			{
+				continue;
+			}
+
+			const auto grid = this->translations(rotations[r].field.getSize(), fSize);
+			const auto i = candidate.offset.y / this->translationStep + grid.height / 2;
+			const auto j = candidate.offset.x / this->translationStep + grid.width / 2;
+
+			const Tile tile = {
+				static_cast<std::size_t>(r),
+				std::max(0, i - scale), std::min(grid.height, i + scale + 1),
+				std::max(0, j - scale), std::min(grid.width, j + scale + 1),
+				1
+			};
+
+			if (tile.top < tile.bottom && tile.left < tile.right)
+			{
+				tiles.push_back(tile);
+			}
+		}
+	}
+
+	// casti v poradi otocenia a polohy; zhody rozhoduje az zlucenie podla otocenia a posunutia
+	std::sort(tiles.begin(), tiles.end(), [](const Tile& t1, const Tile& t2)
+	{
+		return std::tie(t1.rotation, t1.top, t1.left) < std::tie(t2.rotation, t2.top, t2.left);
+	});
+
+	return tiles;
+}
+
+std::vector<FingerprintAligner::Candidate> FingerprintAligner::search(const std::vector<Tile>& tiles, const std::vector<Rotation>& rotations, 
+	const Fingerprint& f, const BlockField& field, const int blocks, const int scale, const bool shared) const
+{
+	// najlepsia podobnost vsetkych casti, orezava len zarovnania, ktore su od nej ostro horsie
+	std::atomic<float> incumbent(.0f);
+
+	// kazda cast si pamata prve najlepsie zarovnanie vo svojom poradi prechodu,
+	// zhody medzi castami rozhoduje zlucenie podla otocenia a posunutia
+	std::vector<Candidate> candidates(tiles.size());
+	const auto searchTiles = [&](const Range& range)
+	{
+		for (auto t = range.start; t < range.end; t++)
+		{
+			const auto& tile = tiles[t];
+			candidates[t] = this->search(tile, rotations[tile.rotation], f, field, blocks, scale, shared ? &incumbent : nullptr);
+		}
+	};
+
+	if (this->isParallel())
+	{
+		parallel_for_(Range(0, static_cast<int>(tiles.size())), searchTiles);
+	}
+	else
+	{
+		searchTiles(Range(0, static_cast<int>(tiles.size())));
+	}
+
+	return candidates;
+}
+
+FingerprintAligner::Candidate FingerprintAligner::search(const Tile& tile, const Rotation& rotation, const Fingerprint& f, 
+	const BlockField& field, const int blocks, const int scale, std::atomic<float>* incumbent) const
+{
+	const auto o = f.getOrientations();
+	const auto& oar = rotation.orientations;
+	const auto oarSize = rotation.field.getSize();
+
+	const auto reference = referenceBlocks(oarSize, rotation.blocks, o.size(), blocks);
+
+	const auto grid = this->translations(oarSize, f.size());
+	const Point fPos(grid.width / 2 * this->translationStep, grid.height / 2 * this->translationStep);
+
+	const auto fBlockSize = f.getBlockSize() * scale;
+
+	// blokove pole je mozne pouzit, len ak posunutia lezia na hraniciach blokov
+	const auto blockAligned = this->translationStep % field.getBlockSize() == 0;
+
+	Candidate best;
+	best.rotation = tile.rotation;
+
+	for (auto i = tile.top; i < tile.bottom; i += tile.stride)
+	{
+		for (auto j = tile.left; j < tile.right; j += tile.stride)
+		{
+			// skacem po blokoch
+			const Point afPos(j * this->translationStep, i * this->translationStep);
+
+			const auto bb = overlay(fPos, afPos, f.size(), oarSize);
+			const auto overlapped = ((bb[1].x - bb[0].x) / fBlockSize) * ((bb[1].y - bb[0].y) / fBlockSize);
+
+			if (this->negligibleArea(overlapped, reference))
+			{
+				if (this->statistics)
+				{
+					this->statistics->negligible++;
+				}
+				continue;
+			}
+
+			// prekrytie nemoze mat viac blokov popredia nez ktorekolvek z poli v okne prekrytia,
+			// tabulky suctov tak v konstantnom case vylucia posunutia so zanedbatelnym prekrytim
+			if (blockAligned && scale == 1)
+			{
+				Rect afBlocks, fBlocks;
+				overlapBlocks(bb, afPos, fPos, field.getBlockSize(), 1, afBlocks, fBlocks);
+
+				const auto bound = std::min(
+					rotation.field.foreground(afBlocks.y, afBlocks.x, afBlocks.y + afBlocks.height, afBlocks.x + afBlocks.width),
+					field.foreground(fBlocks.y, fBlocks.x, fBlocks.y + fBlocks.height, fBlocks.x + fBlocks.width)
+				);
+
+				if (this->negligibleArea(bound, reference))
+				{
+					if (this->statistics)
+					{
+						this->statistics->negligible++;
+					}
+					continue;
+				}
+			}
+
+			// vlastne najlepsie zarovnanie casti, pripadne lepsie z inych casti
+			auto threshold = .0f;
+			if (this->isBounded())
+			{
+				threshold = incumbent ? std::max(best.similarity, incumbent->load()) : best.similarity;
+			}
+			
+			const auto s = blockAligned
+				? this->similarity(rotation.field, field, scale, reference, afPos, fPos, threshold)
+				: this->similarity(oar, o, field.getBlockSize(), scale, reference, afPos, fPos);
+
+			if (best.similarity < s)
+			{
+				best.similarity = s;
+				best.offset = afPos - fPos;
+
+				// zdielana najlepsia podobnost len rastie
+				if (incumbent)
+				{
+					auto current = incumbent->load();
+					while (current < s && !incumbent->compare_exchange_weak(current, s))
+					{
+					}
+				}
+			}
+		}
+	}
+
+	return best;
+}
+
+std::vector<FingerprintAligner::Candidate> FingerprintAligner::correlate(const std::vector<Rotation>& rotations, const Fingerprint& f, 
+	const BlockField& field, const int blocks) const
+{
+	const auto o = f.getOrientations();
+	const auto blockSize = field.getBlockSize();
+
+	// spektra odtlacku su spolocne pre vsetky otocenia
+	Size size;
+	for (const auto& rotation : rotations)
+	{
+		size.width = std::max(size.width, rotation.field.getCols());
+		size.height = std::max(size.height, rotation.field.getRows());
+	}
+	const OrientationCorrelator correlator(field, size);
+
+	std::vector<Candidate> candidates(rotations.size());
+	const auto correlateRotations = [&](const Range& range)
+	{
+		for (auto r = range.start; r < range.end; r++)
+		{
+			const auto& rotation = rotations[r];
+			const auto oarSize = rotation.field.getSize();
+
+			const auto reference = referenceBlocks(oarSize, rotation.blocks, o.size(), blocks);
+			const auto correlation = correlator.correlate(rotation.field);
+
+			const auto grid = this->translations(oarSize, f.size());
+			const Point fPos(grid.width / 2 * this->translationStep, grid.height / 2 * this->translationStep);
+
+			// posunutia s kladnou kosinusovou podobnostou v poradi prehladavania
+			std::vector<std::pair<float, Point>> peaks;
+			for (auto i = 0; i < grid.height; i++)
+			{
+				for (auto j = 0; j < grid.width; j++)
+				{
+					const Point afPos(j * this->translationStep, i * this->translationStep);
+
+					// rovnaky odhad plochy prekrytia ako pri priamom prehladavani
+					const auto bb = overlay(fPos, afPos, f.size(), oarSize);
+					if (bb[1].x <= bb[0].x || bb[1].y <= bb[0].y
+						|| this->negligibleArea(((bb[1].x - bb[0].x) / blockSize) * ((bb[1].y - bb[0].y) / blockSize), reference))
+					{
+						continue;
+					}
+
+					auto nominator = .0f;
+					auto overlapped = 0;
+					const auto numerator = correlation.at((afPos.x - fPos.x) / blockSize, (afPos.y - fPos.y) / blockSize, nominator, overlapped);
+
+					if (this->negligibleArea(overlapped, reference) || numerator <= .0f)
+					{
+						continue;
+					}
+
+					peaks.emplace_back(numerator / nominator, Point(j, i));
+				}
+			}
+
+			// najlepsie posunutia korelacie, pri zhode rozhoduje poradie prehladavania
+			const auto count = std::min(peaks.size(), static_cast<std::size_t>(std::max(this->correlationPeaks, 1)));
+			std::stable_sort(peaks.begin(), peaks.end(), [](const std::pair<float, Point>& p1, const std::pair<float, Point>& p2)
+			{
+				return p1.first > p2.first;
+			});
+			peaks.resize(count);
+			std::sort(peaks.begin(), peaks.end(), [](const std::pair<float, Point>& p1, const std::pair<float, Point>& p2)
+			{
+				return std::tie(p1.second.y, p1.second.x) < std::tie(p2.second.y, p2.second.x);
+			});
+
+			// presne ohodnotenie rovnakou podobnostou ako pri priamom prehladavani
+			Candidate best;
+			best.rotation = r;
+			for (const auto& peak : peaks)
+			{
+				const Point afPos(peak.second.x * this->translationStep, peak.second.y * this->translationStep);
+				const auto s = this->similarity(rotation.field, field, 1, reference, afPos, fPos);
+
+				if (best.similarity < s)
+				{
+					best.similarity = s;
+					best.offset = afPos - fPos;
+				}
+			}
+
+			candidates[r] = best;
+		}
+	};
+
+	if (this->isParallel())
+	{
+		parallel_for_(Range(0, static_cast<int>(rotations.size())), correlateRotations);
+	}
+	else
+	{
+		correlateRotations(Range(0, static_cast<int>(rotations.size())));
+	}
+
+	return candidates;
+}
+
+float FingerprintAligner::similarity(const Mat& oa, const Mat& o, const int blockSize, const int stride, const int blocks, 
+	const Point& afPos, const Point& fPos) const
 {
-	auto o = f.getOrientations();
-	auto oa = af.getOrientations();
-	
-	const auto blockSize = af.getBlockSize();
-	
 	auto numerator = .0f;
 	auto nominator = .0f;
 
@@ -174,9 +561,9 @@ float FingerprintAligner::similarity(AlignedFingerprint& af, Fingerprint& f, con
 
 	const auto bb = overlay(fPos, afPos, o.size(), oa.size());
 
-	for (auto k = bb[0].y + blockSize / 2; k < bb[1].y; k += blockSize)
+	for (auto k = bb[0].y + blockSize / 2; k < bb[1].y; k += blockSize * stride)
 	{
-		for (auto l = bb[0].x + blockSize / 2; l < bb[1].x; l += blockSize)
+		for (auto l = bb[0].x + blockSize / 2; l < bb[1].x; l += blockSize * stride)
 		{
 			// regiony odtlackov
 			const auto r1 = oa.at<Vec2f>(k - afPos.y, l - afPos.x)[1];
@@ -196,12 +583,74 @@ float FingerprintAligner::similarity(AlignedFingerprint& af, Fingerprint& f, con
 		}
 	}
 
-	if (this->negligibleArea(overlapped, af, f))
+	if (this->negligibleArea(overlapped, blocks))
 	{
 		return -1;
 	}
 	
-	return numerator / nominator;;
+	return numerator / nominator;
+}
+
+float FingerprintAligner::similarity(const BlockField& oa, const BlockField& o, const int stride, const int blocks, 
+	const Point& afPos, const Point& fPos, const float incumbent) const
+{
+	const auto blockSize = o.getBlockSize();
+
+	SimilarityKernel::Orientation sum;
+
+	const auto bb = overlay(fPos, afPos, o.getSize(), oa.getSize());
+
+	Rect afBlocks, fBlocks;
+	overlapBlocks(bb, afPos, fPos, blockSize, stride, afBlocks, fBlocks);
+
+	// posledny vzorkovany stlpec oboch poli
+	const auto afRight = afBlocks.x + (afBlocks.width - 1) * stride + 1;
+	const auto fRight = fBlocks.x + (fBlocks.width - 1) * stride + 1;
+	const auto bottom = (afBlocks.height - 1) * stride + 1;
+
+	for (auto n = 0; n < afBlocks.height; n++)
+	{
+		// bloky mimo popredia oboch odtlackov vylucuje jadro maskou
+		SimilarityKernel::orientation(oa.orientations(afBlocks.y + n * stride) + afBlocks.x, oa.weights(afBlocks.y + n * stride) + afBlocks.x,
+			o.orientations(fBlocks.y + n * stride) + fBlocks.x, o.weights(fBlocks.y + n * stride) + fBlocks.x, afBlocks.width, stride, sum);
+
+		if (incumbent <= .0f || n + 1 == afBlocks.height)
+		{
+			continue;
+		}
+
+		// vahy zostavajucich blokov popredia oboch poli, pri riedkej mriezke vratane
+		// nevzorkovanych, odhad je preto len volnejsi
+		const auto remaining = static_cast<float>(
+			oa.weight(afBlocks.y + (n + 1) * stride, afBlocks.x, afBlocks.y + bottom, afRight)
+			+ o.weight(fBlocks.y + (n + 1) * stride, fBlocks.x, fBlocks.y + bottom, fRight));
+
+		// podobnost bloku je najviac 1, (numerator + x) / (nominator + x) s x rastie
+		const auto bound = sum.nominator + remaining > .0f
+			? (sum.numerator + remaining) / (sum.nominator + remaining)
+			: .0f;
+
+		if (bound + boundTolerance < incumbent)
+		{
+			if (this->statistics)
+			{
+				this->statistics->bounded++;
+			}
+			return -1;
+		}
+	}
+
+	if (this->statistics)
+	{
+		this->statistics->evaluated++;
+	}
+
+	if (this->negligibleArea(sum.overlapped, blocks))
+	{
+		return -1;
+	}
+	
+	return sum.numerator / sum.nominator;
 }
 
 int FingerprintAligner::unitLength(const Vec2f& pos, const int length1, const int length2)
@@ -251,20 +700,8 @@ Point FingerprintAligner::fingPos(const int xOffset, const int yOffset)
 	return {fx, fy};
 }
 
-bool FingerprintAligner::negligibleArea(const int overlapped, AlignedFingerprint& af, Fingerprint& f) const
+bool FingerprintAligner::negligibleArea(const int overlapped, const int blocks) const
 {
-	int blocks;
-	// get smaller one
-	if (af.getOrientations().rows * af.getOrientations().cols
-		> f.getOrientations().rows * f.getOrientations().cols)
-	{
-		blocks = af.getBlocks();
-	}
-	else
-	{
-		blocks = f.getBlocks();
-	}
-
 	if (overlapped < blocks * this->trashHold)
 	{
 		return true;
@@ -274,6 +711,30 @@ bool FingerprintAligner::negligibleArea(const int overlapped, AlignedFingerprint
 	return false;
 }
 
+void FingerprintAligner::overlapBlocks(const std::vector<Point>& bb, const Point& afPos, const Point& fPos, const int blockSize, 
+	const int stride, Rect& afBlocks, Rect& fBlocks)
+{
+	// pocet vzorkovanych blokov prekrytia, rovnaky ako v pixelovej verzii
+	const auto step = blockSize * stride;
+	const auto rows = bb[1].y - bb[0].y > blockSize / 2 ? (bb[1].y - bb[0].y - blockSize / 2 - 1) / step + 1 : 0;
+	const auto cols = bb[1].x - bb[0].x > blockSize / 2 ? (bb[1].x - bb[0].x - blockSize / 2 - 1) / step + 1 : 0;
+
+	// prve bloky prekrytia v oboch poliach
+	afBlocks = Rect((bb[0].x - afPos.x) / blockSize, (bb[0].y - afPos.y) / blockSize, cols, rows);
+	fBlocks = Rect((bb[0].x - fPos.x) / blockSize, (bb[0].y - fPos.y) / blockSize, cols, rows);
+}
+
+int FingerprintAligner::referenceBlocks(const Size& afSize, const int afBlocks, const Size& fSize, const int fBlocks)
+{
+	// get smaller one
+	if (afSize.area() > fSize.area())
+	{
+		return afBlocks;
+	}
+
+	return fBlocks;
+}
+
 Mat FingerprintAligner::rotateOrientations(const Mat& orientations, const float angle, std::vector<Point>& bb)
 {
 	const Point2f center((orientations.cols - 1) / 2.0, (orientations.rows - 1) / 2.0);
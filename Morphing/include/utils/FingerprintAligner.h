@@ -1,6 +1,14 @@
 #pragma once
 
+#include "RotationCache.h"
+
 #include <FingerprintProcessor.h>
+#include <storage/BlockField.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace processing
 {
@@ -24,7 +32,109 @@ namespace morphing
 		 */
 		class FingerprintAligner
 		{
+		public:
+			/**
+			 * \brief Pocitadla prehladavania posunuti, zdielane vsetkymi vlaknami.
+			 */
+			struct Statistics
+			{
+				/**
+				 * \brief Pocet posunuti ohodnotenych uplnym porovnanim.
+				 */
+				std::atomic<std::size_t> evaluated{ 0 };
+				/**
+				 * \brief Pocet posunuti vylucenych pred porovnanim pre zanedbatelne prekrytie.
+				 */
+				std::atomic<std::size_t> negligible{ 0 };
+				/**
+				 * \brief Pocet porovnani ukoncenych hornym odhadom podobnosti.
+				 */
+				std::atomic<std::size_t> bounded{ 0 };
+
+				/**
+				 * \brief Vynuluje pocitadla.
+				 */
+				void clear() { this->evaluated = 0; this->negligible = 0; this->bounded = 0; }
+			};
+
 		private:
+			/**
+			 * \brief Orientacne pole zarovnavaneho odtlacku otocene o jeden
+			 * zo skumanych uhlov.
+			 */
+			struct Rotation
+			{
+				/**
+				 * \brief Uhol otocenia v stupnoch.
+				 */
+				int angle;
+				/**
+				 * \brief Otocene a orezane lokalne orientacie, prazdne ak bolo otocenie
+				 * najdene vo vyrovnavacej pamati.
+				 */
+				cv::Mat orientations;
+				/**
+				 * \brief Blokova reprezentacia otocenych orientacii.
+				 */
+				processing::utils::storage::BlockField field;
+				/**
+				 * \brief Segmentacia otoceneho odtlacku.
+				 */
+				std::vector<cv::Point> identity;
+				/**
+				 * \brief Pocet blokov popredia otoceneho odtlacku.
+				 */
+				int blocks;
+			};
+			/**
+			 * \brief Cast prehladavania, jedno otocenie a obdlznik mriezky posunuti.
+			 */
+			struct Tile
+			{
+				/**
+				 * \brief Index otocenia.
+				 */
+				std::size_t rotation;
+				/**
+				 * \brief Prvy riadok posunuti.
+				 */
+				int top;
+				/**
+				 * \brief Riadok posunuti za poslednym spracovanym.
+				 */
+				int bottom;
+				/**
+				 * \brief Prvy stlpec posunuti.
+				 */
+				int left;
+				/**
+				 * \brief Stlpec posunuti za poslednym spracovanym.
+				 */
+				int right;
+				/**
+				 * \brief Krok v mriezke posunuti.
+				 */
+				int stride;
+			};
+			/**
+			 * \brief Najlepsie zarovnanie najdene v casti prehladavania.
+			 */
+			struct Candidate
+			{
+				/**
+				 * \brief Podobnost orientacii zarovnania.
+				 */
+				float similarity = .0f;
+				/**
+				 * \brief Index otocenia.
+				 */
+				std::size_t rotation = 0;
+				/**
+				 * \brief Posunutie zarovnaneho odtlacku voci odtlacku.
+				 */
+				cv::Point offset;
+			};
+
 			// members
 			/**
 			 * \brief Ovladac ziskavania informacii z odtlacku.
@@ -52,34 +162,197 @@ namespace morphing
 			 * \brief Zobrazenie prekrytej oblasti.
 			 */
 			bool showTranslatedArea = true;
+			/**
+			 * \brief Indikator paralelneho prehladavania otoceni a posunuti.
+			 */
+			bool parallelSearch = false;
+			/**
+			 * \brief Nasobok krokov a velkosti bloku hrubeho prehladavania,
+			 * hodnota 1 vypina hierarchicke prehladavanie.
+			 */
+			int coarseScale = 1;
+			/**
+			 * \brief Pocet najlepsich otoceni hrubeho prehladavania, ktore su
+			 * nasledne zjemnene.
+			 */
+			int coarseCandidates = 3;
+			/**
+			 * \brief Indikator prehladavania posunuti korelaciou blokovych poli pomocou FFT.
+			 */
+			bool correlationSearch = false;
+			/**
+			 * \brief Pocet najlepsich posunuti korelacie kazdeho otocenia, ktore su
+			 * nasledne ohodnotene priamym porovnanim.
+			 */
+			int correlationPeaks = 4;
+			/**
+			 * \brief Vyrovnavacia pamat otoceni zarovnavanych odtlackov, moze byt zdielana
+			 * viacerymi nastrojmi zarovnania.
+			 */
+			std::shared_ptr<RotationCache> rotationCache;
+			/**
+			 * \brief Indikator orezavania prehladavania hornym odhadom podobnosti (branch and bound).
+			 */
+			bool boundSearch = true;
+			/**
+			 * \brief Pocitadla prehladavania, ak su nastavene.
+			 */
+			std::shared_ptr<Statistics> statistics;
 
 			// static members
 			/**
 			 * \brief Pocet zobrazeni v ramci jedneho behu.
 			 */
-			static int displayed;
+			static std::atomic<int> displayed;
+			/**
+			 * \brief Pocet riadkov posunuti v jednej casti paralelneho prehladavania.
+			 */
+			static const int bandRows;
+			/**
+			 * \brief Rezerva horneho odhadu podobnosti voci zaokruhlovacim chybam.
+			 */
+			static const float boundTolerance;
 
 			// methods
 			/**
 			 * \brief Ohodnotenie podobnisti orientaci v zarovnani odtlackov.
-			 * \param af zarovnany odtlacok
-			 * \param f odtlaock
+			 * \param oa lokalne orientacie zarovnaneho odtlacku
+			 * \param o lokalne orientacie odtlacku
+			 * \param blockSize velkost bloku
+			 * \param stride krok v mriezke blokov
+			 * \param blocks pocet blokov, voci ktoremu sa posudzuje prekrytie
 			 * \param afPos pozicia zarovnaneho odtlacku
 			 * \param fPos pozicia odtlacku
 			 * \return ohodnotenie podobnisti orientacii v zarovnani
 			 */
-			float similarity(morphing::storage::AlignedFingerprint& af, processing::storage::Fingerprint& f, const cv::Point& afPos, const cv::Point& fPos) const;
+			float similarity(const cv::Mat& oa, const cv::Mat& o, int blockSize, int stride, int blocks, 
+				const cv::Point& afPos, const cv::Point& fPos) const;
+			/**
+			 * \brief Ohodnotenie podobnisti orientaci v zarovnani odtlackov nad blokovymi
+			 * reprezentaciami. Vysledok je zhodny s pixelovou verziou, ak pozicie odtlackov
+			 * lezia na hraniciach blokov. Po kazdom riadku blokov je podobnost zhora odhadnuta
+			 * tak, ako keby vsetky zostavajuce bloky popredia mali podobnost 1. Ak je odhad
+			 * mensi ako doteraz najlepsia podobnost, porovnanie skonci, lebo zarovnanie ju
+			 * nemoze prekonat.
+			 * \param oa bloky zarovnaneho odtlacku
+			 * \param o bloky odtlacku
+			 * \param stride krok v mriezke blokov
+			 * \param blocks pocet blokov, voci ktoremu sa posudzuje prekrytie
+			 * \param afPos pozicia zarovnaneho odtlacku
+			 * \param fPos pozicia odtlacku
+			 * \param incumbent doteraz najlepsia podobnost, 0 vypina odhad
+			 * \return ohodnotenie podobnisti orientacii v zarovnani, -1 ak je prekrytie zanedbatelne
+			 * alebo porovnanie skoncilo odhadom
+			 */
+			float similarity(const processing::utils::storage::BlockField& oa, const processing::utils::storage::BlockField& o, 
+				int stride, int blocks, const cv::Point& afPos, const cv::Point& fPos, float incumbent = .0f) const;
 			/**
 			 * \brief Skontroluje ci zarovnana oblast nie je zanedbatelna, na zaklade
 			 * prahu minimalneho prekrytia.
 			 * \param overlapped pocet blokov nachadzajucich sa v prekryti
-			 * \param af zarovnany odtlacok 
-			 * \param f odtlacok
+			 * \param blocks pocet blokov, voci ktoremu sa posudzuje prekrytie
 			 * \return indikator zanedbatelnosti
 			 */
-			bool negligibleArea(int overlapped, morphing::storage::AlignedFingerprint& af, processing::storage::Fingerprint& f) const;
+			bool negligibleArea(int overlapped, int blocks) const;
+			/**
+			 * \brief Otoci orientacne pole zarovnavaneho odtlacku o vsetky skumane uhly.
+			 * Ak je nastavena vyrovnavacia pamat a odtlacok ma nazov, otocenia su najprv
+			 * hladane v nej a pixelove orientacie najdenych otoceni ostavaju prazdne.
+			 * \param oa lokalne orientacie zarovnavaneho odtlacku
+			 * \param blockSize velkost bloku
+			 * \param name nazov zarovnavaneho odtlacku
+			 * \return otocenia v poradi od najmensieho uhla
+			 */
+			std::vector<Rotation> rotations(const cv::Mat& oa, int blockSize, const std::string& name) const;
+			/**
+			 * \brief Zisti rozmery mriezky posunuti otoceneho odtlacku voci odtlacku.
+			 * \param oarSize velkost otocenych lokalnych orientacii
+			 * \param fSize velkost odtlacku
+			 * \return pocet stlpcov a riadkov posunuti
+			 */
+			cv::Size translations(const cv::Size& oarSize, const cv::Size& fSize) const;
+			/**
+			 * \brief Rozdeli prehladavanie posunuti vsetkych otoceni na casti.
+			 * \param rotations otocenia
+			 * \param fSize velkost odtlacku
+			 * \param rows pocet riadkov posunuti v jednej casti
+			 * \param stride krok v mriezke posunuti
+			 * \return casti prehladavania v poradi seriovho prehladavania
+			 */
+			std::vector<Tile> tiles(const std::vector<Rotation>& rotations, const cv::Size& fSize, int rows, int stride = 1) const;
+			/**
+			 * \brief Pripravi casti zjemnenia okolo najlepsich zarovnani hrubeho
+			 * prehladavania.
+			 * \param rotations otocenia v plnom rozliseni
+			 * \param candidates najlepsie zarovnanie kazdeho hrubeho otocenia
+			 * \param fSize velkost odtlacku
+			 * \return casti prehladavania v poradi seriovho prehladavania
+			 */
+			std::vector<Tile> refinement(const std::vector<Rotation>& rotations, std::vector<Candidate> candidates, const cv::Size& fSize) const;
+			/**
+			 * \brief Prehlada vsetky casti, v paralelnom rezime rozdelene medzi vlakna.
+			 * \param tiles casti prehladavania
+			 * \param rotations otocenia
+			 * \param f odtlacok
+			 * \param field bloky odtlacku
+			 * \param blocks pocet blokov popredia odtlacku
+			 * \param scale krok v mriezke blokov
+			 * \param shared indikator zdielania najlepsej podobnosti medzi castami pri orezavani,
+			 * casti potom nevracaju svoje najlepsie zarovnanie, ale len celkovo najlepsie
+			 * zostava zachovane
+			 * \return najlepsie zarovnanie kazdej casti
+			 */
+			std::vector<Candidate> search(const std::vector<Tile>& tiles, const std::vector<Rotation>& rotations, 
+				const processing::storage::Fingerprint& f, const processing::utils::storage::BlockField& field, int blocks, int scale,
+				bool shared) const;
+			/**
+			 * \brief Najde najlepsie zarovnanie v jednej casti prehladavania.
+			 * \param tile cast prehladavania
+			 * \param rotation otocenie casti
+			 * \param f odtlacok
+			 * \param field bloky odtlacku
+			 * \param blocks pocet blokov popredia odtlacku
+			 * \param scale krok v mriezke blokov, pri hrubom prehladavani sa porovnava riedsia mriezka blokov
+			 * \param incumbent najlepsia podobnost zdielana castami, alebo nullptr
+			 * \return najlepsie zarovnanie casti
+			 */
+			Candidate search(const Tile& tile, const Rotation& rotation, const processing::storage::Fingerprint& f, 
+				const processing::utils::storage::BlockField& field, int blocks, int scale, std::atomic<float>* incumbent) const;
+			/**
+			 * \brief Prehlada posunutia vsetkych otoceni korelaciou blokovych poli. Najlepsie
+			 * posunutia korelacie kazdeho otocenia su ohodnotene priamym porovnanim.
+			 * \param rotations otocenia
+			 * \param f odtlacok
+			 * \param field bloky odtlacku
+			 * \param blocks pocet blokov popredia odtlacku
+			 * \return najlepsie zarovnanie kazdeho otocenia
+			 */
+			std::vector<Candidate> correlate(const std::vector<Rotation>& rotations, const processing::storage::Fingerprint& f, 
+				const processing::utils::storage::BlockField& field, int blocks) const;
 			
 			// static methods
+			/**
+			 * \brief Vyberie pocet blokov, voci ktoremu sa posudzuje prekrytie odtlackov.
+			 * \param afSize velkost lokalnych orientacii zarovnaneho odtlacku
+			 * \param afBlocks pocet blokov zarovnaneho odtlacku
+			 * \param fSize velkost lokalnych orientacii odtlacku
+			 * \param fBlocks pocet blokov odtlacku
+			 * \return pocet blokov
+			 */
+			static int referenceBlocks(const cv::Size& afSize, int afBlocks, const cv::Size& fSize, int fBlocks);
+			/**
+			 * \brief Zisti vzorkovane bloky prekrytia v blokovych poliach oboch odtlackov.
+			 * Pozicie odtlackov musia lezat na hraniciach blokov.
+			 * \param bb "2D bounding box" prekrytia
+			 * \param afPos pozicia zarovnaneho odtlacku
+			 * \param fPos pozicia odtlacku
+			 * \param blockSize velkost bloku
+			 * \param stride krok v mriezke blokov
+			 * \param afBlocks sem sa ulozi prvy blok a pocet vzorkovanych stlpcov a riadkov zarovnaneho odtlacku
+			 * \param fBlocks sem sa ulozi prvy blok a pocet vzorkovanych stlpcov a riadkov odtlacku
+			 */
+			static void overlapBlocks(const std::vector<cv::Point>& bb, const cv::Point& afPos, const cv::Point& fPos, int blockSize, 
+				int stride, cv::Rect& afBlocks, cv::Rect& fBlocks);
 			/**
 			 * \brief Otoci orientacne boli o x stupnov.
 			 * \param orientations lokalne orientacie
@@ -106,7 +379,12 @@ namespace morphing
 			void accurateAlign(morphing::storage::AlignedFingerprint& af, processing::storage::Fingerprint& f);
 			/**
 			 * \brief Zabezpeci zarovnanie dvoch odtlackov. Orientacne bole je vytiahnute z objektov odtlackov
-			 * a nasledne rotovane. 
+			 * a nasledne rotovane. V paralelnom rezime su casti prehladavania (otocenie a pas riadkov
+			 * posunuti) rozdelene medzi vlakna a ich vysledky zlucene v poradi seriovho prehladavania,
+			 * vysledok je preto zhodny so seriovym. V hierarchickom rezime je najprv prehladana riedka
+			 * mriezka otoceni a posunuti s vacsimi blokmi a v plnom rozliseni len okolie najlepsich otoceni.
+			 * V korelacnom rezime su posunutia kazdeho otocenia ohodnotene naraz pomocou FFT, ak
+			 * krok posunutia je nasobkom velkosti bloku, inak sa pouzije priame prehladavanie.
 			 * \param af zarovnany odtlacok
 			 * \param f odtlacok
 			 */
@@ -171,6 +449,15 @@ namespace morphing
 			float getTrashHold() const { return this->trashHold; }
 			bool isVerbose() const { return this->verboseOutput; }
 			bool displayCommonArea() const { return this->showTranslatedArea; }
+			bool isParallel() const { return this->parallelSearch; }
+			bool isHierarchical() const { return this->coarseScale > 1; }
+			int getCoarseScale() const { return this->coarseScale; }
+			int getCoarseCandidates() const { return this->coarseCandidates; }
+			bool isCorrelation() const { return this->correlationSearch; }
+			int getCorrelationPeaks() const { return this->correlationPeaks; }
+			std::shared_ptr<RotationCache> getRotationCache() const { return this->rotationCache; }
+			bool isBounded() const { return this->boundSearch; }
+			std::shared_ptr<Statistics> getStatistics() const { return this->statistics; }
 
 			// setters
 			FingerprintAligner& setTranslationStep(const int translationStep) { this->translationStep = translationStep; return *this; }
@@ -178,6 +465,14 @@ namespace morphing
 			FingerprintAligner& setTrashHold(const float trashHold) { this->trashHold = trashHold; return *this; }
 			FingerprintAligner& verbose(const bool verbose = true) { this->verboseOutput = verbose; return *this; }
 			FingerprintAligner& showCommonArea(const bool showTranslatedArea = true) { this->showTranslatedArea = showTranslatedArea; return *this; }
+			FingerprintAligner& parallel(const bool parallelSearch = true) { this->parallelSearch = parallelSearch; return *this; }
+			FingerprintAligner& setCoarseScale(const int coarseScale) { this->coarseScale = coarseScale; return *this; }
+			FingerprintAligner& setCoarseCandidates(const int coarseCandidates) { this->coarseCandidates = coarseCandidates; return *this; }
+			FingerprintAligner& correlation(const bool correlationSearch = true) { this->correlationSearch = correlationSearch; return *this; }
+			FingerprintAligner& setCorrelationPeaks(const int correlationPeaks) { this->correlationPeaks = correlationPeaks; return *this; }
+			FingerprintAligner& setRotationCache(const std::shared_ptr<RotationCache>& rotationCache) { this->rotationCache = rotationCache; return *this; }
+			FingerprintAligner& bound(const bool boundSearch = true) { this->boundSearch = boundSearch; return *this; }
+			FingerprintAligner& setStatistics(const std::shared_ptr<Statistics>& statistics) { this->statistics = statistics; return *this; }
 
 		};
 	}
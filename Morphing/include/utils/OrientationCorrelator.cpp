@@ -0,0 +1,116 @@
+#include "OrientationCorrelator.h"
+
+#include <cmath>
+
+using namespace morphing::utils;
+using namespace processing::utils::storage;
+using namespace cv;
+
+OrientationCorrelator::OrientationCorrelator(const BlockField& field, const Size& size)
+{
+	// linearna korelacia sa zmesti do cyklickej, ak je doplnena na sucet velkosti, posunutia
+	// tesne za okrajom prekrytia tak padnu do nuloveho pasu a nie na druhu stranu
+	this->padded = Size(
+		getOptimalDFTSize(size.width + field.getCols()),
+		getOptimalDFTSize(size.height + field.getRows())
+	);
+
+	Mat orientation, weighted, mask, weight;
+	encode(field, this->padded, orientation, weighted, mask, weight);
+
+	dft(orientation, this->orientationSpectrum);
+	dft(weighted, this->weightedSpectrum);
+	dft(mask, this->maskSpectrum);
+	dft(weight, this->weightSpectrum);
+}
+
+OrientationCorrelator::Correlation OrientationCorrelator::correlate(const BlockField& field) const
+{
+	Mat orientation, weighted, mask, weight;
+	encode(field, this->padded, orientation, weighted, mask, weight);
+
+	// maska ulozena do imaginarnej casti vah dava v jednej korelacii aj pocet prekrytych blokov
+	Mat weightMask(this->padded, CV_32FC2);
+	for (auto i = 0; i < this->padded.height; i++)
+	{
+		const auto* w = weight.ptr<Vec2f>(i);
+		const auto* m = mask.ptr<Vec2f>(i);
+		auto* wm = weightMask.ptr<Vec2f>(i);
+
+		for (auto j = 0; j < this->padded.width; j++)
+		{
+			wm[j] = Vec2f(w[j][0], m[j][0]);
+		}
+	}
+
+	dft(orientation, orientation);
+	dft(weighted, weighted);
+	dft(mask, mask);
+	dft(weightMask, weightMask);
+
+	// (r1 + r2) * cos(2 * (o1 - o2)) = Re(z1 * conj(r2 * z2)) + Re(r1 * z1 * conj(z2))
+	Mat numerator, product;
+	mulSpectrums(this->orientationSpectrum, weighted, numerator, 0, true);
+	mulSpectrums(this->weightedSpectrum, orientation, product, 0, true);
+	numerator += product;
+
+	// sucet vah v realnej casti, zaporny pocet prekrytych blokov v imaginarnej
+	Mat weights;
+	mulSpectrums(this->maskSpectrum, weightMask, weights, 0, true);
+	mulSpectrums(this->weightSpectrum, mask, product, 0, true);
+	weights += product;
+
+	dft(numerator, numerator, DFT_INVERSE | DFT_SCALE);
+	dft(weights, weights, DFT_INVERSE | DFT_SCALE);
+
+	return Correlation(numerator, weights);
+}
+
+void OrientationCorrelator::encode(const BlockField& field, const Size& padded, Mat& orientation, Mat& weighted, Mat& mask, Mat& weight)
+{
+	orientation = Mat::zeros(padded, CV_32FC2);
+	weighted = Mat::zeros(padded, CV_32FC2);
+	mask = Mat::zeros(padded, CV_32FC2);
+	weight = Mat::zeros(padded, CV_32FC2);
+
+	for (auto i = 0; i < field.getRows(); i++)
+	{
+		const auto* o = field.orientations(i);
+		const auto* r = field.weights(i);
+
+		auto* z = orientation.ptr<Vec2f>(i);
+		auto* wz = weighted.ptr<Vec2f>(i);
+		auto* m = mask.ptr<Vec2f>(i);
+		auto* w = weight.ptr<Vec2f>(i);
+
+		for (auto j = 0; j < field.getCols(); j++)
+		{
+			// pozadie nema orientaciu ani vahu
+			if (r[j] <= .0f)
+			{
+				continue;
+			}
+
+			const auto c = std::cos(2 * o[j]);
+			const auto s = std::sin(2 * o[j]);
+
+			z[j] = Vec2f(c, s);
+			wz[j] = Vec2f(r[j] * c, r[j] * s);
+			m[j] = Vec2f(1.0f, .0f);
+			w[j] = Vec2f(r[j], .0f);
+		}
+	}
+}
+
+float OrientationCorrelator::Correlation::at(const int dx, const int dy, float& nominator, int& overlapped) const
+{
+	// zaporne posunutia lezia cyklicky na konci
+	const auto i = dy < 0 ? dy + this->numerator.rows : dy;
+	const auto j = dx < 0 ? dx + this->numerator.cols : dx;
+
+	const auto& w = this->weights.at<Vec2f>(i, j);
+	nominator = w[0];
+	overlapped = cvRound(-w[1]);
+
+	return this->numerator.at<Vec2f>(i, j)[0];
+}
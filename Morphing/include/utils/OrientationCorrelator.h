@@ -0,0 +1,112 @@
+#pragma once
+
+#include <storage/BlockField.h>
+
+#include <opencv2/opencv.hpp>
+
+namespace morphing
+{
+	namespace utils
+	{
+		/**
+		 * \brief Vzajomna korelacia blokovych orientacnych poli pomocou FFT. Orientacie
+		 * su kodovane ako komplexne vektory s dvojnasobnym uhlom exp(2i * theta) a
+		 * maskou popredia, takze jedna korelacia dava pre vsetky posunutia naraz
+		 * sucet (r1 + r2) * cos(2 * (o1 - o2)), sucet vah a pocet prekrytych blokov.
+		 * Kosinusova podobnost je aproximaciou linearnej podobnosti 1 - 2|o1 - o2| / pi,
+		 * ktoru pouziva priame porovnanie.
+		 */
+		class OrientationCorrelator
+		{
+		public:
+			/**
+			 * \brief Sumy korelacie pre vsetky posunutia. Posunutie o (dx, dy) blokov
+			 * je ulozene cyklicky na pozicii (dy mod rows, dx mod cols).
+			 */
+			class Correlation
+			{
+			private:
+				// members
+				/**
+				 * \brief Sucet vahovanych kosinusovych podobnosti orientacii.
+				 */
+				cv::Mat numerator;
+				/**
+				 * \brief Sucet vah a zaporny pocet prekrytych blokov (realna a imaginarna cast).
+				 */
+				cv::Mat weights;
+
+			public:
+				// constructors
+				Correlation(const cv::Mat& numerator, const cv::Mat& weights) : numerator(numerator), weights(weights) {}
+
+				// methods
+				/**
+				 * \brief Precita sumy jedneho posunutia.
+				 * \param dx posunutie zarovnavaneho pola voci poli odtlacku v stlpcoch blokov
+				 * \param dy posunutie zarovnavaneho pola voci poli odtlacku v riadkoch blokov
+				 * \param nominator sem sa ulozi sucet vah
+				 * \param overlapped sem sa ulozi pocet prekrytych blokov
+				 * \return sucet vahovanych podobnosti orientacii
+				 */
+				float at(int dx, int dy, float& nominator, int& overlapped) const;
+			};
+
+		private:
+			// members
+			/**
+			 * \brief Velkost doplnenych poli, zabranuje prekryvu cyklickej korelacie.
+			 */
+			cv::Size padded;
+			/**
+			 * \brief Spektrum orientacii odtlacku s maskou popredia.
+			 */
+			cv::Mat orientationSpectrum;
+			/**
+			 * \brief Spektrum vahovanych orientacii odtlacku.
+			 */
+			cv::Mat weightedSpectrum;
+			/**
+			 * \brief Spektrum masky popredia odtlacku.
+			 */
+			cv::Mat maskSpectrum;
+			/**
+			 * \brief Spektrum vah odtlacku.
+			 */
+			cv::Mat weightSpectrum;
+
+			// static methods
+			/**
+			 * \brief Zakoduje blokove pole do doplnenych komplexnych rovin.
+			 * \param field bloky orientacneho pola
+			 * \param padded velkost doplnenych rovin
+			 * \param orientation sem sa ulozi exp(2i * theta) s maskou popredia
+			 * \param weighted sem sa ulozi vahovane exp(2i * theta)
+			 * \param mask sem sa ulozi maska popredia
+			 * \param weight sem sa ulozia vahy popredia
+			 */
+			static void encode(const processing::utils::storage::BlockField& field, const cv::Size& padded,
+				cv::Mat& orientation, cv::Mat& weighted, cv::Mat& mask, cv::Mat& weight);
+
+		public:
+			// constructors
+			/**
+			 * \brief Pripravi spektra pola odtlacku.
+			 * \param field bloky odtlacku
+			 * \param size najvacsia velkost korelovanych poli v blokoch
+			 */
+			OrientationCorrelator(const processing::utils::storage::BlockField& field, const cv::Size& size);
+
+			// methods
+			/**
+			 * \brief Koreluje zarovnavane pole s polom odtlacku.
+			 * \param field bloky zarovnavaneho pola, nie vacsie ako velkost zadana pri vytvoreni
+			 * \return sumy pre vsetky posunutia
+			 */
+			Correlation correlate(const processing::utils::storage::BlockField& field) const;
+
+			// getters
+			cv::Size getPadded() const { return this->padded; }
+		};
+	}
+}
@@ -0,0 +1,74 @@
+#include "RotationCache.h"
+
+using namespace morphing::utils;
+using namespace cv;
+
+bool RotationCache::find(const std::string& name, const int angle, const int blockSize, Entry& entry)
+{
+	std::lock_guard<std::mutex> guard(this->lock);
+
+	const auto found = this->index.find(Key(name, angle, blockSize));
+	if (found == this->index.end())
+	{
+		this->misses++;
+		return false;
+	}
+
+	// presun na zaciatok, najdlhsie nepouzity zaznam tak ostava na konci
+	this->entries.splice(this->entries.begin(), this->entries, found->second);
+	entry = found->second->second;
+	this->hits++;
+
+	return true;
+}
+
+void RotationCache::insert(const std::string& name, const int angle, const int blockSize, const Entry& entry)
+{
+	const auto size = footprint(entry);
+	if (size > this->budget)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> guard(this->lock);
+
+	// zaznam mohlo medzicasom vlozit ine vlakno
+	const Key key(name, angle, blockSize);
+	if (this->index.count(key) > 0)
+	{
+		return;
+	}
+
+	while (this->used + size > this->budget && !this->entries.empty())
+	{
+		const auto& last = this->entries.back();
+
+		this->used -= footprint(last.second);
+		this->index.erase(last.first);
+		this->entries.pop_back();
+	}
+
+	this->entries.emplace_front(key, entry);
+	this->index[key] = this->entries.begin();
+	this->used += size;
+}
+
+void RotationCache::clear()
+{
+	std::lock_guard<std::mutex> guard(this->lock);
+
+	this->entries.clear();
+	this->index.clear();
+	this->used = 0;
+	this->hits = 0;
+	this->misses = 0;
+}
+
+std::size_t RotationCache::footprint(const Entry& entry)
+{
+	// dve roviny blokov, tabulky suctov popredia a vah a segmentacia
+	return sizeof(Entry)
+		+ 2 * sizeof(float) * entry.field.getRows() * entry.field.getCols()
+		+ (sizeof(int) + sizeof(double)) * (entry.field.getRows() + 1) * (entry.field.getCols() + 1)
+		+ sizeof(Point) * entry.identity.size();
+}
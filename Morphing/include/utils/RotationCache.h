@@ -0,0 +1,129 @@
+#pragma once
+
+#include <storage/BlockField.h>
+
+#include <opencv2/opencv.hpp>
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace morphing
+{
+	namespace utils
+	{
+		/**
+		 * \brief Vyrovnavacia pamat otocenych orientacnych poli zarovnavanych odtlackov
+		 * zdielana medzi dvojicami a vlaknami. Pri prekroceni pamatoveho rozpoctu su
+		 * odstranene najdlhsie nepouzite zaznamy (LRU).
+		 */
+		class RotationCache
+		{
+		public:
+			/**
+			 * \brief Otocenie jedneho odtlacku o jeden uhol.
+			 */
+			struct Entry
+			{
+				/**
+				 * \brief Bloky otoceneho orientacneho pola.
+				 */
+				processing::utils::storage::BlockField field;
+				/**
+				 * \brief Segmentacia otoceneho odtlacku.
+				 */
+				std::vector<cv::Point> identity;
+				/**
+				 * \brief Pocet blokov popredia otoceneho odtlacku.
+				 */
+				int blocks = 0;
+			};
+
+		private:
+			/**
+			 * \brief Kluc zaznamu: nazov odtlacku, uhol a velkost bloku.
+			 */
+			using Key = std::tuple<std::string, int, int>;
+
+			// members
+			/**
+			 * \brief Pamatovy rozpocet v bajtoch.
+			 */
+			std::size_t budget;
+			/**
+			 * \brief Pamat obsadena zaznamami v bajtoch.
+			 */
+			std::size_t used = 0;
+			/**
+			 * \brief Zaznamy od naposledy pouziteho.
+			 */
+			std::list<std::pair<Key, Entry>> entries;
+			/**
+			 * \brief Index zaznamov podla kluca.
+			 */
+			std::map<Key, std::list<std::pair<Key, Entry>>::iterator> index;
+			/**
+			 * \brief Zamok zaznamov.
+			 */
+			mutable std::mutex lock;
+			/**
+			 * \brief Pocet najdenych zaznamov.
+			 */
+			std::atomic<std::size_t> hits{ 0 };
+			/**
+			 * \brief Pocet nenajdenych zaznamov.
+			 */
+			std::atomic<std::size_t> misses{ 0 };
+
+			// static methods
+			/**
+			 * \brief Odhadne pamat zaznamu.
+			 * \param entry zaznam
+			 * \return velkost zaznamu v bajtoch
+			 */
+			static std::size_t footprint(const Entry& entry);
+
+		public:
+			// constructors
+			/**
+			 * \param budget pamatovy rozpocet v bajtoch
+			 */
+			explicit RotationCache(std::size_t budget) : budget(budget) {}
+
+			// methods
+			/**
+			 * \brief Vyhlada otocenie odtlacku, najdeny zaznam sa stane naposledy pouzitym.
+			 * \param name nazov odtlacku
+			 * \param angle uhol otocenia
+			 * \param blockSize velkost bloku
+			 * \param entry sem sa ulozi najdeny zaznam
+			 * \return indikator najdenia zaznamu
+			 */
+			bool find(const std::string& name, int angle, int blockSize, Entry& entry);
+			/**
+			 * \brief Ulozi otocenie odtlacku a odstrani najdlhsie nepouzite zaznamy,
+			 * ktore sa do rozpoctu nezmestia. Zaznam vacsi ako cely rozpocet nie je ulozeny.
+			 * \param name nazov odtlacku
+			 * \param angle uhol otocenia
+			 * \param blockSize velkost bloku
+			 * \param entry zaznam
+			 */
+			void insert(const std::string& name, int angle, int blockSize, const Entry& entry);
+			/**
+			 * \brief Vyprazdni pamat a vynuluje pocitadla.
+			 */
+			void clear();
+
+			// getters
+			std::size_t getBudget() const { return this->budget; }
+			std::size_t getUsed() const { std::lock_guard<std::mutex> guard(this->lock); return this->used; }
+			std::size_t size() const { std::lock_guard<std::mutex> guard(this->lock); return this->entries.size(); }
+			std::size_t getHits() const { return this->hits; }
+			std::size_t getMisses() const { return this->misses; }
+		};
+	}
+}
@@ -0,0 +1,269 @@
+#include "SimilarityKernel.h"
+
+#include <opencv2/core/cvdef.h>
+
+#include <cmath>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+using namespace morphing::utils;
+
+namespace
+{
+	/**
+	 * \brief Skalarna verzia podobnosti orientacii, zaroven dopocitava zvysok
+	 * riadku za vektorovou castou.
+	 */
+	void orientationScalar(const float* o1, const float* r1, const float* o2, const float* r2,
+		const int begin, const int count, const int stride, SimilarityKernel::Orientation& sum)
+	{
+		for (auto i = begin; i < count; i++)
+		{
+			const auto m = i * stride;
+
+			if (r1[m] > .0f && r2[m] > .0f)
+			{
+				sum.overlapped++;
+
+				sum.numerator += (r1[m] + r2[m]) * static_cast<float>(1.0 - 2.0 * std::abs(o1[m] - o2[m]) / CV_PI);
+				sum.nominator += (r1[m] + r2[m]);
+			}
+		}
+	}
+
+	/**
+	 * \brief Skalarna verzia sumy pasu okolo reznej linie.
+	 */
+	void bandScalar(const cv::Vec3f& line, const float dmax, const float* x, const float* y,
+		const float* validity, const float* orientation, const float* frequency, const int begin, const int count,
+		SimilarityKernel::Band& sum)
+	{
+		const auto norm = std::sqrt(line[0] * line[0] + line[1] * line[1]);
+
+		for (auto i = begin; i < count; i++)
+		{
+			const auto d = std::abs(line[0] * x[i] + line[1] * y[i] + line[2]) / norm;
+
+			if (d <= dmax)
+			{
+				sum.orientation += validity[i] * orientation[i];
+				sum.validity += validity[i];
+				sum.frequency += frequency[i];
+				sum.blocks++;
+			}
+		}
+	}
+
+#if defined(__AVX512F__)
+	const int lanes = 16;
+
+	__m512 load(const float* p, const int i, const int stride, const __mmask16 mask)
+	{
+		if (stride == 1)
+		{
+			return _mm512_maskz_loadu_ps(mask, p + i);
+		}
+
+		const auto index = _mm512_mullo_epi32(
+			_mm512_add_epi32(_mm512_set1_epi32(i), _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15)),
+			_mm512_set1_epi32(stride));
+		return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, index, p, 4);
+	}
+
+	__mmask16 tail(const int remaining)
+	{
+		return remaining >= lanes ? static_cast<__mmask16>(0xFFFF) : static_cast<__mmask16>((1u << remaining) - 1);
+	}
+#elif defined(__AVX2__)
+	const int lanes = 8;
+
+	__m256 load(const float* p, const int i, const int stride)
+	{
+		if (stride == 1)
+		{
+			return _mm256_loadu_ps(p + i);
+		}
+
+		const auto index = _mm256_mullo_epi32(
+			_mm256_add_epi32(_mm256_set1_epi32(i), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)),
+			_mm256_set1_epi32(stride));
+		return _mm256_i32gather_ps(p, index, 4);
+	}
+
+	float horizontal(const __m256 v)
+	{
+		const auto half = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+		const auto quarter = _mm_add_ps(half, _mm_movehl_ps(half, half));
+		return _mm_cvtss_f32(_mm_add_ss(quarter, _mm_shuffle_ps(quarter, quarter, 1)));
+	}
+
+	int popcount(unsigned mask)
+	{
+		auto count = 0;
+		for (; mask; mask &= mask - 1)
+		{
+			count++;
+		}
+		return count;
+	}
+#endif
+}
+
+void SimilarityKernel::orientation(const float* o1, const float* r1, const float* o2, const float* r2,
+	const int count, const int stride, Orientation& sum)
+{
+#if defined(__AVX512F__)
+	const auto zero = _mm512_setzero_ps();
+	const auto one = _mm512_set1_ps(1.0f);
+	const auto scale = _mm512_set1_ps(static_cast<float>(2.0 / CV_PI));
+
+	auto numerator = zero;
+	auto nominator = zero;
+	auto overlapped = 0;
+
+	// posledna iteracia nacita iba zvysok riadku
+	for (auto i = 0; i < count; i += lanes)
+	{
+		const auto loaded = tail(count - i);
+
+		const auto w1 = load(r1, i, stride, loaded);
+		const auto w2 = load(r2, i, stride, loaded);
+		const auto mask = _mm512_cmp_ps_mask(w1, zero, _CMP_GT_OQ) & _mm512_cmp_ps_mask(w2, zero, _CMP_GT_OQ) & loaded;
+
+		const auto w = _mm512_add_ps(w1, w2);
+		const auto d = _mm512_abs_ps(_mm512_sub_ps(load(o1, i, stride, loaded), load(o2, i, stride, loaded)));
+		const auto s = _mm512_fnmadd_ps(d, scale, one);
+
+		numerator = _mm512_mask_add_ps(numerator, mask, numerator, _mm512_mul_ps(w, s));
+		nominator = _mm512_mask_add_ps(nominator, mask, nominator, w);
+		overlapped += _mm_popcnt_u32(mask);
+	}
+
+	sum.numerator += _mm512_reduce_add_ps(numerator);
+	sum.nominator += _mm512_reduce_add_ps(nominator);
+	sum.overlapped += overlapped;
+#elif defined(__AVX2__)
+	const auto zero = _mm256_setzero_ps();
+	const auto one = _mm256_set1_ps(1.0f);
+	const auto scale = _mm256_set1_ps(static_cast<float>(2.0 / CV_PI));
+	const auto sign = _mm256_set1_ps(-.0f);
+
+	auto numerator = zero;
+	auto nominator = zero;
+	auto overlapped = 0;
+
+	auto i = 0;
+	for (; i + lanes <= count; i += lanes)
+	{
+		const auto w1 = load(r1, i, stride);
+		const auto w2 = load(r2, i, stride);
+		const auto mask = _mm256_and_ps(_mm256_cmp_ps(w1, zero, _CMP_GT_OQ), _mm256_cmp_ps(w2, zero, _CMP_GT_OQ));
+
+		const auto w = _mm256_add_ps(w1, w2);
+		const auto d = _mm256_andnot_ps(sign, _mm256_sub_ps(load(o1, i, stride), load(o2, i, stride)));
+		const auto s = _mm256_sub_ps(one, _mm256_mul_ps(d, scale));
+
+		numerator = _mm256_add_ps(numerator, _mm256_and_ps(mask, _mm256_mul_ps(w, s)));
+		nominator = _mm256_add_ps(nominator, _mm256_and_ps(mask, w));
+		overlapped += popcount(static_cast<unsigned>(_mm256_movemask_ps(mask)));
+	}
+
+	sum.numerator += horizontal(numerator);
+	sum.nominator += horizontal(nominator);
+	sum.overlapped += overlapped;
+
+	orientationScalar(o1, r1, o2, r2, i, count, stride, sum);
+#else
+	orientationScalar(o1, r1, o2, r2, 0, count, stride, sum);
+#endif
+}
+
+void SimilarityKernel::band(const cv::Vec3f& line, const float dmax, const float* x, const float* y,
+	const float* validity, const float* orientation, const float* frequency, const int count, Band& sum)
+{
+#if defined(__AVX512F__)
+	const auto zero = _mm512_setzero_ps();
+	const auto a = _mm512_set1_ps(line[0]);
+	const auto b = _mm512_set1_ps(line[1]);
+	const auto c = _mm512_set1_ps(line[2]);
+	const auto norm = _mm512_set1_ps(std::sqrt(line[0] * line[0] + line[1] * line[1]));
+	const auto limit = _mm512_set1_ps(dmax);
+
+	auto o = zero;
+	auto w = zero;
+	auto v = zero;
+	auto blocks = 0;
+
+	for (auto i = 0; i < count; i += lanes)
+	{
+		const auto loaded = tail(count - i);
+
+		const auto px = _mm512_maskz_loadu_ps(loaded, x + i);
+		const auto py = _mm512_maskz_loadu_ps(loaded, y + i);
+		const auto d = _mm512_div_ps(_mm512_abs_ps(_mm512_fmadd_ps(a, px, _mm512_fmadd_ps(b, py, c))), norm);
+		const auto mask = _mm512_cmp_ps_mask(d, limit, _CMP_LE_OQ) & loaded;
+
+		const auto vi = _mm512_maskz_loadu_ps(mask, validity + i);
+		o = _mm512_mask_add_ps(o, mask, o, _mm512_mul_ps(vi, _mm512_maskz_loadu_ps(mask, orientation + i)));
+		w = _mm512_mask_add_ps(w, mask, w, vi);
+		v = _mm512_mask_add_ps(v, mask, v, _mm512_maskz_loadu_ps(mask, frequency + i));
+		blocks += _mm_popcnt_u32(mask);
+	}
+
+	sum.orientation += _mm512_reduce_add_ps(o);
+	sum.validity += _mm512_reduce_add_ps(w);
+	sum.frequency += _mm512_reduce_add_ps(v);
+	sum.blocks += blocks;
+#elif defined(__AVX2__)
+	const auto zero = _mm256_setzero_ps();
+	const auto a = _mm256_set1_ps(line[0]);
+	const auto b = _mm256_set1_ps(line[1]);
+	const auto c = _mm256_set1_ps(line[2]);
+	const auto norm = _mm256_set1_ps(std::sqrt(line[0] * line[0] + line[1] * line[1]));
+	const auto limit = _mm256_set1_ps(dmax);
+	const auto sign = _mm256_set1_ps(-.0f);
+
+	auto o = zero;
+	auto w = zero;
+	auto v = zero;
+	auto blocks = 0;
+
+	auto i = 0;
+	for (; i + lanes <= count; i += lanes)
+	{
+		const auto px = _mm256_loadu_ps(x + i);
+		const auto py = _mm256_loadu_ps(y + i);
+		const auto e = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a, px), _mm256_mul_ps(b, py)), c);
+		const auto d = _mm256_div_ps(_mm256_andnot_ps(sign, e), norm);
+		const auto mask = _mm256_cmp_ps(d, limit, _CMP_LE_OQ);
+
+		const auto vi = _mm256_loadu_ps(validity + i);
+		o = _mm256_add_ps(o, _mm256_and_ps(mask, _mm256_mul_ps(vi, _mm256_loadu_ps(orientation + i))));
+		w = _mm256_add_ps(w, _mm256_and_ps(mask, vi));
+		v = _mm256_add_ps(v, _mm256_and_ps(mask, _mm256_loadu_ps(frequency + i)));
+		blocks += popcount(static_cast<unsigned>(_mm256_movemask_ps(mask)));
+	}
+
+	sum.orientation += horizontal(o);
+	sum.validity += horizontal(w);
+	sum.frequency += horizontal(v);
+	sum.blocks += blocks;
+
+	bandScalar(line, dmax, x, y, validity, orientation, frequency, i, count, sum);
+#else
+	bandScalar(line, dmax, x, y, validity, orientation, frequency, 0, count, sum);
+#endif
+}
+
+const char* SimilarityKernel::instructionSet()
+{
+#if defined(__AVX512F__)
+	return "AVX-512";
+#elif defined(__AVX2__)
+	return "AVX2";
+#else
+	return "scalar";
+#endif
+}
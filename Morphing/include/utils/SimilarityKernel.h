@@ -0,0 +1,97 @@
+#pragma once
+
+#include <opencv2/core/matx.hpp>
+
+namespace morphing
+{
+	namespace utils
+	{
+		/**
+		 * \brief Vektorizovane jadra podobnosti orientacnych poli nad suvislymi
+		 * polami blokov. Podla cielovej instrukcnej sady pouziva AVX-512, AVX2,
+		 * alebo skalarnu verziu. Bloky, ktore nesplnaju podmienku (pozadie,
+		 * vzdialenost od linie), su z vysledku vylucene maskou.
+		 */
+		class SimilarityKernel
+		{
+		public:
+			/**
+			 * \brief Suma podobnosti orientacii prekrytia dvoch poli.
+			 */
+			struct Orientation
+			{
+				/**
+				 * \brief Sucet vahovanych podobnosti orientacii.
+				 */
+				float numerator = .0f;
+				/**
+				 * \brief Sucet vah.
+				 */
+				float nominator = .0f;
+				/**
+				 * \brief Pocet blokov v popredi oboch poli.
+				 */
+				int overlapped = 0;
+			};
+
+			/**
+			 * \brief Suma podobnosti blokov v pase okolo reznej linie.
+			 */
+			struct Band
+			{
+				/**
+				 * \brief Sucet vahovanych podobnosti orientacii.
+				 */
+				float orientation = .0f;
+				/**
+				 * \brief Sucet vah orientacii.
+				 */
+				float validity = .0f;
+				/**
+				 * \brief Sucet podobnosti frekvencii.
+				 */
+				float frequency = .0f;
+				/**
+				 * \brief Pocet blokov v pase.
+				 */
+				int blocks = 0;
+			};
+
+			// static methods
+			/**
+			 * \brief Pripocita podobnost orientacii jedneho riadku blokov. Podobnost
+			 * bloku je (r1 + r2) * (1 - 2|o1 - o2| / pi) a zapocita sa iba vtedy,
+			 * ked su vahy oboch blokov kladne.
+			 * \param o1 orientacie prveho pola
+			 * \param r1 vahy prveho pola
+			 * \param o2 orientacie druheho pola
+			 * \param r2 vahy druheho pola
+			 * \param count pocet porovnavanych blokov
+			 * \param stride krok medzi porovnavanymi blokmi
+			 * \param sum sem sa pripocita vysledok
+			 */
+			static void orientation(const float* o1, const float* r1, const float* o2, const float* r2,
+				int count, int stride, Orientation& sum);
+			/**
+			 * \brief Pripocita podobnosti blokov, ktore su od reznej linie vzdialene
+			 * najviac dmax.
+			 * \param line rezna linia (a, b, c)
+			 * \param dmax maximalna vzdialenost od linie
+			 * \param x x-ove suradnice stredov blokov
+			 * \param y y-ove suradnice stredov blokov
+			 * \param validity vahy orientacii blokov
+			 * \param orientation podobnosti orientacii blokov
+			 * \param frequency podobnosti frekvencii blokov
+			 * \param count pocet blokov
+			 * \param sum sem sa pripocita vysledok
+			 */
+			static void band(const cv::Vec3f& line, float dmax, const float* x, const float* y,
+				const float* validity, const float* orientation, const float* frequency, int count, Band& sum);
+			/**
+			 * \brief Instrukcna sada, pre ktoru boli jadra skompilovane.
+			 * \return nazov instrukcnej sady
+			 */
+			static const char* instructionSet();
+		};
+	}
+}
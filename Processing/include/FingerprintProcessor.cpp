@@ -9,11 +9,11 @@ using namespace processing::utils;
 using namespace processing;
 using namespace cv;
 
-std::string FingerprintProcessor::path = "C:\\Users\\Denis\\Desktop\\Results\\processing\\synthetic\\";
+std::string FingerprintProcessor::path = "Results/processing/";
 
-int FingerprintProcessor::displayed = 0;
-int FingerprintProcessor::displayedN = 0;
-int FingerprintProcessor::displayedE = 0;
+std::atomic<int> FingerprintProcessor::displayed(0);
+std::atomic<int> FingerprintProcessor::displayedN(0);
+std::atomic<int> FingerprintProcessor::displayedE(0);
 
 void FingerprintProcessor::display(const Mat& img, const std::string& trace) const
 {
@@ -21,7 +21,7 @@ void FingerprintProcessor::display(const Mat& img, const std::string& trace) con
 	imshow(ss.str(), img);
 }
 
-void FingerprintProcessor::correctOrientations(Fingerprint& fingerprint)
+void FingerprintProcessor::correctOrientations(Fingerprint& fingerprint) const
 {
 	auto o = fingerprint.getOrientations();
 	auto r = fingerprint.getRegionMask();
@@ -46,7 +46,7 @@ Fingerprint FingerprintProcessor::getFingerprint(const Mat& fingerprintImg)
 	return Fingerprint(fingerprintImg);
 }
 
-void FingerprintProcessor::estimateOrientations(Fingerprint& fingerprint, const bool verbose)
+void FingerprintProcessor::estimateOrientations(Fingerprint& fingerprint, const bool verbose) const
 {
 	const auto o = this->orientations.estimate(fingerprint.getNormalized());
 	fingerprint.setOrientations(o);
@@ -57,7 +57,36 @@ void FingerprintProcessor::estimateOrientations(Fingerprint& fingerprint, const
 	}
 }
 
-void FingerprintProcessor::applyRegionMask(Fingerprint& fingerprint, bool verbose)
+void FingerprintProcessor::preprocess(Fingerprint& fingerprint, const bool verbose) const
+{
+	Preprocessor::Workspace workspace;
+
+	this->preprocess(fingerprint, workspace, verbose);
+}
+
+void FingerprintProcessor::preprocess(Fingerprint& fingerprint, Preprocessor::Workspace& workspace, const bool verbose) const
+{
+	if (!this->fusedPreprocessing)
+	{
+		this->normalize(fingerprint, verbose);
+		this->estimateOrientations(fingerprint, verbose);
+		return;
+	}
+
+	const auto normalized = this->preprocessor.process(fingerprint, workspace);
+	fingerprint.setNormalized(normalized);
+
+	const auto o = this->orientations.estimateFromGradients(normalized, workspace.orientations);
+	fingerprint.setOrientations(o);
+
+	if (verbose)
+	{
+		this->displayNormalized(fingerprint, "preprocess");
+		this->displayOrientations(fingerprint, "preprocess");
+	}
+}
+
+void FingerprintProcessor::applyRegionMask(Fingerprint& fingerprint, bool verbose) const
 {
 	auto regionMask = fingerprint.getRegionMask();
 	const auto region = regionMask.getRegion();
@@ -116,17 +145,16 @@ void FingerprintProcessor::displayOrientations(const Fingerprint& fingerprint, c
 	this->orientations.display(fingerprint.getNormalized(), fingerprint.getOrientations(), trace, blank);
 }
 
-void FingerprintProcessor::estimateFrequencies(Fingerprint& fingerprint, const bool verbose)
+void FingerprintProcessor::estimateFrequencies(Fingerprint& fingerprint, const bool verbose) const
 {
-	const auto o = fingerprint.getOrientations();
-	this->frequencies.setOrientations(o);
+	FrequenciesEstimator::Workspace workspace(fingerprint.getOrientations());
 
-	const auto v = this->frequencies.estimate(fingerprint.getNormalized());
+	const auto v = this->frequencies.estimate(fingerprint.getNormalized(), workspace);
 	fingerprint
 		.setFrequencies(v)
-		.setMaxF(this->frequencies.getMaxFrequency())
-		.setMinF(this->frequencies.getMinFrequency())
-		.setRegionMask(this->frequencies.getRegionMask());
+		.setMaxF(workspace.maxF)
+		.setMinF(workspace.minF)
+		.setRegionMask(workspace.regionMask);
 
 	if (verbose)
 	{
@@ -134,7 +162,7 @@ void FingerprintProcessor::estimateFrequencies(Fingerprint& fingerprint, const b
 	}
 }
 
-void FingerprintProcessor::findMinutiaes(Fingerprint& fingerprint, const bool verbose)
+void FingerprintProcessor::findMinutiaes(Fingerprint& fingerprint, const bool verbose) const
 {
 	this->filterFingerprint(fingerprint);
 	binarize(fingerprint);
@@ -158,13 +186,13 @@ void FingerprintProcessor::handleFakeMinutiaes(Fingerprint& fingerprint) const
 {
 	auto minutiaes = fingerprint.getMinutiae();
 	
-	this->detector.find(fingerprint.getThinned(), minutiaes);
-	this->detector.remove(minutiaes);
+	const auto graph = this->detector.find(fingerprint.getThinned(), minutiaes);
+	this->detector.remove(minutiaes, graph);
 	
 	fingerprint.setMinutiae(minutiaes);
 }
 
-void FingerprintProcessor::findMinutiaesW(Fingerprint& fingerprint, const bool verbose)
+void FingerprintProcessor::findMinutiaesW(Fingerprint& fingerprint, const bool verbose) const
 {
 	thinning(fingerprint);
 	this->estimateMinutiaes(fingerprint);
@@ -182,19 +210,16 @@ void FingerprintProcessor::displayFrequencies(const Fingerprint& fingerprint, co
 	this->frequencies.display(fingerprint.getFrequencies(), trace);
 }
 
-void FingerprintProcessor::filterFingerprint(Fingerprint& fingerprint, const bool verbose)
+void FingerprintProcessor::filterFingerprint(Fingerprint& fingerprint, const bool verbose) const
 {
 	const auto o = fingerprint.getOrientations();
 	const auto v = fingerprint.getFrequencies();
 	const auto r = fingerprint.getRegionMask();
 	const auto b = r.idealGaborBlock();
 
-	this->filter
-		.setOrientationMap(o)
-		.setFrequencyMap(v)
-		.setBlockSize(b);
+	GaborFilter::Workspace workspace(o, v, b);
 
-	const auto filtered = this->filter.filter(fingerprint.getNormalized());
+	const auto filtered = this->filter.filter(fingerprint.getNormalized(), workspace);
 	fingerprint.setFiltered(filtered);
 
 	binarize(fingerprint);
@@ -239,51 +264,49 @@ void FingerprintProcessor::thinning(Fingerprint& fingerprint)
 	fingerprint.setThinned(thinned);
 }
 
-void FingerprintProcessor::estimateMinutiaes(Fingerprint& fingerprint, const bool verbose)
+void FingerprintProcessor::estimateMinutiaes(Fingerprint& fingerprint, const bool verbose) const
 {
 	const auto thinned = fingerprint.getThinned();
 
-	this->minutiaes
-		.setBlockSize(fingerprint.getBlockSize())
-		.setSegmentation(fingerprint.getOrientations());
+	MinutiaeEstimator::Workspace workspace(fingerprint.getOrientations(), fingerprint.getBlockSize());
 	
-	const auto minutiaes = this->minutiaes.estimate(thinned);
+	const auto minutiaes = this->minutiaes.estimate(thinned, workspace);
 	fingerprint
 		.setMinutiae(minutiaes)
-		.setMinutiaeTracking(this->minutiaes.geMinutiaeTracing());
+		.setMinutiaeTracking(workspace.tmp);
 }
 
-Mat FingerprintProcessor::getOrientationsImage(const Fingerprint& fingerprint)
+Mat FingerprintProcessor::getOrientationsImage(const Fingerprint& fingerprint) const
 {
 	return this->orientations.getOrientationImage(fingerprint.getNormalized(), fingerprint.getOrientations());
 }
 
-Mat FingerprintProcessor::getFrequenciesImage(const Fingerprint& fingerprint)
+Mat FingerprintProcessor::getFrequenciesImage(const Fingerprint& fingerprint) const
 {
 	return fingerprint.getFrequencies();
 }
 
-Mat FingerprintProcessor::getEnhancedImage(const Fingerprint& fingerprint)
+Mat FingerprintProcessor::getEnhancedImage(const Fingerprint& fingerprint) const
 {
 	return fingerprint.getBinarized();
 }
 
-Mat FingerprintProcessor::getThinnedImage(const Fingerprint& fingerprint)
+Mat FingerprintProcessor::getThinnedImage(const Fingerprint& fingerprint) const
 {
 	return fingerprint.getThinned();
 }
 
-Mat FingerprintProcessor::getMinutiaeTracing(const Fingerprint& fingerprint)
+Mat FingerprintProcessor::getMinutiaeTracing(const Fingerprint& fingerprint) const
 {
 	return fingerprint.getMinutiaeTracing();
 }
 
-Mat FingerprintProcessor::getMinutiaeImage(const Fingerprint& fingerprint)
+Mat FingerprintProcessor::getMinutiaeImage(const Fingerprint& fingerprint) const
 {
 	return this->minutiaes.getMinutiaeImage(fingerprint, fingerprint.getMinutiae());
 }
 
-Mat FingerprintProcessor::getMinutiaeImage(const Mat& fingerprint, const std::vector<Minutiae>& minutiae)
+Mat FingerprintProcessor::getMinutiaeImage(const Mat& fingerprint, const std::vector<Minutiae>& minutiae) const
 {
 	return this->minutiaes.getMinutiaeImage(fingerprint, minutiae);
 }
@@ -297,9 +320,9 @@ void FingerprintProcessor::displayThinned(const Fingerprint& fingerprint, const
 
 void FingerprintProcessor::displayMinutiaes(const Fingerprint& fingerprint, const std::string& trace) const
 {
-	const auto minutiaes = fingerprint.getMinutiae();
+	const auto& minutiaes = fingerprint.getMinutiae();
 	
-	this->minutiaes.display(fingerprint, minutiaes, trace);
+	this->minutiaes.display(fingerprint, minutiaes, fingerprint.getMinutiaeTracing(), trace);
 }
 
 void FingerprintProcessor::writeNormalized(const Fingerprint& fingerprint, const std::string& filename) const
@@ -318,37 +341,37 @@ void FingerprintProcessor::writeNormalized(const Fingerprint& fingerprint, const
 		}
 	}
 
-	std::stringstream ss; ss.str(""); ss << path << "1_normalized\\" << filename;
+	std::stringstream ss; ss.str(""); ss << path << "1_normalized/" << filename;
 	write(tmp, ss.str());
 }
 
 void FingerprintProcessor::writeOrientations(const Fingerprint& fingerprint, const std::string& filename) const
 {
-	std::stringstream ss; ss.str(""); ss << path << "2_orientations\\" << filename;
+	std::stringstream ss; ss.str(""); ss << path << "2_orientations/" << filename;
 	this->orientations.write(fingerprint.getNormalized(), fingerprint.getOrientations(), ss.str());
 }
 
 void FingerprintProcessor::writeFrequencies(const Fingerprint& fingerprint, const std::string& filename) const
 {
-	std::stringstream ss; ss.str(""); ss << path << "frequencies\\" << filename;
+	std::stringstream ss; ss.str(""); ss << path << "frequencies/" << filename;
 	this->frequencies.write(fingerprint.getFrequencies(), ss.str());
 }
 
 void FingerprintProcessor::writeEnhanced(const Fingerprint& fingerprint, const std::string& filename) const
 {
-	std::stringstream ss; ss.str(""); ss << path << "3_enhanced\\" << filename;
+	std::stringstream ss; ss.str(""); ss << path << "3_enhanced/" << filename;
 	write(fingerprint.getBinarized(), ss.str());
 }
 
 void FingerprintProcessor::writeThinning(const Fingerprint& fingerprint, const std::string& filename) const
 {
-	std::stringstream ss; ss.str(""); ss << path << "5_thinning\\" << filename;
+	std::stringstream ss; ss.str(""); ss << path << "5_thinning/" << filename;
 	write(fingerprint.getThinned(), ss.str());
 }
 
 void FingerprintProcessor::writeMinutiaes(const Fingerprint& fingerprint, const std::string& filename) const
 {
-	this->minutiaes.write(fingerprint, fingerprint.getMinutiae(), path, filename);
+	this->minutiaes.write(fingerprint, fingerprint.getMinutiae(), fingerprint.getMinutiaeTracing(), path, filename);
 }
 
 void FingerprintProcessor::write(const Mat& img, const std::string& path)
@@ -5,7 +5,9 @@
 #include "utils/GaborFilter.h"
 #include "utils/MinutiaeEstimator.h"
 #include "utils/FakeMinutiaeDetector.h"
+#include "utils/Preprocessor.h"
 
+#include <atomic>
 #include <string>
 	
 namespace processing
@@ -43,20 +45,28 @@ namespace processing
 		 * \brief Nastroj na odfiltrovanie falosnych markantov
 		 */
 		utils::FakeMinutiaeDetector detector;
+		/**
+		 * \brief Nastroj na spojene predspracovanie odtlacku.
+		 */
+		utils::Preprocessor preprocessor;
+		/**
+		 * \brief Indikator spojeneho predspracovania v preprocess.
+		 */
+		bool fusedPreprocessing = false;
 
 		// static members
 		/**
 		 * \brief Pocet zobrazeni v jednom behu.
 		 */
-		static int displayed;
+		static std::atomic<int> displayed;
 		/**
 		 * \brief Pocet zobrazeni normalizovaneho odtlacku v jednom behu.
 		 */
-		static int displayedN;
+		static std::atomic<int> displayedN;
 		/**
 		 * \brief Pocet zobrazi vylepseneho odtlacku v jednom behu.
 		 */
-		static int displayedE;
+		static std::atomic<int> displayedE;
 
 		// methods
 		/**
@@ -69,7 +79,7 @@ namespace processing
 		 * \brief Prida k orientaciam informaciu o regione.
 		 * \param fingerprint odtlacok
 		 */
-		void correctOrientations(storage::Fingerprint& fingerprint);
+		void correctOrientations(storage::Fingerprint& fingerprint) const;
 		
 	public:
 		// static members
@@ -94,26 +104,41 @@ namespace processing
 		 * \param fingerprint odtlacok
 		 * \param verbose kontrolny vystup
 		 */
-		void estimateOrientations(storage::Fingerprint& fingerprint, bool verbose = false);
+		void estimateOrientations(storage::Fingerprint& fingerprint, bool verbose = false) const;
+		/**
+		 * \brief Zmenezuje normalizaciu a odhad orientacii. Pri spojenom predspracovani
+		 * su normalizovany odtlacok a gradienty vypocitane v jednom priechode.
+		 * \param fingerprint odtlacok
+		 * \param verbose kontrolny vystup
+		 */
+		void preprocess(storage::Fingerprint& fingerprint, bool verbose = false) const;
+		/**
+		 * \brief Zmenezuje normalizaciu a odhad orientacii nad pracovnymi datami volajuceho,
+		 * ktore mozu byt znovu pouzite pre dalsie odtlacky.
+		 * \param fingerprint odtlacok
+		 * \param workspace pracovne data predspracovania
+		 * \param verbose kontrolny vystup
+		 */
+		void preprocess(storage::Fingerprint& fingerprint, utils::Preprocessor::Workspace& workspace, bool verbose = false) const;
 		/**
 		 * \brief Zmenezuje extrakciu frekvencii.
 		 * \param fingerprint odtlacok
 		 * \param verbose kontrolny vystup
 		 */
-		void estimateFrequencies(storage::Fingerprint& fingerprint, bool verbose = false);
+		void estimateFrequencies(storage::Fingerprint& fingerprint, bool verbose = false) const;
 		/**
 		 * \brief Aplikuje regionalnu masku na extrahovane vlastnosti.
 		 * \param fingerprint odtlacok
 		 * \param verbose kontrolny vystup
 		 */
-		void applyRegionMask(storage::Fingerprint& fingerprint, bool verbose = false);
+		void applyRegionMask(storage::Fingerprint& fingerprint, bool verbose = false) const;
 		/**
 		 * \brief Zmenezuje identifikaciu markantov. Zahrna aj vsetky kroky od vylepsenia
 		 * kvality.
 		 * \param fingerprint odtlacok
 		 * \param verbose kontrolny vystup
 		 */
-		void findMinutiaes(storage::Fingerprint& fingerprint, bool verbose = false);
+		void findMinutiaes(storage::Fingerprint& fingerprint, bool verbose = false) const;
 		/**
 		 * \brief Zmenezuje odfiltrovanie falosnych markantov.
 		 * \param fingerprint odtlacok
@@ -124,14 +149,14 @@ namespace processing
 		 * \param fingerprint odtlacok
 		 * \param verbose kontrolny vystup
 		 */
-		void findMinutiaesW(storage::Fingerprint& fingerprint, bool verbose = false);
+		void findMinutiaesW(storage::Fingerprint& fingerprint, bool verbose = false) const;
 		
 		/**
 		 * \brief Zmenezuje vylepsenie kvality odtlacku.
 		 * \param fingerprint odtlacok
 		 * \param verbose kontrolny vystup 
 		 */
-		void filterFingerprint(storage::Fingerprint& fingerprint, bool verbose = false);
+		void filterFingerprint(storage::Fingerprint& fingerprint, bool verbose = false) const;
 		/**
 		 * \brief Zmenezuje binarizaciu odtlacku.
 		 * \param fingerprint odtlacok
@@ -147,19 +172,19 @@ namespace processing
 		 * \param fingerprint odtlacok
 		 * \param verbose kontrolny vystup
 		 */
-		void estimateMinutiaes(storage::Fingerprint& fingerprint, bool verbose = false);
+		void estimateMinutiaes(storage::Fingerprint& fingerprint, bool verbose = false) const;
 
 		/*
 		 * Metody zmenezuju ziskanie obrazkov extrahovanych informacii.
 		 * Prevolanie je intuitivne podla nazvov metod vzhladom na clenov triedy.
 		 */
-		cv::Mat getOrientationsImage(const storage::Fingerprint& fingerprint);
-		cv::Mat getFrequenciesImage(const storage::Fingerprint& fingerprint);
-		cv::Mat getEnhancedImage(const storage::Fingerprint& fingerprint);
-		cv::Mat getThinnedImage(const storage::Fingerprint& fingerprint);
-		cv::Mat getMinutiaeImage(const storage::Fingerprint& fingerprint);
-		cv::Mat getMinutiaeImage(const cv::Mat& fingerprint, const std::vector<utils::storage::Minutiae>& minutiae);
-		cv::Mat getMinutiaeTracing(const storage::Fingerprint& fingerprint);
+		cv::Mat getOrientationsImage(const storage::Fingerprint& fingerprint) const;
+		cv::Mat getFrequenciesImage(const storage::Fingerprint& fingerprint) const;
+		cv::Mat getEnhancedImage(const storage::Fingerprint& fingerprint) const;
+		cv::Mat getThinnedImage(const storage::Fingerprint& fingerprint) const;
+		cv::Mat getMinutiaeImage(const storage::Fingerprint& fingerprint) const;
+		cv::Mat getMinutiaeImage(const cv::Mat& fingerprint, const std::vector<utils::storage::Minutiae>& minutiae) const;
+		cv::Mat getMinutiaeTracing(const storage::Fingerprint& fingerprint) const;
 		
 		/*
 		 * Metody zmenezuju volanie metod inych objektov.
@@ -200,5 +225,11 @@ namespace processing
 		 */
 		static storage::Fingerprint getFingerprint(const cv::Mat& fingerprintImg);
 
+		// getters
+		bool usesFusedPreprocessing() const { return this->fusedPreprocessing; }
+
+		// setters
+		FingerprintProcessor& useFusedPreprocessing(const bool use = true) { this->fusedPreprocessing = use; return *this; }
+
 	};
 }
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace processing
+{
+	namespace utils
+	{
+		namespace storage
+		{
+			/**
+			 * \brief Blokova reprezentacia orientacneho pola. Pre kazdy blok uchovava
+			 * orientaciu a vahu (region) zo stredu bloku, teda presne hodnoty, ktore
+			 * porovnavanie orientacii vzorkuje z pixeloveho pola. Orientacie a vahy
+			 * su ulozene v dvoch samostatnych suvislych poliach po riadkoch blokov.
+			 */
+			class BlockField
+			{
+			private:
+				// members
+				/**
+				 * \brief Velkost bloku.
+				 */
+				int blockSize = 0;
+				/**
+				 * \brief Pocet riadkov blokov.
+				 */
+				int rows = 0;
+				/**
+				 * \brief Pocet stlpcov blokov.
+				 */
+				int cols = 0;
+				/**
+				 * \brief Velkost pixeloveho pola, z ktoreho boli bloky vzorkovane.
+				 */
+				cv::Size size;
+				/**
+				 * \brief Orientacie blokov.
+				 */
+				std::vector<float> orientationPlane;
+				/**
+				 * \brief Vahy (region) blokov, nulova vaha oznacuje pozadie.
+				 */
+				std::vector<float> weightPlane;
+				/**
+				 * \brief Tabulka suctov (summed-area table) blokov popredia s rozmermi
+				 * (rows + 1) x (cols + 1).
+				 */
+				std::vector<int> foregroundTable;
+				/**
+				 * \brief Tabulka suctov vah blokov popredia s rozmermi (rows + 1) x (cols + 1).
+				 */
+				std::vector<double> weightTable;
+
+			public:
+				// constructors
+				BlockField() = default;
+				/**
+				 * \brief Vzorkuje pixelove orientacne pole (CV_32FC2, orientacia a region)
+				 * v strednych bodoch blokov.
+				 * \param orientations lokalne orientacie
+				 * \param blockSize velkost bloku
+				 */
+				BlockField(const cv::Mat& orientations, int blockSize);
+
+				// methods
+				/**
+				 * \brief Zisti pocet blokov popredia.
+				 * \param stride krok v mriezke blokov
+				 * \return pocet blokov popredia
+				 */
+				int blocks(int stride = 1) const;
+				/**
+				 * \brief Zisti pocet blokov popredia v obdlzniku blokov v konstantnom case.
+				 * Obdlznik je orezany na rozmery pola.
+				 * \param top prvy riadok
+				 * \param left prvy stlpec
+				 * \param bottom riadok za poslednym
+				 * \param right stlpec za poslednym
+				 * \return pocet blokov popredia
+				 */
+				int foreground(int top, int left, int bottom, int right) const;
+				/**
+				 * \brief Zisti sucet vah blokov popredia v obdlzniku blokov v konstantnom case.
+				 * Obdlznik je orezany na rozmery pola.
+				 * \param top prvy riadok
+				 * \param left prvy stlpec
+				 * \param bottom riadok za poslednym
+				 * \param right stlpec za poslednym
+				 * \return sucet vah
+				 */
+				double weight(int top, int left, int bottom, int right) const;
+				/**
+				 * \brief Orientacie jedneho riadku blokov.
+				 * \param row riadok blokov
+				 * \return ukazovatel na prvy blok riadku
+				 */
+				const float* orientations(const int row) const { return this->orientationPlane.data() + row * this->cols; }
+				/**
+				 * \brief Vahy jedneho riadku blokov.
+				 * \param row riadok blokov
+				 * \return ukazovatel na prvy blok riadku
+				 */
+				const float* weights(const int row) const { return this->weightPlane.data() + row * this->cols; }
+
+				// getters
+				int getBlockSize() const { return this->blockSize; }
+				int getRows() const { return this->rows; }
+				int getCols() const { return this->cols; }
+				cv::Size getSize() const { return this->size; }
+				bool empty() const { return this->orientationPlane.empty(); }
+			};
+		}
+	}
+}
+
+inline processing::utils::storage::BlockField::BlockField(const cv::Mat& orientations, const int blockSize)
+	: blockSize(blockSize), size(orientations.size())
+{
+	if (blockSize <= 0 || orientations.empty() || orientations.type() != CV_32FC2)
+	{
+		return;
+	}
+
+	// pocet stredov blokov vo vnutri pola
+	this->rows = orientations.rows > blockSize / 2 ? (orientations.rows - blockSize / 2 - 1) / blockSize + 1 : 0;
+	this->cols = orientations.cols > blockSize / 2 ? (orientations.cols - blockSize / 2 - 1) / blockSize + 1 : 0;
+
+	this->orientationPlane.resize(this->rows * this->cols);
+	this->weightPlane.resize(this->rows * this->cols);
+	this->foregroundTable.assign((this->rows + 1) * (this->cols + 1), 0);
+	this->weightTable.assign((this->rows + 1) * (this->cols + 1), .0);
+
+	for (auto i = 0; i < this->rows; i++)
+	{
+		const auto* row = orientations.ptr<cv::Vec2f>(blockSize / 2 + i * blockSize);
+
+		for (auto j = 0; j < this->cols; j++)
+		{
+			const auto& block = row[blockSize / 2 + j * blockSize];
+
+			this->orientationPlane[i * this->cols + j] = block[0];
+			this->weightPlane[i * this->cols + j] = block[1];
+		}
+	}
+
+	const auto stride = this->cols + 1;
+	for (auto i = 0; i < this->rows; i++)
+	{
+		const auto* weights = this->weights(i);
+
+		for (auto j = 0; j < this->cols; j++)
+		{
+			this->foregroundTable[(i + 1) * stride + j + 1] = (weights[j] > .0f ? 1 : 0)
+				+ this->foregroundTable[i * stride + j + 1]
+				+ this->foregroundTable[(i + 1) * stride + j]
+				- this->foregroundTable[i * stride + j];
+			this->weightTable[(i + 1) * stride + j + 1] = (weights[j] > .0f ? weights[j] : .0)
+				+ this->weightTable[i * stride + j + 1]
+				+ this->weightTable[(i + 1) * stride + j]
+				- this->weightTable[i * stride + j];
+		}
+	}
+}
+
+inline int processing::utils::storage::BlockField::blocks(const int stride) const
+{
+	auto blocks = 0;
+	for (auto i = 0; i < this->rows; i += stride)
+	{
+		const auto* weights = this->weights(i);
+
+		for (auto j = 0; j < this->cols; j += stride)
+		{
+			if (weights[j] > .0f)
+			{
+				blocks++;
+			}
+		}
+	}
+
+	return blocks;
+}
+
+inline int processing::utils::storage::BlockField::foreground(int top, int left, int bottom, int right) const
+{
+	top = std::max(top, 0);
+	left = std::max(left, 0);
+	bottom = std::min(bottom, this->rows);
+	right = std::min(right, this->cols);
+
+	if (top >= bottom || left >= right)
+	{
+		return 0;
+	}
+
+	const auto stride = this->cols + 1;
+	return this->foregroundTable[bottom * stride + right] - this->foregroundTable[top * stride + right]
+		- this->foregroundTable[bottom * stride + left] + this->foregroundTable[top * stride + left];
+}
+
+inline double processing::utils::storage::BlockField::weight(int top, int left, int bottom, int right) const
+{
+	top = std::max(top, 0);
+	left = std::max(left, 0);
+	bottom = std::min(bottom, this->rows);
+	right = std::min(right, this->cols);
+
+	if (top >= bottom || left >= right)
+	{
+		return .0;
+	}
+
+	const auto stride = this->cols + 1;
+	return this->weightTable[bottom * stride + right] - this->weightTable[top * stride + right]
+		- this->weightTable[bottom * stride + left] + this->weightTable[top * stride + left];
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "storage/BlockField.h"
 #include "storage/Minutiae.h"
 #include "storage/RegionMask.h"
 
@@ -117,8 +118,9 @@ namespace processing
 			int getBlockSize() const { return this->blockSize; }
 			int getWindowsSize() const { return this->windowSize; }
 			bool isEnhanced() const { return this->enhanced; }
-			std::vector<utils::storage::Minutiae> getMinutiae() const { return this->minutiaes; }
+			const std::vector<utils::storage::Minutiae>& getMinutiae() const { return this->minutiaes; }
 			int getBlocks();
+			utils::storage::BlockField getBlockField() const { return utils::storage::BlockField(this->orientations, this->blockSize); }
 			float getMaxF() const { return this->maxF; }
 			float getMinF() const { return this->minF; }
 			float getTrashHold() const { return this->trashHold; }
@@ -155,26 +157,37 @@ inline void processing::storage::Fingerprint::clear()
 
 	this->enhanced = false;
 
-	this->normalized = Mat(10, 10, CV_32F);
-	this->segmentation = Mat(10, 10, CV_32F);
-	this->orientations = Mat(10, 10, CV_32F);
-	this->frequencies = Mat(10, 10, CV_32F);
-	this->thinned = Mat(10, 10, CV_32F);
-	this->filtered = Mat(10, 10, CV_32F);
-	this->binarized = Mat(10, 10, CV_32F);
+	// uvolnenie bez zastupnych matic, buffre sa mozu vratit do alokatora
+	this->normalized.release();
+	this->segmentation.release();
+	this->orientations.release();
+	this->frequencies.release();
+	this->thinned.release();
+	this->filtered.release();
+	this->binarized.release();
+	this->minutiaeTracing.release();
 	this->minutiaes = std::vector<utils::storage::Minutiae>();
 
-	this->regionMask = processing::utils::RegionMask(Mat(10, 10, CV_32F));
+	this->regionMask = processing::utils::RegionMask();
 }
 
 inline int processing::storage::Fingerprint::getBlocks()
 {
 	if (this->blocks == 0 && this->orientations.size().height > 0)
 	{
+		// iba vahy v strede blokov, bez skladania celeho blokoveho pola
 		for (auto i = this->blockSize / 2; i < this->orientations.rows; i += this->blockSize)
+		{
+			const auto* row = this->orientations.ptr<cv::Vec2f>(i);
+
 			for (auto j = this->blockSize / 2; j < this->orientations.cols; j += this->blockSize)
-				if (this->orientations.at<cv::Vec2f>(i, j)[1] > .0f)
+			{
+				if (row[j][1] > .0f)
+				{
 					this->blocks++;
+				}
+			}
+		}
 	}
 
 	return this->blocks;
@@ -2,20 +2,33 @@
 
 #include <opencv2/opencv.hpp>
 
+#include <cstdint>
+#include <type_traits>
+
 namespace processing
 {
 	namespace utils
 	{
 		namespace storage
 		{
+			/**
+			 * \brief Kompaktny zaznam markantu (16 bajtov) ulozitelny v suvislom poli.
+			 * Vztahy falosnych struktur medzi markantmi su ulozene oddelene v grafe
+			 * markantov indexovanom poradim markantu, kopia markantu tak nekopiruje
+			 * ziadne dalsie markanty.
+			 */
 			class Minutiae
 			{
 			private:
 				// members
 				/**
-				 * \brief Pozicia markantu.
+				 * \brief x-ova pozicia markantu.
+				 */
+				std::int16_t x = 0;
+				/**
+				 * \brief y-ova pozicia markantu.
 				 */
-				cv::Point position;
+				std::int16_t y = 0;
 				/**
 				 * \brief Smer markantu.
 				 */
@@ -27,230 +40,64 @@ namespace processing
 				/**
 				 * \brief Typ markantu.
 				 */
-				int type = NONE;
-				/**
-				 * \brief Indikator falosnosti.
-				 */
-				bool fake = false;
+				std::int8_t type = NONE;
 				/**
-				 * \brief Definicia falosnej strukury proti sebe stojacich markantov.
+				 * \brief Priznaky markantu.
 				 */
-				std::map<int, std::vector<Minutiae>> facingPairs{ { Type::TERMINATION, std::vector<Minutiae>() }, { Type::BIFURCATION, std::vector<Minutiae>() } };
-				/**
-				 * \brief Definicia falosnej struktury prepojenych markantov.
-				 */
-				std::map<int, std::vector<Minutiae>> connectedPairs{ { Type::TERMINATION, std::vector<Minutiae>() }, { Type::BIFURCATION, std::vector<Minutiae>() } };
-				
+				std::uint8_t flags = 0;
+
 			public:
 				enum Type { NONE = -1, BIFURCATION = 1, TERMINATION };
+				enum Flag { FAKE = 1 };
 
 				// constructors
 				Minutiae() = default;
-				Minutiae(cv::Point& position, const float direction, const float threshold, const int type)
-					: position(position), direction(direction), threshold(threshold), type(type) {}
+				Minutiae(const cv::Point& position, const float direction, const float threshold, const int type)
+					: x(static_cast<std::int16_t>(position.x)), y(static_cast<std::int16_t>(position.y)),
+					direction(direction), threshold(threshold), type(static_cast<std::int8_t>(type)) {}
 
 				// methods
-				/**
-				 * \brief Zisti ci by mohol byt markant falosny na zaklade obsihnutych dat.
-				 * \return falosnost markantu
-				 */
-				bool canBeFake();
 				/**
 				 * \brief Zisti uhol voci inemu markantu.
 				 * \param m iny markant
 				 * \return uhol
 				 */
 				float betaValueWith(const Minutiae& m) const;
-				/**
-				 * \brief Zisti ci je markant vydlicova struktura.
-				 * \return ci je vidlicova struktura
-				 */
-				bool isFork();
-				/**
-				 * \brief Zisti ci je struktura Bur.
-				 * \return ci je struktura Bur
-				 */
-				bool isBur();
-				/**
-				 * \brief Prida proti sebe stojaci markant do informacii o falosnej
-				 * strukture, na zaklade typu markantu predavaneho parametrom.
-				 * \param minutiae 
-				 * \return referenciu na this
-				 */
-				Minutiae& addN(const Minutiae& minutiae);
-				/**
-				 * \brief Prida prepojeny markant do informacii o falosnej
-				 * strukture, na zaklade typu markantu predavaneho parametrom.
-				 * \param minutiae
-				 * \return referenciu na this
-				 */
-				Minutiae& addC(const Minutiae& minutiae);
-				/**
-				 * \brief Odoberie proti sebe stojaci markant z informacii o falosnej
-				 * strukture, na zaklade typu markantu predavaneho parametrom.
-				 * \param minutiae
-				 * \return referenciu na this
-				 */
-				Minutiae& stripN(const Minutiae& minutiae);
-				/**
-				 * \brief Odoberie prepojeny markant z informacii o falosnej
-				 * strukture, na zaklade typu markantu predavaneho parametrom.
-				 * \param minutiae
-				 * \return referenciu na this
-				 */
-				Minutiae& stripC(const Minutiae& minutiae);
-				/**
-				 * \brief Odoberie markant z mapy.
-				 * \param map mapa
-				 * \param minutiae markant
-				 */
-				void strip(std::map<int, std::vector<Minutiae>>& map, const Minutiae& minutiae) const;
-				
+
 				// getters
-				cv::Point getPosition() const { return this->position; }
+				cv::Point getPosition() const { return cv::Point(this->x, this->y); }
 				float getDirection() const { return this->direction; }
 				int getType() const { return this->type; }
-				bool isFake() const { return this->fake; }
+				bool isFake() const { return (this->flags & Flag::FAKE) != 0; }
 				float getThreshold() const { return this->threshold; }
-				int getN(const int type) { return this->facingPairs[type].size(); }
-				int getC(const int type) { return this->connectedPairs[type].size(); }
-				std::vector<Minutiae> getFacing(const int type) { return this->facingPairs[type]; }
-				std::vector<Minutiae> getConnected(const int type) { return this->connectedPairs[type]; }
-				
+
 				// setters
-				Minutiae& setPosition(const cv::Point& position) { this->position = position; return *this; }
+				Minutiae& setPosition(const cv::Point& position) { this->x = static_cast<std::int16_t>(position.x); this->y = static_cast<std::int16_t>(position.y); return *this; }
 				Minutiae& setDirection(const float direction) { this->direction = direction; return *this; }
-				Minutiae& setType(const int type) { this->type = type; return *this; }
-				Minutiae& setFake(const bool fake = true) { this->fake = fake; return *this; }
+				Minutiae& setType(const int type) { this->type = static_cast<std::int8_t>(type); return *this; }
+				Minutiae& setFake(const bool fake = true) { this->flags = fake ? (this->flags | Flag::FAKE) : (this->flags & ~Flag::FAKE); return *this; }
 				Minutiae& setThreshold(const float threshold) { this->threshold = threshold; return *this; }
-				
+
 				// operators
 				bool operator == (const Minutiae& m) const {
-					return (position == m.getPosition() && type == m.getType() && direction == m.getDirection());
+					return (x == m.x && y == m.y && type == m.type && direction == m.direction);
 				}
 				bool operator != (const Minutiae& m) const {
-					return (position != m.getPosition() || type != m.getType() || direction != m.getDirection());
+					return !(*this == m);
 				}
 			};
+
+			static_assert(sizeof(Minutiae) == 16, "Minutiae should stay a compact 16 byte record");
+			static_assert(std::is_trivially_copyable<Minutiae>::value, "Minutiae should be copied as plain memory");
 		}
 	}
 }
 
 
-inline bool processing::utils::storage::Minutiae::canBeFake()
-{
-	return (
-		this->getN(Type::TERMINATION) != 0 
-		|| this->getN(Type::BIFURCATION) != 0 
-		|| this->getC(Type::TERMINATION) != 0 
-		|| this->getC(Type::BIFURCATION) != 0
-	);
-}
-
 inline float processing::utils::storage::Minutiae::betaValueWith(const Minutiae& m) const
 {
-	const auto v1 = abs(static_cast<double>(this->getDirection() - m.getDirection()));
+	const auto v1 = std::abs(static_cast<double>(this->getDirection() - m.getDirection()));
 	const auto v2 = CV_2PI - v1;
 
 	return std::min(v1, v2);
 }
-
-inline bool processing::utils::storage::Minutiae::isFork()
-{
-	switch (this->type)
-	{
-		case Type::TERMINATION:
-		{
-			if (this->getN(Type::BIFURCATION) != 0)
-			{
-				return true;
-			}
-
-			break;
-		}	
-		case Type::BIFURCATION:
-		{
-			if (this->getC(Type::BIFURCATION) != 0 
-				|| this->getN(Type::TERMINATION) != 0)
-			{
-				return true;
-			}
-
-			break;
-		}
-		default:
-			return false;
-	}
-	
-	return false;
-}
-
-inline bool processing::utils::storage::Minutiae::isBur()
-{
-	switch (this->type)
-	{
-	case Type::TERMINATION:
-	{
-		if (this->getC(Type::BIFURCATION) != 0)
-		{
-			return true;
-		}
-
-		break;
-	}
-	case Type::BIFURCATION:
-	{
-		if (this->getC(Type::TERMINATION) != 0)
-		{
-			return true;
-		}
-
-		break;
-	}
-	default:
-		return false;
-	}
-
-	return false;
-}
-
-inline processing::utils::storage::Minutiae& processing::utils::storage::Minutiae::addN(const Minutiae& minutiae)
-{
-	this->facingPairs[minutiae.getType()].emplace_back(minutiae);
-	
-	return *this;
-}
-
-inline processing::utils::storage::Minutiae& processing::utils::storage::Minutiae::addC(const Minutiae& minutiae)
-{
-	this->connectedPairs[minutiae.getType()].emplace_back(minutiae);
-
-	return *this;
-}
-
-inline processing::utils::storage::Minutiae& processing::utils::storage::Minutiae::stripN(const Minutiae& minutiae)
-{
-	this->strip(this->facingPairs, minutiae);
-	
-	return *this;
-}
-
-inline processing::utils::storage::Minutiae& processing::utils::storage::Minutiae::stripC(const Minutiae& minutiae)
-{
-	this->strip(this->connectedPairs, minutiae);
-	
-	return *this;
-}
-
-inline void processing::utils::storage::Minutiae::strip(std::map<int, std::vector<Minutiae>>& map, const Minutiae& minutiae) const
-{
-	const auto type = minutiae.getType();
-	
-	if (std::find(map[type].begin(), map[type].end(), minutiae) != map[type].end())
-	{
-		map[type].erase(
-			std::remove(map[type].begin(), map[type].end(), minutiae),
-			map[type].end()
-		);
-	}
-}
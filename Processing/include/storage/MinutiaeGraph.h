@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <utility>
+#include <vector>
+
+namespace processing
+{
+	namespace utils
+	{
+		namespace storage
+		{
+			/**
+			 * \brief Vztahy falosnych struktur medzi markantmi ulozene ako riedke matice
+			 * susednosti (CSR). Markanty su identifikovane poradim v poli markantov,
+			 * susedia kazdeho markantu su ulozeni v poradi pridania.
+			 */
+			class MinutiaeGraph
+			{
+			public:
+				enum Relation { FACING = 0, CONNECTED };
+
+				/**
+				 * \brief Hrana grafu (markant, sused).
+				 */
+				using Edge = std::pair<int, int>;
+
+			private:
+				// members
+				/**
+				 * \brief Zaciatky susedov markantov pre kazdy vztah, posledny prvok je pocet hran.
+				 */
+				std::array<std::vector<int>, 2> offsets;
+				/**
+				 * \brief Susedia markantov pre kazdy vztah.
+				 */
+				std::array<std::vector<int>, 2> neighbors;
+
+				// static methods
+				/**
+				 * \brief Zoradi hrany podla markantu stabilne, poradie susedov ostava zachovane.
+				 * \param count pocet markantov
+				 * \param edges hrany
+				 * \param offsets sem sa ulozia zaciatky susedov
+				 * \param neighbors sem sa ulozia susedia
+				 */
+				static void compress(int count, const std::vector<Edge>& edges, std::vector<int>& offsets, std::vector<int>& neighbors);
+
+			public:
+				// constructors
+				/**
+				 * \param count pocet markantov
+				 */
+				explicit MinutiaeGraph(int count = 0) : MinutiaeGraph(count, {}, {}) {}
+				/**
+				 * \param count pocet markantov
+				 * \param facing hrany proti sebe stojacich markantov
+				 * \param connected hrany prepojenych markantov
+				 */
+				MinutiaeGraph(int count, const std::vector<Edge>& facing, const std::vector<Edge>& connected);
+
+				// methods
+				/**
+				 * \brief Prvy sused markantu.
+				 * \param relation vztah
+				 * \param i index markantu
+				 * \return ukazovatel na prveho suseda
+				 */
+				const int* begin(const Relation relation, const int i) const { return this->neighbors[relation].data() + this->offsets[relation][i]; }
+				/**
+				 * \brief Koniec susedov markantu.
+				 * \param relation vztah
+				 * \param i index markantu
+				 * \return ukazovatel za posledneho suseda
+				 */
+				const int* end(const Relation relation, const int i) const { return this->neighbors[relation].data() + this->offsets[relation][i + 1]; }
+				/**
+				 * \brief Pocet susedov markantu.
+				 * \param relation vztah
+				 * \param i index markantu
+				 * \return pocet susedov
+				 */
+				int degree(const Relation relation, const int i) const { return this->offsets[relation][i + 1] - this->offsets[relation][i]; }
+
+				// getters
+				int size() const { return static_cast<int>(this->offsets[FACING].size()) - 1; }
+			};
+		}
+	}
+}
+
+
+inline processing::utils::storage::MinutiaeGraph::MinutiaeGraph(const int count, const std::vector<Edge>& facing, const std::vector<Edge>& connected)
+{
+	compress(count, facing, this->offsets[FACING], this->neighbors[FACING]);
+	compress(count, connected, this->offsets[CONNECTED], this->neighbors[CONNECTED]);
+}
+
+inline void processing::utils::storage::MinutiaeGraph::compress(const int count, const std::vector<Edge>& edges,
+	std::vector<int>& offsets, std::vector<int>& neighbors)
+{
+	offsets.assign(count + 1, 0);
+	neighbors.resize(edges.size());
+
+	for (const auto& edge : edges)
+	{
+		offsets[edge.first + 1]++;
+	}
+	for (auto i = 0; i < count; i++)
+	{
+		offsets[i + 1] += offsets[i];
+	}
+
+	// zoradenie pocitanim je stabilne
+	auto next = offsets;
+	for (const auto& edge : edges)
+	{
+		neighbors[next[edge.first]++] = edge.second;
+	}
+}
@@ -2,6 +2,8 @@
 
 #include <opencv2/opencv.hpp>
 
+#include <array>
+
 namespace processing
 {
 	namespace utils
@@ -39,11 +41,14 @@ namespace processing
 			// static methods
 			/**
 			 * \brief Ziska amplitudu zo sinusoidy.
-			 * \param peaks vrcholy
+			 * \param peaks pozicie vrcholov
+			 * \param peakCount pocet vrcholov
+			 * \param valleys pozicie priehlbin
+			 * \param valleyCount pocet priehlbin
 			 * \param signal sinusoida
 			 * \return amplituda
 			 */
-			static float amplitude(const std::array<std::vector<int>, 2>& peaks, const std::vector<float>& signal);
+			static float amplitude(const int* peaks, int peakCount, const int* valleys, int valleyCount, const float* signal);
 
 			// getters
 			/**
@@ -70,19 +75,23 @@ inline int processing::utils::RegionMask::idealGaborBlock() const
 	return blockSize % 2 == 1 ? blockSize : blockSize + 1;
 }
 
-inline float processing::utils::RegionMask::amplitude(const std::array<std::vector<int>, 2>& peaks, const std::vector<float>& signal)
+inline float processing::utils::RegionMask::amplitude(const int* peaks, const int peakCount, const int* valleys, const int valleyCount,
+	const float* signal)
 {
+	const std::array<const int*, 2> indices = { peaks, valleys };
+	const std::array<int, 2> counts = { peakCount, valleyCount };
+
 	std::array<float, 2> avgPeak;
-	for (auto i = 0; i < peaks.size(); i++)
+	for (auto i = 0; i < 2; i++)
 	{
 		float sum = 0;
 		
-		for (const auto& index: peaks[i])
+		for (auto k = 0; k < counts[i]; k++)
 		{
-			sum += signal.at(index);
+			sum += signal[indices[i][k]];
 		}
 
-		avgPeak[i] = sum / peaks[i].size();
+		avgPeak[i] = sum / static_cast<float>(counts[i]);
 	}
 
 	return avgPeak[0] - avgPeak[1];
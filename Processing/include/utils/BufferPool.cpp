@@ -0,0 +1,181 @@
+#include "BufferPool.h"
+
+#include <algorithm>
+
+using namespace processing::utils;
+using namespace cv;
+
+BufferPool::Scope::Scope(BufferPool* pool) : previous(Mat::getDefaultAllocator())
+{
+	if (pool != nullptr)
+	{
+		Mat::setDefaultAllocator(pool);
+	}
+}
+
+BufferPool::Scope::~Scope()
+{
+	Mat::setDefaultAllocator(this->previous);
+}
+
+BufferPool::~BufferPool()
+{
+	this->release();
+}
+
+UMatData* BufferPool::allocate(const int dims, const int* sizes, const int type, void* data, size_t* step,
+	const AccessFlag flags, const UMatUsageFlags usageFlags) const
+{
+	// rovnaky vypocet krokov ako v standardnom alokatore OpenCV
+	size_t total = CV_ELEM_SIZE(type);
+	for (auto i = dims - 1; i >= 0; i--)
+	{
+		if (step)
+		{
+			if (data && step[i] != CV_AUTOSTEP)
+			{
+				CV_Assert(total <= step[i]);
+				total = step[i];
+			}
+			else
+			{
+				step[i] = total;
+			}
+		}
+		total *= sizes[i];
+	}
+
+	auto* u = new UMatData(this);
+	u->size = total;
+
+	if (data)
+	{
+		u->data = u->origdata = static_cast<std::uint8_t*>(data);
+		u->flags |= UMatData::USER_ALLOCATED;
+	}
+	else if (total < this->minimum)
+	{
+		u->data = u->origdata = static_cast<std::uint8_t*>(fastMalloc(total));
+	}
+	else
+	{
+		u->data = u->origdata = this->acquire(sizeClass(total));
+	}
+
+	return u;
+}
+
+bool BufferPool::allocate(UMatData* data, const AccessFlag flags, const UMatUsageFlags usageFlags) const
+{
+	return data != nullptr;
+}
+
+void BufferPool::deallocate(UMatData* data) const
+{
+	if (data == nullptr)
+	{
+		return;
+	}
+
+	CV_Assert(data->urefcount == 0);
+	CV_Assert(data->refcount == 0);
+
+	if (!(data->flags & UMatData::USER_ALLOCATED))
+	{
+		if (data->size < this->minimum)
+		{
+			fastFree(data->origdata);
+		}
+		else
+		{
+			this->recycle(data->origdata, sizeClass(data->size));
+		}
+		data->origdata = nullptr;
+	}
+
+	delete data;
+}
+
+void BufferPool::release()
+{
+	std::lock_guard<std::mutex> guard(this->lock);
+
+	for (auto& buffers : this->buffers)
+	{
+		for (auto* buffer : buffers.second)
+		{
+			fastFree(buffer);
+		}
+	}
+
+	this->buffers.clear();
+	this->retained = 0;
+}
+
+std::size_t BufferPool::size() const
+{
+	std::lock_guard<std::mutex> guard(this->lock);
+
+	std::size_t count = 0;
+	for (const auto& buffers : this->buffers)
+	{
+		count += buffers.second.size();
+	}
+
+	return count;
+}
+
+/////////////////////////////////////// Private members ///////////////////////////////////////
+
+std::uint8_t* BufferPool::acquire(const std::size_t size) const
+{
+	{
+		std::lock_guard<std::mutex> guard(this->lock);
+
+		const auto found = this->buffers.find(size);
+		if (found != this->buffers.end() && !found->second.empty())
+		{
+			auto* buffer = found->second.back();
+			found->second.pop_back();
+			this->retained -= size;
+			this->hits++;
+
+			return buffer;
+		}
+	}
+
+	// alokacia prebehne mimo zamku
+	this->misses++;
+
+	return static_cast<std::uint8_t*>(fastMalloc(size));
+}
+
+void BufferPool::recycle(std::uint8_t* buffer, const std::size_t size) const
+{
+	{
+		std::lock_guard<std::mutex> guard(this->lock);
+
+		if (this->retained + size <= this->budget)
+		{
+			this->buffers[size].push_back(buffer);
+			this->retained += size;
+
+			return;
+		}
+	}
+
+	fastFree(buffer);
+}
+
+std::size_t BufferPool::sizeClass(const std::size_t size)
+{
+	std::size_t octave = 1;
+	while (octave <= size / 2)
+	{
+		octave *= 2;
+	}
+
+	const auto step = std::max<std::size_t>(octave / 4, 1);
+
+	return (size + step - 1) / step * step;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace processing
+{
+	namespace utils
+	{
+		/**
+		 * \brief Alokator matic s bufframi zoskupenymi do velkostnych tried. Uvolneny
+		 * buffer sa vrati do triedy a dalsia matica podobnej velkosti ho znovu pouzije,
+		 * takze spracovanie dalsich odtlackov neopakuje alokacie velkych matic. Triedy
+		 * su stvrtiny oktavy, buffer je teda najviac o 25 % vacsi ako matica. Male
+		 * matice a matice nad udajmi volajuceho sa alokuju priamo.
+		 * Pool musi prezit vsetky matice, ktore z neho boli alokovane.
+		 */
+		class BufferPool : public cv::MatAllocator
+		{
+		public:
+			/**
+			 * \brief Nastavi pool ako predvoleny alokator matic na dobu svojej existencie.
+			 */
+			class Scope
+			{
+			private:
+				// members
+				/**
+				 * \brief Predchadzajuci predvoleny alokator.
+				 */
+				cv::MatAllocator* previous;
+
+			public:
+				// constructors
+				/**
+				 * \param pool pool, pri nullptr sa alokator nemeni
+				 */
+				explicit Scope(BufferPool* pool);
+				~Scope();
+
+				Scope(const Scope&) = delete;
+				Scope& operator=(const Scope&) = delete;
+			};
+
+		private:
+			// members
+			/**
+			 * \brief Pamatovy rozpocet uchovanych bufferov v bajtoch.
+			 */
+			std::size_t budget;
+			/**
+			 * \brief Najmensia velkost matice v bajtoch, ktora sa uchovava.
+			 */
+			std::size_t minimum = 64 * 1024;
+			/**
+			 * \brief Uchovane buffre podla velkostnej triedy.
+			 */
+			mutable std::map<std::size_t, std::vector<std::uint8_t*>> buffers;
+			/**
+			 * \brief Pamat uchovanych bufferov v bajtoch.
+			 */
+			mutable std::size_t retained = 0;
+			/**
+			 * \brief Zamok bufferov.
+			 */
+			mutable std::mutex lock;
+			/**
+			 * \brief Pocet alokacii obsluzenych uchovanym bufferom.
+			 */
+			mutable std::atomic<std::size_t> hits{ 0 };
+			/**
+			 * \brief Pocet alokacii novych bufferov.
+			 */
+			mutable std::atomic<std::size_t> misses{ 0 };
+
+			// methods
+			/**
+			 * \brief Vyberie uchovany buffer triedy alebo alokuje novy.
+			 * \param size velkost triedy
+			 * \return buffer
+			 */
+			std::uint8_t* acquire(std::size_t size) const;
+			/**
+			 * \brief Vrati buffer do triedy, pri prekroceni rozpoctu ho uvolni.
+			 * \param buffer buffer
+			 * \param size velkost triedy
+			 */
+			void recycle(std::uint8_t* buffer, std::size_t size) const;
+
+			// static methods
+			/**
+			 * \brief Zisti velkostnu triedu, najblizsiu vacsiu stvrtinu oktavy.
+			 * \param size velkost matice v bajtoch
+			 * \return velkost triedy v bajtoch
+			 */
+			static std::size_t sizeClass(std::size_t size);
+
+		public:
+			// constructors
+			/**
+			 * \param budget pamatovy rozpocet uchovanych bufferov v bajtoch
+			 */
+			explicit BufferPool(std::size_t budget) : budget(budget) {}
+			~BufferPool();
+
+			BufferPool(const BufferPool&) = delete;
+			BufferPool& operator=(const BufferPool&) = delete;
+
+			// methods
+			cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+				cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override;
+			bool allocate(cv::UMatData* data, cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override;
+			void deallocate(cv::UMatData* data) const override;
+			/**
+			 * \brief Uvolni vsetky uchovane buffre, napr. po skonceni davky. Pocitadla ostavaju.
+			 */
+			void release();
+
+			// getters
+			std::size_t getBudget() const { return this->budget; }
+			std::size_t getRetained() const { std::lock_guard<std::mutex> guard(this->lock); return this->retained; }
+			std::size_t size() const;
+			std::size_t getHits() const { return this->hits; }
+			std::size_t getMisses() const { return this->misses; }
+
+			// setters
+			BufferPool& setMinimum(const std::size_t minimum) { this->minimum = minimum; return *this; }
+		};
+	}
+}
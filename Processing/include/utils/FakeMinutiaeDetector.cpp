@@ -7,7 +7,7 @@ using namespace processing::utils;
 using namespace processing;
 using namespace cv;
 
-int FakeMinutiaeDetector::displayed = 0;
+std::atomic<int> FakeMinutiaeDetector::displayed(0);
 const std::string FakeMinutiaeDetector::class_name = "FakeMinutiaeDetector::";
 
 bool FakeMinutiaeDetector::isFacingPair(const Minutiae& m1, const Minutiae& m2) const
@@ -147,7 +147,99 @@ float FakeMinutiaeDetector::maximalTracingLength(const Minutiae& m) const
 	}
 }
 
-void FakeMinutiaeDetector::display(const Mat& img, std::vector<Minutiae> minutiaes, const std::string& trace) const
+int FakeMinutiaeDetector::neighbourhood(const Minutiae& m) const
+{
+	// tracovanie zacina na susednom pixeli a v kazdom kroku postupi najviac o jeden pixel
+	const auto traced = 1 + static_cast<int>(std::ceil(this->maximalTracingLength(m)));
+	const auto around = static_cast<int>(std::ceil(m.getThreshold() * 2.0f));
+
+	return std::max(traced, around);
+}
+
+FakeMinutiaeDetector::Grid FakeMinutiaeDetector::grid(const std::vector<Minutiae>& minutiaes, const int cell) const
+{
+	Grid grid;
+	grid.cell = cell;
+
+	if (minutiaes.empty())
+	{
+		grid.offsets.assign(1, 0);
+		return grid;
+	}
+
+	auto topLeft = minutiaes.front().getPosition();
+	auto bottomRight = topLeft;
+	for (const auto& minutiae : minutiaes)
+	{
+		const auto position = minutiae.getPosition();
+
+		topLeft.x = std::min(topLeft.x, position.x);
+		topLeft.y = std::min(topLeft.y, position.y);
+		bottomRight.x = std::max(bottomRight.x, position.x);
+		bottomRight.y = std::max(bottomRight.y, position.y);
+	}
+
+	grid.origin = topLeft;
+	grid.size = Size((bottomRight.x - topLeft.x) / cell + 1, (bottomRight.y - topLeft.y) / cell + 1);
+
+	// zoradenie pocitanim, markanty bunky ostanu vzostupne
+	std::vector<int> cells(minutiaes.size());
+	grid.offsets.assign(grid.size.area() + 1, 0);
+	for (auto i = 0u; i < minutiaes.size(); i++)
+	{
+		const auto position = minutiaes[i].getPosition() - grid.origin;
+
+		cells[i] = (position.y / cell) * grid.size.width + position.x / cell;
+		grid.offsets[cells[i] + 1]++;
+	}
+	for (auto c = 0; c < grid.size.area(); c++)
+	{
+		grid.offsets[c + 1] += grid.offsets[c];
+	}
+
+	grid.indices.resize(minutiaes.size());
+	auto next = grid.offsets;
+	for (auto i = 0u; i < minutiaes.size(); i++)
+	{
+		grid.indices[next[cells[i]]++] = i;
+	}
+
+	return grid;
+}
+
+void FakeMinutiaeDetector::around(const Grid& grid, const std::vector<Minutiae>& minutiaes, const Point& position, const int radius,
+	std::vector<int>& found) const
+{
+	found.clear();
+
+	const auto column = (position.x - grid.origin.x) / grid.cell;
+	const auto row = (position.y - grid.origin.y) / grid.cell;
+
+	// polomer nie je vacsi ako bunka, staci susedstvo 3x3 buniek
+	for (auto r = std::max(row - 1, 0); r <= std::min(row + 1, grid.size.height - 1); r++)
+	{
+		for (auto c = std::max(column - 1, 0); c <= std::min(column + 1, grid.size.width - 1); c++)
+		{
+			const auto cell = r * grid.size.width + c;
+
+			for (auto k = grid.offsets[cell]; k < grid.offsets[cell + 1]; k++)
+			{
+				const auto j = grid.indices[k];
+				const auto other = minutiaes[j].getPosition();
+
+				if (std::abs(other.x - position.x) <= radius && std::abs(other.y - position.y) <= radius)
+				{
+					found.push_back(j);
+				}
+			}
+		}
+	}
+
+	// rovnake poradie ako pri prechode vsetkych markantov
+	std::sort(found.begin(), found.end());
+}
+
+void FakeMinutiaeDetector::display(const Mat& img, const std::vector<Minutiae>& minutiaes, const MinutiaeGraph& graph, const std::string& trace) const
 {
 	Mat tmp(img.size(), CV_8UC3);
 
@@ -160,8 +252,9 @@ void FakeMinutiaeDetector::display(const Mat& img, std::vector<Minutiae> minutia
 
 	const auto length = 20;
 
-	for (auto& minutiae : minutiaes)
+	for (auto i = 0u; i < minutiaes.size(); i++)
 	{
+		const auto& minutiae = minutiaes[i];
 		const auto type = minutiae.getType();
 
 		const auto pos1 = minutiae.getPosition();
@@ -170,7 +263,7 @@ void FakeMinutiaeDetector::display(const Mat& img, std::vector<Minutiae> minutia
 		const auto pos2 = Point(pos1.x + length * std::cos(dir), pos1.y + length * std::sin(dir));
 
 		auto color = real;
-		if (minutiae.canBeFake())
+		if (graph.degree(MinutiaeGraph::FACING, i) != 0 || graph.degree(MinutiaeGraph::CONNECTED, i) != 0)
 		{
 			color = fake;
 		}
@@ -195,204 +288,260 @@ void FakeMinutiaeDetector::display(const Mat& img, std::vector<Minutiae> minutia
 	imshow(ss.str(), tmp);
 }
 
-void FakeMinutiaeDetector::find(const Mat& img, std::vector<Minutiae>& minutiaes) const
+MinutiaeGraph FakeMinutiaeDetector::find(const Mat& img, std::vector<Minutiae>& minutiaes) const
 {
-	if (minutiaes.size() > 65)
+	const auto count = static_cast<int>(minutiaes.size());
+
+	// markanty mimo susedstva nemozu byt v okoli ani prepojene, staci prehladat blizke bunky
+	auto cell = 1;
+	for (const auto& minutiae : minutiaes)
 	{
-		return;
+		cell = std::max(cell, this->neighbourhood(minutiae));
 	}
-	
-	auto i = 0;
-	for (auto analyzedMinutiae = minutiaes.begin(); analyzedMinutiae != minutiaes.end(); ++analyzedMinutiae)
+	const auto grid = this->grid(minutiaes, cell);
+
+	// hrany pribudaju v poradi analyzovanych markantov, graf ich tak uklada bez presunu
+	std::vector<MinutiaeGraph::Edge> facing, connected;
+	std::vector<int> candidates;
+	for (auto i = 0; i < count; i++)
 	{
-		i++;
-		for (auto minutiae = minutiaes.begin(); minutiae != minutiaes.end(); ++minutiae)
+		auto& analyzedMinutiae = minutiaes[i];
+
+		this->around(grid, minutiaes, analyzedMinutiae.getPosition(), this->neighbourhood(analyzedMinutiae), candidates);
+
+		for (const auto j : candidates)
 		{
-			if (analyzedMinutiae == minutiae)
+			if (i == j)
 			{
 				continue;
 			}
+
+			const auto& minutiae = minutiaes[j];
 			
-			auto connected = false;
-			if (this->areConnected(*analyzedMinutiae, *minutiae, img))
+			auto connection = false;
+			if (this->areConnected(analyzedMinutiae, minutiae, img))
 			{
-				connected = true;
+				connection = true;
 			}
 			
-			if (this->isAround(*analyzedMinutiae, *minutiae)
-				&& this->isFacingPair(*analyzedMinutiae, *minutiae)
-				&& !connected)
+			if (this->isAround(analyzedMinutiae, minutiae)
+				&& this->isFacingPair(analyzedMinutiae, minutiae)
+				&& !connection)
 			{
 				// pridam falosnu strukturu - voci sebe stojaci par
-				analyzedMinutiae->addN(*minutiae);
-				analyzedMinutiae->setFake();
+				facing.emplace_back(i, j);
+				analyzedMinutiae.setFake();
 			}
-			else if (connected)
+			else if (connection)
 			{
 				// pridam falosnu strukturu prepojenych
-				analyzedMinutiae->addC(*minutiae);
-				analyzedMinutiae->setFake();
+				connected.emplace_back(i, j);
+				analyzedMinutiae.setFake();
 			}
 		}
 	}
+
+	return MinutiaeGraph(count, facing, connected);
 }
 
-void FakeMinutiaeDetector::remove(std::vector<Minutiae>& minutiaes) const
+void FakeMinutiaeDetector::remove(std::vector<Minutiae>& minutiaes, const MinutiaeGraph& graph) const
 {
-	this->repairBrokenRidges(minutiaes);
-	this->repairForks(minutiaes);
-	this->removeBurs(minutiaes);
+	// zmazane markanty su len oznacene, indexy grafu tak ostavaju platne
+	std::vector<bool> removed(minutiaes.size(), false);
+
+	this->repairBrokenRidges(minutiaes, graph, removed);
+	this->repairForks(minutiaes, graph, removed);
+	this->removeBurs(minutiaes, graph, removed);
+
+	auto kept = 0u;
+	for (auto i = 0u; i < minutiaes.size(); i++)
+	{
+		if (!removed[i])
+		{
+			minutiaes[kept++] = minutiaes[i];
+		}
+	}
+	minutiaes.resize(kept);
 }
 
-void FakeMinutiaeDetector::removeBurs(std::vector<Minutiae>& minutiaes) const
+std::vector<int> FakeMinutiaeDetector::neighbors(const std::vector<Minutiae>& minutiaes, const MinutiaeGraph& graph,
+	const std::vector<bool>& removed, const MinutiaeGraph::Relation relation, const int i, const int type) const
 {
-	for (auto minutiae = minutiaes.begin(); minutiae != minutiaes.end();)
+	std::vector<int> found;
+	for (auto n = graph.begin(relation, i); n != graph.end(relation, i); ++n)
 	{
-		if (minutiae->isFake() && minutiae->isBur())
+		// zmazany markant sa odoberie len zo struktur proti sebe stojacich markantov
+		if (minutiaes[*n].getType() == type && (relation == MinutiaeGraph::CONNECTED || !removed[*n]))
 		{
-			auto type = Minutiae::Type::NONE;
+			found.push_back(*n);
+		}
+	}
 
-			switch(minutiae->getType())
-			{
-				case Minutiae::Type::TERMINATION:
-					type = Minutiae::Type::BIFURCATION;
-					break;
-				case Minutiae::Type::BIFURCATION:
-					type = Minutiae::Type::TERMINATION;
-					break;
-				default:
-					minutiae = minutiaes.erase(minutiae);
-					continue;
-			}
-			
-			auto minutiaesToDelete = minutiae->getConnected(type);
-			minutiaesToDelete.insert(minutiaesToDelete.end(), *minutiae);
-			
-			minutiae = this->handleRemove(minutiaes, minutiaesToDelete);
+	return found;
+}
+
+bool FakeMinutiaeDetector::isFork(const std::vector<Minutiae>& minutiaes, const MinutiaeGraph& graph, const std::vector<bool>& removed, 
+	const int i) const
+{
+	switch (minutiaes[i].getType())
+	{
+		case Minutiae::Type::TERMINATION:
+		{
+			return !this->neighbors(minutiaes, graph, removed, MinutiaeGraph::FACING, i, Minutiae::Type::BIFURCATION).empty();
 		}
-		else
+		case Minutiae::Type::BIFURCATION:
 		{
-			++minutiae;
+			return !this->neighbors(minutiaes, graph, removed, MinutiaeGraph::CONNECTED, i, Minutiae::Type::BIFURCATION).empty()
+				|| !this->neighbors(minutiaes, graph, removed, MinutiaeGraph::FACING, i, Minutiae::Type::TERMINATION).empty();
 		}
+		default:
+			return false;
 	}
 }
 
-void FakeMinutiaeDetector::repairForks(std::vector<Minutiae>& minutiaes) const
+bool FakeMinutiaeDetector::isBur(const std::vector<Minutiae>& minutiaes, const MinutiaeGraph& graph, const std::vector<bool>& removed,
+	const int i) const
 {
-	for (auto minutiae = minutiaes.begin(); minutiae != minutiaes.end();)
+	switch (minutiaes[i].getType())
 	{
-		if (minutiae->isFake() && minutiae->isFork())
+		case Minutiae::Type::TERMINATION:
 		{
-			switch (minutiae->getType())
-			{
-				case Minutiae::Type::TERMINATION:
-				{
-					auto facing = minutiae->getFacing(Minutiae::Type::BIFURCATION);
+			return !this->neighbors(minutiaes, graph, removed, MinutiaeGraph::CONNECTED, i, Minutiae::Type::BIFURCATION).empty();
+		}
+		case Minutiae::Type::BIFURCATION:
+		{
+			return !this->neighbors(minutiaes, graph, removed, MinutiaeGraph::CONNECTED, i, Minutiae::Type::TERMINATION).empty();
+		}
+		default:
+			return false;
+	}
+}
 
-					std::vector<Minutiae> fakes;
-					if (!facing.empty())
-					{
-						const auto maxAt = this->maxBetaAt(*minutiae, facing);
-						fakes.insert(fakes.end(), facing.at(maxAt));
-					}
+void FakeMinutiaeDetector::removeBurs(const std::vector<Minutiae>& minutiaes, const MinutiaeGraph& graph, std::vector<bool>& removed) const
+{
+	for (auto i = 0; i < static_cast<int>(minutiaes.size()); i++)
+	{
+		if (removed[i] || !minutiaes[i].isFake() || !this->isBur(minutiaes, graph, removed, i))
+		{
+			continue;
+		}
 
-					fakes.insert(fakes.end(), *minutiae);
-					
-					minutiae = this->handleRemove(minutiaes, fakes);
+		const auto type = minutiaes[i].getType() == Minutiae::Type::TERMINATION
+			? Minutiae::Type::BIFURCATION
+			: Minutiae::Type::TERMINATION;
 
-					break;
-				}
-				case Minutiae::Type::BIFURCATION:
-				{
-					auto facingForks = minutiae->getFacing(Minutiae::Type::TERMINATION);
-					auto minutiaesToDelete = minutiae->getConnected(Minutiae::Type::BIFURCATION);
+		auto minutiaesToDelete = this->neighbors(minutiaes, graph, removed, MinutiaeGraph::CONNECTED, i, type);
+		minutiaesToDelete.push_back(i);
 
-					std::vector<Minutiae> fakes;
-					if (!facingForks.empty())
-					{
-						const auto maxAt = this->maxBetaAt(*minutiae, facingForks);
-						fakes.insert(fakes.end(), facingForks.at(maxAt));
-					}
-						
-					minutiaesToDelete.insert(minutiaesToDelete.end(), fakes.begin(), fakes.end());
-					minutiaesToDelete.insert(minutiaesToDelete.end(), *minutiae);
-						
-					minutiae = this->handleRemove(minutiaes, minutiaesToDelete);
+		this->handleRemove(minutiaes, minutiaesToDelete, removed);
 
-					break;
-				}
-				default:
-					minutiae = minutiaes.erase(minutiae);
-					continue;
-			}
+		// po zmazani prechod konci
+		break;
+	}
+}
+
+void FakeMinutiaeDetector::repairForks(const std::vector<Minutiae>& minutiaes, const MinutiaeGraph& graph, std::vector<bool>& removed) const
+{
+	for (auto i = 0; i < static_cast<int>(minutiaes.size()); i++)
+	{
+		if (removed[i] || !minutiaes[i].isFake() || !this->isFork(minutiaes, graph, removed, i))
+		{
+			continue;
+		}
+
+		std::vector<int> minutiaesToDelete;
+		if (minutiaes[i].getType() == Minutiae::Type::BIFURCATION)
+		{
+			minutiaesToDelete = this->neighbors(minutiaes, graph, removed, MinutiaeGraph::CONNECTED, i, Minutiae::Type::BIFURCATION);
 		}
-		else
+
+		const auto facingType = minutiaes[i].getType() == Minutiae::Type::TERMINATION
+			? Minutiae::Type::BIFURCATION
+			: Minutiae::Type::TERMINATION;
+
+		const auto facing = this->neighbors(minutiaes, graph, removed, MinutiaeGraph::FACING, i, facingType);
+		if (!facing.empty())
 		{
-			++minutiae;
+			minutiaesToDelete.push_back(facing[this->maxBetaAt(minutiaes, i, facing)]);
 		}
+
+		minutiaesToDelete.push_back(i);
+
+		this->handleRemove(minutiaes, minutiaesToDelete, removed);
+
+		// po zmazani prechod konci
+		break;
 	}
 }
 
-void FakeMinutiaeDetector::repairBrokenRidges(std::vector<Minutiae>& minutiaes) const
+void FakeMinutiaeDetector::repairBrokenRidges(const std::vector<Minutiae>& minutiaes, const MinutiaeGraph& graph, std::vector<bool>& removed) const
 {
 	const auto termination = Minutiae::Type::TERMINATION;
-	auto maxEe = this->maxFacingPairs(minutiaes, termination, termination);
+	auto maxEe = this->maxFacingPairs(minutiaes, graph, removed, termination, termination);
 
 	// zacinam od markantov s najviac celiacimi markantmi
 	while (maxEe > 0)
 	{
-		for (auto minutiae = minutiaes.begin(); minutiae != minutiaes.end();)
+		for (auto i = 0; i < static_cast<int>(minutiaes.size()); i++)
 		{
-			// je falosny? je ukoncenie? ma aktualne kontrolovany pocet celiacich markantov?
-			if (minutiae->isFake() && minutiae->getType() == termination && minutiae->getN(termination) == maxEe)
+			if (removed[i] || !minutiaes[i].isFake() || minutiaes[i].getType() != termination)
 			{
-				auto facing = minutiae->getFacing(minutiae->getType());
-
-				std::vector<Minutiae> fakes;
-				if (!facing.empty())
-				{
-					const auto maxAt = this->maxBetaAt(*minutiae, facing);
-					fakes.insert(fakes.end(), facing.at(maxAt));
-				}
+				continue;
+			}
 
-				fakes.insert(fakes.end(), *minutiae);
-				
-				minutiae = this->handleRemove(minutiaes, fakes);
+			// ma aktualne kontrolovany pocet celiacich markantov?
+			const auto facing = this->neighbors(minutiaes, graph, removed, MinutiaeGraph::FACING, i, termination);
+			if (static_cast<int>(facing.size()) != maxEe)
+			{
+				continue;
 			}
-			else
+
+			std::vector<int> minutiaesToDelete;
+			if (!facing.empty())
 			{
-				++minutiae;
+				minutiaesToDelete.push_back(facing[this->maxBetaAt(minutiaes, i, facing)]);
 			}
+
+			minutiaesToDelete.push_back(i);
+
+			this->handleRemove(minutiaes, minutiaesToDelete, removed);
+
+			// po zmazani prechod konci
+			break;
 		}
 
 		maxEe--;
 	}
 }
 
-int FakeMinutiaeDetector::maxBetaAt(const Minutiae& minutiae, const std::vector<Minutiae>& facing) const
+int FakeMinutiaeDetector::maxBetaAt(const std::vector<Minutiae>& minutiaes, const int i, const std::vector<int>& facing) const
 {
+	const auto& minutiae = minutiaes[i];
+
 	auto maxAt = 0;
-	for (auto i = 0; i < facing.size(); i++)
+	for (auto f = 0; f < static_cast<int>(facing.size()); f++)
 	{
-		if (minutiae.betaValueWith(facing.at(i)) > minutiae.betaValueWith(facing.at(maxAt)))
+		if (minutiae.betaValueWith(minutiaes[facing[f]]) > minutiae.betaValueWith(minutiaes[facing[maxAt]]))
 		{
-			maxAt = i;
+			maxAt = f;
 		}
 	}
 
 	return maxAt;
 }
 
-int FakeMinutiaeDetector::maxFacingPairs(std::vector<Minutiae>& minutiaes, const int m1, const int m2) const
+int FakeMinutiaeDetector::maxFacingPairs(const std::vector<Minutiae>& minutiaes, const MinutiaeGraph& graph, const std::vector<bool>& removed,
+	const int m1, const int m2) const
 {
 	auto max = 0;
-	for (auto& minutiae : minutiaes)
+	for (auto i = 0; i < static_cast<int>(minutiaes.size()); i++)
 	{
-		if (minutiae.isFake() && minutiae.getType() == m1)
+		if (!removed[i] && minutiaes[i].isFake() && minutiaes[i].getType() == m1)
 		{
-			if (minutiae.getN(m2) > max)
+			const auto facing = static_cast<int>(this->neighbors(minutiaes, graph, removed, MinutiaeGraph::FACING, i, m2).size());
+			if (facing > max)
 			{
-				max = minutiae.getN(m2);
+				max = facing;
 			}
 		}
 	}
@@ -400,56 +549,20 @@ int FakeMinutiaeDetector::maxFacingPairs(std::vector<Minutiae>& minutiaes, const
 	return max;
 }
 
-std::_Vector_iterator<std::_Vector_val<std::_Simple_types<Minutiae>>> FakeMinutiaeDetector::handleRemove(std::vector<Minutiae>& minutiaes, const std::vector<Minutiae>& minutiaesToDelete) const
+void FakeMinutiaeDetector::handleRemove(const std::vector<Minutiae>& minutiaes, const std::vector<int>& minutiaesToDelete,
+	std::vector<bool>& removed) const
 {
-
-	std::_Vector_iterator<std::_Vector_val<std::_Simple_types<Minutiae>>> minutiae;
-	for (const auto& minutiaeToDelete : minutiaesToDelete)
+	// markant sa maze podla hodnoty, zmazane su aj vsetky jemu rovne markanty
+	for (const auto d : minutiaesToDelete)
 	{
-		minutiae = minutiaes.erase(
-			std::remove(minutiaes.begin(), minutiaes.end(), minutiaeToDelete),
-			minutiaes.end()
-		);
-	}
-
-	this->removeFromStructures(minutiaes, minutiaesToDelete);
+		const auto minutiaeToDelete = minutiaes[d];
 
-	return minutiae;
-}
-
-std::_Vector_iterator<std::_Vector_val<std::_Simple_types<Minutiae>>> FakeMinutiaeDetector::handleRemove(std::vector<Minutiae>& minutiaes, const Minutiae& minutiaeToDelete) const
-{
-	auto minutiae = minutiaes.erase(
-		std::remove(minutiaes.begin(), minutiaes.end(), minutiaeToDelete),
-		minutiaes.end()
-	);
-
-	this->removeFromStructures(minutiaes, minutiaeToDelete);
-
-	return minutiae;
-}
-
-void FakeMinutiaeDetector::removeFromStructures(std::vector<Minutiae>& minutiaes, const std::vector<Minutiae>& minutiaesToDelete) const
-{
-	for (auto& min : minutiaes)
-	{
-		if (min.isFake())
+		for (auto i = 0u; i < minutiaes.size(); i++)
 		{
-			for (auto& minutiaeToDelete : minutiaesToDelete)
+			if (!removed[i] && minutiaes[i] == minutiaeToDelete)
 			{
-				min.stripN(minutiaeToDelete);
+				removed[i] = true;
 			}
 		}
 	}
 }
-
-void FakeMinutiaeDetector::removeFromStructures(std::vector<Minutiae>& minutiaes, const Minutiae& minutiaeToDelete) const
-{
-	for (auto& min : minutiaes)
-	{
-		if (min.isFake())
-		{
-			min.stripN(minutiaeToDelete);
-		}
-	}
-}
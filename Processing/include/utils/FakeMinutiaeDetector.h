@@ -1,9 +1,11 @@
 #pragma once
 
 #include "storage/Minutiae.h"
+#include "storage/MinutiaeGraph.h"
 
 #include <opencv2/opencv.hpp>
 
+#include <atomic>
 #include <vector>
 
 namespace processing
@@ -16,11 +18,36 @@ namespace processing
 		class FakeMinutiaeDetector
 		{
 		private:
-			// members
-			cv::Mat tmp;
-			
+			/**
+			 * \brief Rovnomerna mriezka pozicii markantov. Indexy markantov su zoradene
+			 * podla buniek, markanty kazdej bunky su ulozene vzostupne.
+			 */
+			struct Grid
+			{
+				/**
+				 * \brief Velkost bunky v pixeloch.
+				 */
+				int cell = 1;
+				/**
+				 * \brief Lavy horny roh mriezky.
+				 */
+				cv::Point origin;
+				/**
+				 * \brief Pocet stlpcov a riadkov buniek.
+				 */
+				cv::Size size;
+				/**
+				 * \brief Zaciatky markantov buniek, posledny prvok je pocet markantov.
+				 */
+				std::vector<int> offsets;
+				/**
+				 * \brief Indexy markantov zoradene podla buniek.
+				 */
+				std::vector<int> indices;
+			};
+
 			// static members
-			static int displayed;
+			static std::atomic<int> displayed;
 			
 			// methods
 			/**
@@ -73,67 +100,122 @@ namespace processing
 			 * \return dlzka tracovania
 			 */
 			float maximalTracingLength(const storage::Minutiae& m) const;
+			/**
+			 * \brief Najvacsia vzdialenost v Chebysevovej metrike, v ktorej moze lezat markant
+			 * v okoli markantu m alebo s nim prepojeny. Okolie je mensie ako dvojnasobok
+			 * prahu, tracovanie postupuje o jeden pixel za krok.
+			 * \param m markant
+			 * \return polomer susedstva v pixeloch
+			 */
+			int neighbourhood(const storage::Minutiae& m) const;
+			/**
+			 * \brief Rozdeli markanty do rovnomernej mriezky.
+			 * \param minutiaes markanty
+			 * \param cell velkost bunky
+			 * \return mriezka markantov
+			 */
+			Grid grid(const std::vector<storage::Minutiae>& minutiaes, int cell) const;
+			/**
+			 * \brief Najde markanty do Chebysevovej vzdialenosti radius od pozicie.
+			 * Polomer nesmie byt vacsi ako velkost bunky mriezky.
+			 * \param grid mriezka markantov
+			 * \param minutiaes markanty
+			 * \param position pozicia
+			 * \param radius polomer
+			 * \param found sem sa ulozia indexy najdenych markantov vzostupne
+			 */
+			void around(const Grid& grid, const std::vector<storage::Minutiae>& minutiaes, const cv::Point& position, int radius,
+				std::vector<int>& found) const;
+
+			/**
+			 * \brief Zisti ci je markant vidlicova struktura.
+			 * \param minutiaes markanty
+			 * \param graph vztahy falosnych struktur
+			 * \param removed zmazane markanty
+			 * \param i index markantu
+			 * \return ci je vidlicova struktura
+			 */
+			bool isFork(const std::vector<storage::Minutiae>& minutiaes, const storage::MinutiaeGraph& graph,
+				const std::vector<bool>& removed, int i) const;
+			/**
+			 * \brief Zisti ci je markant struktura Bur.
+			 * \param minutiaes markanty
+			 * \param graph vztahy falosnych struktur
+			 * \param removed zmazane markanty
+			 * \param i index markantu
+			 * \return ci je struktura Bur
+			 */
+			bool isBur(const std::vector<storage::Minutiae>& minutiaes, const storage::MinutiaeGraph& graph,
+				const std::vector<bool>& removed, int i) const;
+			/**
+			 * \brief Najde susedov markantu daneho typu. Zmazani proti sebe stojaci susedia
+			 * su vynechani, prepojeni susedia ostavaju aj po zmazani.
+			 * \param minutiaes markanty
+			 * \param graph vztahy falosnych struktur
+			 * \param removed zmazane markanty
+			 * \param relation vztah
+			 * \param i index markantu
+			 * \param type typ susedov
+			 * \return indexy susedov
+			 */
+			std::vector<int> neighbors(const std::vector<storage::Minutiae>& minutiaes, const storage::MinutiaeGraph& graph,
+				const std::vector<bool>& removed, storage::MinutiaeGraph::Relation relation, int i, int type) const;
 
 			/**
 			 * \brief Odstrani markanty vzniknute prerusenim linie.
 			 * \param minutiaes markanty
+			 * \param graph vztahy falosnych struktur
+			 * \param removed zmazane markanty
 			 */
-			void repairBrokenRidges(std::vector<storage::Minutiae>& minutiaes) const;
+			void repairBrokenRidges(const std::vector<storage::Minutiae>& minutiaes, const storage::MinutiaeGraph& graph,
+				std::vector<bool>& removed) const;
 			/**
 			 * \brief Odstrani markanty vzniknute nespravnym prepojenim linii.
-			 * \param minutiaes 
+			 * \param minutiaes markanty
+			 * \param graph vztahy falosnych struktur
+			 * \param removed zmazane markanty
 			 */
-			void repairForks(std::vector<storage::Minutiae>& minutiaes) const;
+			void repairForks(const std::vector<storage::Minutiae>& minutiaes, const storage::MinutiaeGraph& graph,
+				std::vector<bool>& removed) const;
 			/**
 			 * \brief Odstrani markanty vytvorene falosnymi vybezkami a prepojeniami.
 			 * \param minutiaes markanty
+			 * \param graph vztahy falosnych struktur
+			 * \param removed zmazane markanty
 			 */
-			void removeBurs(std::vector<storage::Minutiae>& minutiaes) const;
+			void removeBurs(const std::vector<storage::Minutiae>& minutiaes, const storage::MinutiaeGraph& graph,
+				std::vector<bool>& removed) const;
 			
 			/**
-			 * \brief Zisti kolko maximalne cely markantov typu m1 oproti typu m2.
+			 * \brief Zisti kolko maximalne celi markantov typu m1 oproti typu m2.
 			 * \param minutiaes markanty
+			 * \param graph vztahy falosnych struktur
+			 * \param removed zmazane markanty
 			 * \param m1 typ markantu
 			 * \param m2 typ markantu
 			 * \return maximalny pocet celiacich markantov
 			 */
-			int maxFacingPairs(std::vector<storage::Minutiae>& minutiaes, int m1, int m2) const;
+			int maxFacingPairs(const std::vector<storage::Minutiae>& minutiaes, const storage::MinutiaeGraph& graph,
+				const std::vector<bool>& removed, int m1, int m2) const;
 			/**
 			 * \brief Najvacsi uhol celiach markantov.
-			 * \param minutiae markant
-			 * \param facing celiace markanty
-			 * \return maximalny uhol
-			 */
-			int maxBetaAt(const storage::Minutiae& minutiae, const std::vector<storage::Minutiae>& facing) const;
-
-			/**
-			 * \brief Zmaze markanty urcene k zmazaniu z markantov.
-			 * \param minutiaes markanty
-			 * \param minutiaesToDelete markanty urcene k zmazaniu
-			 * \return novy iterator na vektor marakantov
-			 */
-			std::_Vector_iterator<std::_Vector_val<std::_Simple_types<storage::Minutiae>>>
-				handleRemove(std::vector<storage::Minutiae>& minutiaes, const std::vector<storage::Minutiae>& minutiaesToDelete) const;
-			/**
-			 * \brief Zmaze jeden markant z markantov
 			 * \param minutiaes markanty
-			 * \param minutiaeToDelete markant k zmazaniu
-			 * \return novy iterator na vektor marakantov
+			 * \param i index markantu
+			 * \param facing indexy celiacich markantov
+			 * \return poradie markantu s maximalnym uhlom
 			 */
-			std::_Vector_iterator<std::_Vector_val<std::_Simple_types<storage::Minutiae>>>
-				handleRemove(std::vector<storage::Minutiae>& minutiaes, const storage::Minutiae& minutiaeToDelete) const;
-			/**
-			 * \brief Premaze registrovane falosne struktry o markanty urcene k zmazaniu.
-			 * \param minutiaes markanty
-			 * \param minutiaesToDelete markanty urcene k zmazaniu
-			 */
-			void removeFromStructures(std::vector<storage::Minutiae>& minutiaes, const std::vector<storage::Minutiae>& minutiaesToDelete) const;
+			int maxBetaAt(const std::vector<storage::Minutiae>& minutiaes, int i, const std::vector<int>& facing) const;
+
 			/**
-			 * \brief Premaze registrovane falosne struktry o markant urceny k zmazaniu.
+			 * \brief Oznaci markanty urcene k zmazaniu ako zmazane, spolu so vsetkymi
+			 * markantmi, ktore su im rovne. Proti sebe stojaci susedia, ktori su zmazani,
+			 * sa v strukturach ostatnych markantov dalej nepocitaju.
 			 * \param minutiaes markanty
-			 * \param minutiaesToDelete markant urcene k zmazaniu
+			 * \param minutiaesToDelete indexy markantov urcenych k zmazaniu
+			 * \param removed zmazane markanty
 			 */
-			void removeFromStructures(std::vector<storage::Minutiae>& minutiaes, const storage::Minutiae& minutiaeToDelete) const;
+			void handleRemove(const std::vector<storage::Minutiae>& minutiaes, const std::vector<int>& minutiaesToDelete,
+				std::vector<bool>& removed) const;
 			
 		public:
 			// static members
@@ -147,22 +229,26 @@ namespace processing
 			 * \brief Zomrazi markanty urcene k zmazaniu.
 			 * \param img obrazok odtlacku
 			 * \param minutiaes markanty
+			 * \param graph vztahy falosnych struktur
 			 * \param trace miesto odkial bola metoda volana
 			 */
-			void display(const cv::Mat& img, std::vector<storage::Minutiae> minutiaes, const std::string& trace) const;
+			void display(const cv::Mat& img, const std::vector<storage::Minutiae>& minutiaes, const storage::MinutiaeGraph& graph,
+				const std::string& trace) const;
 			
 			// methods
 			/**
-			 * \brief Najde falosne markanty.
+			 * \brief Najde falosne markanty a oznaci ich.
 			 * \param img mapa odtlacku
 			 * \param minutiaes markanty
+			 * \return vztahy falosnych struktur medzi markantmi
 			 */
-			void find(const cv::Mat& img, std::vector<storage::Minutiae>& minutiaes) const;
+			storage::MinutiaeGraph find(const cv::Mat& img, std::vector<storage::Minutiae>& minutiaes) const;
 			/**
 			 * \brief Odstrani falosne markanty.
 			 * \param minutiaes markanty
+			 * \param graph vztahy falosnych struktur najdene pre tieto markanty
 			 */
-			void remove(std::vector<storage::Minutiae>& minutiaes) const;
+			void remove(std::vector<storage::Minutiae>& minutiaes, const storage::MinutiaeGraph& graph) const;
 			
 		};
 	}
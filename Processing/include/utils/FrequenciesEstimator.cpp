@@ -1,43 +1,54 @@
 #include "FrequenciesEstimator.h"
 #include "ImageProcessor.h"
 
+#include <algorithm>
+
 using namespace processing::utils;
 using namespace processing;
 using namespace cv;
 
-int FrequenciesEstimator::displayed = 0;
+std::atomic<int> FrequenciesEstimator::displayed(0);
 const std::string FrequenciesEstimator::class_name = "FrequenciesEstimator::";
+const float FrequenciesEstimator::minPeakEnergy = .2f;
 
-FrequenciesEstimator::FrequenciesEstimator(const Size& size, const int type)
+Mat FrequenciesEstimator::estimate(const Mat& fingerprint, Workspace& workspace) const
 {
-	this->frequencies = Mat::zeros(size, type);
-	this->regionMask = RegionMask(this->frequencies);
-}
+	workspace.frequencies = Mat::zeros(fingerprint.size(), CV_32F);
+	workspace.regionMask = RegionMask(fingerprint);
+	workspace.maxF = -1;
+	workspace.minF = INFINITY;
 
-Mat FrequenciesEstimator::estimate(const Mat& fingerprint)
-{
-	this->frequencies = Mat::zeros(fingerprint.size(), CV_32F);
-	this->regionMask = RegionMask(fingerprint);
-	
-	this->compute(fingerprint);
+	if (this->method == SPECTRUM)
+	{
+		this->computeSpectrum(fingerprint, workspace);
+	}
+	else
+	{
+		if (this->orientationBins > 0)
+		{
+			this->buildOffsets(workspace);
+		}
 
-	this->applyRegionMask();
+		this->compute(fingerprint, workspace);
+	}
+
+	this->applyRegionMask(workspace);
 
 	if (this->interpolation)
 	{
-		this->tmpFrequencies = Mat::zeros(this->frequencies.size(), this->frequencies.type());
+		workspace.tmpFrequencies = Mat::zeros(workspace.frequencies.size(), workspace.frequencies.type());
 		
-		this->interpolateFrequencies(fingerprint);
+		this->interpolateFrequencies(fingerprint, workspace);
 	}
 
 	if (this->isVerbose())
 	{
 		std::stringstream ss; ss << class_name << "estimate";
 
-		this->display(this->frequencies, ss.str());
+		this->display(workspace.frequencies, ss.str());
 	}
 
-	return this->frequencies;
+	return workspace.frequencies;
 }
 
 void FrequenciesEstimator::display(const Mat& frequencies, const std::string& trace) const
@@ -59,165 +70,333 @@ void FrequenciesEstimator::write(const Mat& frequencies, const std::string& path
 
 /////////////////////////////////////// Private members ///////////////////////////////////////
 
-void FrequenciesEstimator::compute(const Mat& fingerprint)
+void FrequenciesEstimator::compute(const Mat& fingerprint, Workspace& workspace) const
 {
+	Signal signature;
+	Peaks peaks, valleys;
+
 	for (auto i = this->blockSize / 2; i < fingerprint.rows; i += this->blockSize)
 	{
 		for (auto j = this->blockSize / 2; j < fingerprint.cols; j += this->blockSize)
 		{	
-			const auto signature = this->computeXSignature(i, j, fingerprint);
+			this->computeXSignature(i, j, fingerprint, workspace, signature);
 			
-			const auto peaks = findPeaks(signature);
+			findPeaks(signature, peaks, valleys);
 			
-			const auto avg = averagePeakDistance(peaks[0]);
+			const auto avg = averagePeakDistance(peaks);
 
 			const auto frequency = 1 / avg;
 
-			this->addBlockInfoToRegionMask(fingerprint, i, j, frequency, avg, peaks, signature);
+			const auto amplitude = RegionMask::amplitude(peaks.indices.data(), peaks.size, valleys.indices.data(), valleys.size, signature.values.data());
+
+			this->addBlockInfoToRegionMask(fingerprint, i, j, avg, amplitude > 0.2, workspace);
 			
-			this->placeFrequency(this->frequencies, i, j, frequency);
+			this->placeFrequency(workspace.frequencies, i, j, frequency);
 
-			this->maxMinFrequency(i, j);
+			this->maxMinFrequency(i, j, workspace);
 		}
 	}
 }
 
-std::vector<float> FrequenciesEstimator::computeXSignature(const int i, const int j, const Mat& fingerprint)
+void FrequenciesEstimator::computeSpectrum(const Mat& fingerprint, Workspace& workspace) const
 {
-	std::vector<float> blockXSignature;
-	
-	for (auto k = -this->windowSize / 2; k < this->windowSize / 2; k++)
+	const auto size = getOptimalDFTSize(this->windowSize);
+
+	Mat window;
+	createHanningWindow(window, Size(size, size), CV_32F);
+
+	const auto group = std::max(1, this->windowSize / 4 / this->blockSize);
+	const auto step = group * this->blockSize;
+
+	for (auto top = 0; top < fingerprint.rows; top += step)
 	{
-		auto sum = .0f;
-		auto count = 0;
-		
+		for (auto left = 0; left < fingerprint.cols; left += step)
+		{
+			const auto bottom = std::min(top + step, fingerprint.rows);
+			const auto right = std::min(left + step, fingerprint.cols);
+
+			auto energy = .0f;
+			const auto wavelength = dominantWavelength(fingerprint, (top + bottom) / 2, (left + right) / 2, window, energy);
+			const auto frequency = 1 / wavelength;
+
+			for (auto i = top + this->blockSize / 2; i < bottom; i += this->blockSize)
+			{
+				for (auto j = left + this->blockSize / 2; j < right; j += this->blockSize)
+				{
+					this->addBlockInfoToRegionMask(fingerprint, i, j, wavelength, energy > minPeakEnergy, workspace);
+
+					this->placeFrequency(workspace.frequencies, i, j, frequency);
+
+					this->maxMinFrequency(i, j, workspace);
+				}
+			}
+		}
+	}
+}
+
+float FrequenciesEstimator::dominantWavelength(const Mat& fingerprint, const int i, const int j, const Mat& window, float& energy)
+{
+	const auto size = window.rows;
+
+	// okno odtlacku bez strednej hodnoty, mimo odtlacku nulove
+	const Rect source(j - size / 2, i - size / 2, size, size);
+	const auto clipped = source & Rect(0, 0, fingerprint.cols, fingerprint.rows);
+
+	Mat patch = Mat::zeros(size, size, CV_32F);
+	auto inner = patch(Rect(clipped.x - source.x, clipped.y - source.y, clipped.width, clipped.height));
+	fingerprint(clipped).copyTo(inner);
+	subtract(inner, mean(inner), inner);
+	multiply(patch, window, patch);
+
+	Mat spectrum;
+	dft(patch, spectrum, DFT_COMPLEX_OUTPUT);
+
+	// pasmo frekvencii zodpovedajuce vzdialenosti linii 3 az 25 pixelov (500 DPI)
+	const auto minRadius = size / 25.0, maxRadius = size / 3.0;
+
+	auto band = .0, peak = .0;
+	auto peakU = 0, peakV = 0;
+	for (auto u = -size / 2; u < size - size / 2; u++)
+	{
+		const auto* row = spectrum.ptr<Vec2f>((u + size) % size);
+
+		for (auto v = -size / 2; v < size - size / 2; v++)
+		{
+			const auto radius = std::sqrt(static_cast<double>(u * u + v * v));
+			if (radius < minRadius || radius > maxRadius)
+			{
+				continue;
+			}
+
+			const auto& value = row[(v + size) % size];
+			const auto power = static_cast<double>(value[0]) * value[0] + static_cast<double>(value[1]) * value[1];
+
+			band += power;
+			if (power > peak)
+			{
+				peak = power;
+				peakU = u;
+				peakV = v;
+			}
+		}
+	}
+
+	energy = 0;
+	if (peak <= 0)
+	{
+		return -1;
+	}
+
+	// polomer vrcholu spresneny taziskom jeho okolia
+	auto lobe = .0, radius = .0;
+	for (auto du = -1; du <= 1; du++)
+	{
+		for (auto dv = -1; dv <= 1; dv++)
+		{
+			const auto u = peakU + du, v = peakV + dv;
+			const auto& value = spectrum.at<Vec2f>(((u % size) + size) % size, ((v % size) + size) % size);
+			const auto power = static_cast<double>(value[0]) * value[0] + static_cast<double>(value[1]) * value[1];
+
+			lobe += power;
+			radius += power * std::sqrt(static_cast<double>(u * u + v * v));
+		}
+	}
+
+	// spektrum realneho okna je symetricke, vrchol ma aj zrkadlovy obraz
+	energy = static_cast<float>(std::min(1.0, 2 * lobe / band));
+
+	const auto wavelength = static_cast<float>(size / (radius / lobe));
+
+	return wavelength < 3 || wavelength > 25 ? -1 : wavelength;
+}
+
+void FrequenciesEstimator::buildOffsets(Workspace& workspace) const
+{
+	const auto windowSize = std::min(this->windowSize / 2, maxWindow / 2) * 2;
+
+	workspace.offsets.resize(static_cast<std::size_t>(this->orientationBins) * this->blockSize * windowSize);
+	auto* offset = workspace.offsets.data();
+
+	for (auto bin = 0; bin < this->orientationBins; bin++)
+	{
+		const auto angle = CV_PI * bin / this->orientationBins - CV_PI / 2;
+		const auto s = sin(angle);
+		const auto c = cos(angle);
+
 		for (auto d = 0; d < this->blockSize; d++)
 		{
-			const auto angle = this->orientations.at<Vec2f>(i, j)[0] - CV_PI / 2;
-			
-			const auto u = round(i + (d - this->blockSize / 2.0) * sin(angle) + (0.5 - k) * cos(angle));
-			const auto v = round(j + (d - this->blockSize / 2.0) * cos(angle) + (k - 0.5) * sin(angle));
-			
-			if (u >= 0 && u < fingerprint.rows && v >= 0 && v < fingerprint.cols 
-				&& this->orientations.at<Vec2f>(u, v)[1] > 0)
+			for (auto k = -windowSize / 2; k < windowSize / 2; k++)
+			{
+				*offset++ = Point(
+					static_cast<int>(round((d - this->blockSize / 2.0) * c + (k - 0.5) * s)),
+					static_cast<int>(round((d - this->blockSize / 2.0) * s + (0.5 - k) * c))
+				);
+			}
+		}
+	}
+}
+
+void FrequenciesEstimator::computeXSignature(const int i, const int j, const Mat& fingerprint, const Workspace& workspace, Signal& signal) const
+{
+	const auto& orientations = workspace.orientations;
+	const auto windowSize = std::min(this->windowSize / 2, maxWindow / 2) * 2;
+	const auto orientation = orientations.at<Vec2f>(i, j)[0];
+
+	// uhol je pre cely blok rovnaky
+	const auto angle = orientation - CV_PI / 2;
+	const auto s = sin(angle);
+	const auto c = cos(angle);
+
+	const Point* table = nullptr;
+	if (this->orientationBins > 0)
+	{
+		auto bin = static_cast<int>(std::lround(orientation / CV_PI * this->orientationBins)) % this->orientationBins;
+		if (bin < 0)
+		{
+			bin += this->orientationBins;
+		}
+		table = workspace.offsets.data() + static_cast<std::size_t>(bin) * this->blockSize * windowSize;
+	}
+
+	std::array<float, maxWindow> sums, values;
+	std::array<int, maxWindow> counts, valid;
+	std::fill_n(sums.begin(), windowSize, .0f);
+	std::fill_n(counts.begin(), windowSize, 0);
+
+	for (auto d = 0; d < this->blockSize; d++)
+	{
+		// zber vzoriek jedneho riadku bloku pre vsetky vzorky okna
+		for (auto n = 0; n < windowSize; n++)
+		{
+			const auto k = n - windowSize / 2;
+
+			double u, v;
+			if (table)
+			{
+				const auto& offset = table[d * windowSize + n];
+				u = i + offset.y;
+				v = j + offset.x;
+			}
+			else
 			{
-				sum += fingerprint.at<float>(u, v);
-				count++;
+				u = round(i + (d - this->blockSize / 2.0) * s + (0.5 - k) * c);
+				v = round(j + (d - this->blockSize / 2.0) * c + (k - 0.5) * s);
 			}
+
+			valid[n] = u >= 0 && u < fingerprint.rows && v >= 0 && v < fingerprint.cols
+				&& orientations.at<Vec2f>(static_cast<int>(u), static_cast<int>(v))[1] > 0;
+			values[n] = valid[n] ? fingerprint.at<float>(static_cast<int>(u), static_cast<int>(v)) : .0f;
 		}
 
-		// otocim hodnoty opacne pretoze 0 reprezentuje ciernu, co znamena ze ide o liniu,
-		// chcem aby linia tvorila vrchol sinusoidy takze hodnoty obratim
-		blockXSignature.emplace_back(1 - sum / static_cast<float>(count));
+		// scitanie bez vetvenia, nulova vzorka sucet nemeni
+		for (auto n = 0; n < windowSize; n++)
+		{
+			sums[n] += values[n];
+			counts[n] += valid[n];
+		}
 	}
 
-	return blockXSignature;
+	// otocim hodnoty opacne pretoze 0 reprezentuje ciernu, co znamena ze ide o liniu,
+	// chcem aby linia tvorila vrchol sinusoidy takze hodnoty obratim
+	for (auto n = 0; n < windowSize; n++)
+	{
+		signal.values[n] = 1 - sums[n] / static_cast<float>(counts[n]);
+	}
+	signal.size = windowSize;
 }
 
-std::array<std::vector<int>, 2> FrequenciesEstimator::findPeaks(const std::vector<float>& signal)
+void FrequenciesEstimator::findPeaks(const Signal& signal, Peaks& peaks, Peaks& valleys)
 {
-	std::array<std::vector<int>, 2> indices;
+	const auto& values = signal.values;
+	const auto size = signal.size;
+
+	peaks.size = 0;
+	valleys.size = 0;
 
-	for (auto i = 0; i < signal.size(); i++)
+	for (auto i = 0; i < size; i++)
 	{
 		// vyska vrcholov
 		if (i == 0 
-			&& signal.at(i) > 0.5
-			&& signal.at(i) >= signal.at(i + 1.0))
+			&& values[i] > 0.5
+			&& values[i] >= values[i + 1])
 		{
-			validatePeak(i, indices[0], signal);
+			validatePeak(i, peaks, signal);
 		}
-		else if (i > 0 && i < signal.size() - 1
-			&& signal.at(i) > 0.5
-			&& signal.at(i - 1.0) <= signal.at(i)
-			&& signal.at(i) >= signal.at(i + 1.0))
+		else if (i > 0 && i < size - 1
+			&& values[i] > 0.5
+			&& values[i - 1] <= values[i]
+			&& values[i] >= values[i + 1])
 		{
-			validatePeak(i, indices[0], signal);
+			validatePeak(i, peaks, signal);
 		}
-		else if (i == signal.size() - 1 
-			&& signal.at(i) > 0.5
-			&& signal.at(i) >= signal.at(i - 1.0))
+		else if (i == size - 1 
+			&& values[i] > 0.5
+			&& values[i] >= values[i - 1])
 		{
-			validatePeak(i, indices[0], signal);
+			validatePeak(i, peaks, signal);
 		}
 
 		// hlbka priestorov medzi vrcholmi
 		if (i == 0
-			&& signal.at(i) < 0.5
-			&& signal.at(i) <= signal.at(i + 1.0))
+			&& values[i] < 0.5
+			&& values[i] <= values[i + 1])
 		{
-			validatePeak(i, indices[1], signal, true);
+			validatePeak(i, valleys, signal, true);
 		}
-		else if (i > 0 && i < signal.size() - 1
-			&& signal.at(i - 1.0) >= signal.at(i)
-			&& signal.at(i) <= signal.at(i + 1.0))
+		else if (i > 0 && i < size - 1
+			&& values[i - 1] >= values[i]
+			&& values[i] <= values[i + 1])
 		{
-			validatePeak(i, indices[1], signal, true);
+			validatePeak(i, valleys, signal, true);
 		}
-		else if (i == signal.size() - 1
-			&& signal.at(i) < 0.5
-			&& signal.at(i) <= signal.at(i - 1.0))
+		else if (i == size - 1
+			&& values[i] < 0.5
+			&& values[i] <= values[i - 1])
 		{
-			validatePeak(i, indices[1], signal, true);
+			validatePeak(i, valleys, signal, true);
 		}
 	}
-	
-	return indices;
 }
 
-void FrequenciesEstimator::validatePeak(const int index, std::vector<int>& indices, const std::vector<float>& signal, const bool valley)
+void FrequenciesEstimator::validatePeak(const int index, Peaks& indices, const Signal& signal, const bool valley)
 {
-	if (!indices.empty())
-	{
-		const auto last = indices.back();
+	auto& last = indices.indices[indices.size > 0 ? indices.size - 1 : 0];
 
+	if (indices.size > 0)
+	{
 		// pozriem ako daleko som od posledneho
 		if (index - last > 6)
 		{
 			// som dalej
-			indices.push_back(index);
+			indices.indices[indices.size++] = index;
 		}
 		else
 		{
-			// nie som
-			if (valley)
-			{
-				// ma vhodnejsiu hodnotu?
-				if (signal.at(index) < signal.at(last))
-				{
-					indices.pop_back();
-					indices.push_back(index);
-				}
-			}
-			else
+			// nie som, nahradim posledny ak ma vhodnejsiu hodnotu
+			if (valley ? signal.values[index] < signal.values[last] : signal.values[index] > signal.values[last])
 			{
-				// ma vhodnejsiu hodnotu?
-				if (signal.at(index) > signal.at(last))
-				{
-					indices.pop_back();
-					indices.push_back(index);
-				}
+				last = index;
 			}
 		}
 	}
 	else
 	{
-		indices.push_back(index);
+		indices.indices[indices.size++] = index;
 	}
 }
 
-float FrequenciesEstimator::averagePeakDistance(const std::vector<int>& peaks)
+float FrequenciesEstimator::averagePeakDistance(const Peaks& peaks)
 {
 	float avg = -1;
-	if (peaks.size() > 1)
+	if (peaks.size > 1)
 	{
 		auto sum = .0f;
-		for (auto l = 0; l < peaks.size() - 1; l++)
+		for (auto l = 0; l < peaks.size - 1; l++)
 		{
-			sum += peaks.at(l + 1) - peaks.at(l);
+			sum += peaks.indices[l + 1] - peaks.indices[l];
 		}
 
-		avg = sum / static_cast<float>(peaks.size() - 1);
+		avg = sum / static_cast<float>(peaks.size - 1);
 
 		// toto nemoze prekrocit 500 DPI obrazok
 		if (avg < 3 || avg > 25)
@@ -240,29 +419,33 @@ void FrequenciesEstimator::placeFrequency(Mat& map, const int i, const int j, co
 	}
 }
 
-void FrequenciesEstimator::maxMinFrequency(const int i, const int j)
+void FrequenciesEstimator::maxMinFrequency(const int i, const int j, Workspace& workspace) const
 {
-	if (this->maxF < this->frequencies.at<float>(i, j))
+	const auto frequency = workspace.frequencies.at<float>(i, j);
+	
+	if (workspace.maxF < frequency)
 	{
-		this->maxF = this->frequencies.at<float>(i, j);
+		workspace.maxF = frequency;
 	}
 
-	if (this->frequencies.at<float>(i, j) != -1
-		&& this->minF > this->frequencies.at<float>(i, j))
+	if (frequency != -1
+		&& workspace.minF > frequency)
 	{
-		this->minF = this->frequencies.at<float>(i, j);
+		workspace.minF = frequency;
 	}
 }
 
-void FrequenciesEstimator::interpolateFrequencies(const Mat& fingerprint)
+void FrequenciesEstimator::interpolateFrequencies(const Mat& fingerprint, Workspace& workspace) const
 {
-	const auto filtered = ImageProcessor::getBlurred(this->frequencies, 7 * blockSize, 9 * blockSize);
+	auto& frequencies = workspace.frequencies;
+	
+	const auto filtered = ImageProcessor::getBlurred(frequencies, 7 * blockSize, 9 * blockSize);
 
-	for (auto i = this->blockSize / 2; i < this->frequencies.rows; i += this->blockSize)
+	for (auto i = this->blockSize / 2; i < frequencies.rows; i += this->blockSize)
 	{
-		for (auto j = this->blockSize / 2; j < this->frequencies.cols; j += this->blockSize)
+		for (auto j = this->blockSize / 2; j < frequencies.cols; j += this->blockSize)
 		{
-			auto freq = this->frequencies.at<float>(i, j);
+			auto freq = frequencies.at<float>(i, j);
 
 			// nepodareny odhad frekvencie, interpolujem
 			if (freq == -1)
@@ -270,9 +453,9 @@ void FrequenciesEstimator::interpolateFrequencies(const Mat& fingerprint)
 				auto top = .0f;
 				auto bottom = .0f;
 
-				for (auto x = -this->blockSize; x <= this->blockSize && i + x < this->frequencies.rows && i + x > 0; x += blockSize)
+				for (auto x = -this->blockSize; x <= this->blockSize && i + x < frequencies.rows && i + x > 0; x += blockSize)
 				{
-					for (auto y = -this->blockSize; y <= this->blockSize && j + y < this->frequencies.cols && j + y > 0; y += blockSize)
+					for (auto y = -this->blockSize; y <= this->blockSize && j + y < frequencies.cols && j + y > 0; y += blockSize)
 					{
 						const auto filteredFreq = filtered.at<float>(i + x, j + y);
 
@@ -293,16 +476,16 @@ void FrequenciesEstimator::interpolateFrequencies(const Mat& fingerprint)
 				}
 			}
 
-			this->placeFrequency(this->tmpFrequencies, i, j, freq);
+			this->placeFrequency(workspace.tmpFrequencies, i, j, freq);
 		}
 	}
 
 	// vyhladim frekvencie
-	this->frequencies = ImageProcessor::getBlurred(this->frequencies, 7 * blockSize, 9 * blockSize);
+	frequencies = ImageProcessor::getBlurred(frequencies, 7 * blockSize, 9 * blockSize);
 }
 
-void FrequenciesEstimator::addBlockInfoToRegionMask(const Mat& img, const int i, const int j, const float frequency, const float peakDistance,
-	const std::array<std::vector<int>, 2>& peaks, const std::vector<float>& signal)
+void FrequenciesEstimator::addBlockInfoToRegionMask(const Mat& img, const int i, const int j, const float peakDistance, const bool periodic,
+	Workspace& workspace) const
 {
 	// check bounds of img
 	const auto width = img.size().width;
@@ -316,39 +499,40 @@ void FrequenciesEstimator::addBlockInfoToRegionMask(const Mat& img, const int i,
 	meanStdDev(block, mean, dev);
 	const auto var = pow(dev.val[0], 2);
 
-	const auto amplitude = RegionMask::amplitude(peaks, signal);
-
 	// jedna sa o popredie odtlacku?
 	auto recoverable = false;
-	if (amplitude > 0.2 && var > 0.01 && peakDistance != -1)
+	if (periodic && var > 0.01 && peakDistance != -1)
 	{
 		// pridam vzdialenost vrcholov sinusoidy do regionalnej masky (vyuzijem to
 		// pri vylepseni kvality)
 		recoverable = true;
-		this->regionMask.addPeaksDistance(peakDistance);
+		workspace.regionMask.addPeaksDistance(peakDistance);
 	}
 
 	// ulozim informaciu o regione
-	this->regionMask.at<float>(i, j) = recoverable ? 1 : 0;
+	workspace.regionMask.at<float>(i, j) = recoverable ? 1 : 0;
 }
 
-void FrequenciesEstimator::applyRegionMask()
+void FrequenciesEstimator::applyRegionMask(Workspace& workspace) const
 {
+	auto& regionMask = workspace.regionMask;
+	auto& frequencies = workspace.frequencies;
+	
 	// vyplnim priestory v odtlacku
-	const auto region = ImageProcessor::correctSegmentation(this->regionMask, this->blockSize);
+	const auto region = ImageProcessor::correctSegmentation(regionMask, this->blockSize);
 	regionMask.setRegion(region);
 
 	// orezem vlastnosti a aj masku aby som neukladal zbytocne prazdne priestory
-	ImageProcessor::trim(this->regionMask, region);
-	ImageProcessor::trim(this->frequencies, region);
+	ImageProcessor::trim(regionMask, region);
+	ImageProcessor::trim(frequencies, region);
 
-	for (auto i = blockSize / 2; i < this->frequencies.rows; i += blockSize)
+	for (auto i = blockSize / 2; i < frequencies.rows; i += blockSize)
 	{
-		for (auto j = blockSize / 2; j < this->frequencies.cols; j += blockSize)
+		for (auto j = blockSize / 2; j < frequencies.cols; j += blockSize)
 		{
-			if (this->regionMask.at<float>(i, j) == 0)
+			if (regionMask.at<float>(i, j) == 0)
 			{
-				this->placeFrequency(this->frequencies, i, j, 0);
+				this->placeFrequency(frequencies, i, j, 0);
 			}
 		}
 	}
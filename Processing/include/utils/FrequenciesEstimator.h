@@ -4,6 +4,10 @@
 
 #include <opencv2/opencv.hpp>
 
+#include <array>
+#include <atomic>
+#include <vector>
+
 namespace processing
 {
 	namespace utils
@@ -15,80 +19,166 @@ namespace processing
 		 */
 		class FrequenciesEstimator final
 		{
-		private:
-			// members
+		public:
 			/**
-			 * \brief Velkost spracovavaneho bloku.
+			 * \brief Sposob odhadu frekvencii: pocitanie vrcholov x-signatury
+			 * alebo dominantna frekvencia spektra okna.
 			 */
-			int blockSize = 8;
+			enum Method { SIGNATURE = 0, SPECTRUM };
+
 			/**
-			 * \brief Velkost orientovaneho okna.
+			 * \brief Pracovne data jedneho odhadu frekvencii. Okrem medzivysledkov
+			 * obsahuje aj vstupne orientacie a vedlajsie produkty odhadu (regionalnu
+			 * masku a extremy frekvencii), aby konfiguracia odhadu zostala nemenna.
 			 */
-			int windowSize = 16;
+			struct Workspace
+			{
+				/**
+				 * \brief Lokalne orientacie.
+				 */
+				cv::Mat orientations;
+				/**
+				 * \brief Regionalna maska.
+				 */
+				RegionMask regionMask;
+				/**
+				 * \brief Lokalne frekvencie.
+				 */
+				cv::Mat frequencies;
+				/**
+				 * \brief Pomocne ulozisko pre frekvencie.
+				 */
+				cv::Mat tmpFrequencies;
+				/**
+				 * \brief Maximalna frekvencia.
+				 */
+				float maxF = -1;
+				/**
+				 * \brief Minimalna frekvencia.
+				 */
+				float minF = INFINITY;
+				/**
+				 * \brief Posunutia vzoriek x-signatury pre kvantovane orientacie, po
+				 * orientaciach, vzorkach bloku a vzorkach okna.
+				 */
+				std::vector<cv::Point> offsets;
 
+				// constructors
+				explicit Workspace(const cv::Mat& orientations) : orientations(orientations) {}
+			};
+
+		private:
 			/**
-			 * \brief Lokalne orientacie.
+			 * \brief Najvacsi pocet vzoriek x-signatury, dlhsie okno sa skrati.
 			 */
-			cv::Mat orientations;
+			static const int maxWindow = 256;
+
 			/**
-			 * \brief Regionalna maska.
+			 * \brief X-signatura bloku v pevnom ulozisku.
 			 */
-			RegionMask regionMask;
-			
+			struct Signal
+			{
+				std::array<float, maxWindow> values;
+				int size = 0;
+			};
+
 			/**
-			 * \brief Indikator interpolacie.
+			 * \brief Pozicie vrcholov alebo priehlbin x-signatury v pevnom ulozisku.
 			 */
-			bool interpolation = false;
+			struct Peaks
+			{
+				std::array<int, maxWindow> indices;
+				int size = 0;
+			};
 
+			// members
 			/**
-			 * \brief Lokalne frekvencie.
+			 * \brief Velkost spracovavaneho bloku.
 			 */
-			cv::Mat frequencies;
+			int blockSize = 8;
 			/**
-			 * \brief Pomocne ulozisko pre frekvencie.
+			 * \brief Velkost orientovaneho okna.
 			 */
-			cv::Mat tmpFrequencies;
-
+			int windowSize = 16;
 			/**
-			 * \brief Indikator vizualnych vystupov.
+			 * \brief Pocet kvantovanych orientacii tabuliek posunuti x-signatury,
+			 * 0 pocita posunutia presne pre orientaciu kazdeho bloku.
 			 */
-			bool verboseOutput = false;
+			int orientationBins = 0;
+			/**
+			 * \brief Sposob odhadu frekvencii.
+			 */
+			Method method = SIGNATURE;
 
 			/**
-			 * \brief Maximalna frekvencia.
+			 * \brief Indikator interpolacie.
 			 */
-			float maxF = -1;
+			bool interpolation = false;
+
 			/**
-			 * \brief Minimalna frekvencia.
+			 * \brief Indikator vizualnych vystupov.
 			 */
-			float minF = INFINITY;
+			bool verboseOutput = false;
 
 			// static members
 			/**
 			 * \brief Pocet zobrazeni frekvencii.
 			 */
-			static int displayed;
+			static std::atomic<int> displayed;
+			/**
+			 * \brief Najmensi podiel energie dominantneho vrcholu spektra na energii
+			 * pasma frekvencii linii, pri ktorom je blok popredim.
+			 */
+			static const float minPeakEnergy;
 
 			// methods
 			/**
 			 * \brief Extrahuje frekvencie z odtlacku.
 			 * \param normalizovany odtlacok
+			 * \param workspace pracovne data odhadu
 			 */
-			void compute(const cv::Mat& fingerprint);
+			void compute(const cv::Mat& fingerprint, Workspace& workspace) const;
 			/**
-			 * \brief Odhadne x-signaturu na pozicii [i,j].
+			 * \brief Extrahuje frekvencie z dominantneho vrcholu spektra okna. Okno
+			 * sa vyhodnoti raz pre skupinu susednych blokov, ktorych okna sa aj tak
+			 * z vacsej casti prekryvaju.
+			 * \param fingerprint normalizovany odtlacok
+			 * \param workspace pracovne data odhadu
+			 */
+			void computeSpectrum(const cv::Mat& fingerprint, Workspace& workspace) const;
+			/**
+			 * \brief Najde dominantnu vlnovu dlzku linii v okne so stredom [i, j].
+			 * \param fingerprint normalizovany odtlacok
+			 * \param i pozicia i
+			 * \param j pozicia j
+			 * \param window vahovacie okno velkosti spektra
+			 * \param energy sem sa ulozi podiel energie dominantneho vrcholu
+			 * \return vlnova dlzka, -1 ak okno neobsahuje ziadne linie
+			 */
+			static float dominantWavelength(const cv::Mat& fingerprint, int i, int j, const cv::Mat& window, float& energy);
+			/**
+			 * \brief Zostavi tabulky posunuti vzoriek x-signatury pre kvantovane orientacie.
+			 * \param workspace pracovne data odhadu
+			 */
+			void buildOffsets(Workspace& workspace) const;
+			/**
+			 * \brief Odhadne x-signaturu na pozicii [i,j]. Vzorky sa zbieraju po riadkoch
+			 * bloku a scitavaju pre vsetky vzorky okna naraz, poradie scitania kazdej
+			 * vzorky okna ostava zachovane.
 			 * \param i pozicia i
 			 * \param j pozicia j
 			 * \param fingerprint odtlacok 
-			 * \return sinusoidu
+			 * \param workspace pracovne data odhadu
+			 * \param signal sem sa ulozi sinusoida
 			 */
-			std::vector<float> computeXSignature(int i, int j, const cv::Mat& fingerprint);
+			void computeXSignature(int i, int j, const cv::Mat& fingerprint, const Workspace& workspace, Signal& signal) const;
 			/**
 			 * \brief Najde vrcholy sinusoida.
 			 * \param signal sinusoida
-			 * \return 
+			 * \param peaks sem sa ulozia vrcholy
+			 * \param valleys sem sa ulozia priehlbiny
 			 */
-			static std::array<std::vector<int>, 2> findPeaks(const std::vector<float>& signal);
+			static void findPeaks(const Signal& signal, Peaks& peaks, Peaks& valleys);
 			/**
 			 * \brief Zisti ci dany bod na sinusoide moze byt vrchol.
 			 * \param index pozicia
@@ -96,13 +186,13 @@ namespace processing
 			 * \param signal sinusoida
 			 * \param valley idikator priehlbiny
 			 */
-			static void validatePeak(int index, std::vector<int>& indices, const std::vector<float>& signal, bool valley = false);
+			static void validatePeak(int index, Peaks& indices, const Signal& signal, bool valley = false);
 			/**
 			 * \brief Priemerna vzdialenost vrcholov.
 			 * \param peaks vrcholy
 			 * \return vzdialenost
 			 */
-			static float averagePeakDistance(const std::vector<int>& peaks);
+			static float averagePeakDistance(const Peaks& peaks);
 			/**
 			 * \brief Rozlozi frekvenciu na mapu na pozicii [i, j].
 			 * \param map mapa
@@ -116,29 +206,30 @@ namespace processing
 			 * na pozicii [i, j].
 			 * \param i pozicia i
 			 * \param j pozicia j
+			 * \param workspace pracovne data odhadu
 			 */
-			void maxMinFrequency(int i, int j);
+			void maxMinFrequency(int i, int j, Workspace& workspace) const;
 			/**
 			 * \brief Interpoluje frekvencie, ktore sa nepodarilo odhadnut.
 			 * \param fingerprint obrazok odtlacku
+			 * \param workspace pracovne data odhadu
 			 */
-			void interpolateFrequencies(const cv::Mat& fingerprint);
+			void interpolateFrequencies(const cv::Mat& fingerprint, Workspace& workspace) const;
 			/**
 			 * \brief Zisti informacie o prehladavanom aktualnom bloku a ulozi ich do regionalnej masky.
 			 * \param img obrazok odtlacku
 			 * \param i pozicia i
 			 * \param j pozicia j
-			 * \param frequency frekvencia
 			 * \param peakDistance vzdialenost vrcholov
-			 * \param peaks vrcholy
-			 * \param signal sinusoida
+			 * \param periodic indikator vyraznej periodicity bloku
+			 * \param workspace pracovne data odhadu
 			 */
-			void addBlockInfoToRegionMask(const cv::Mat& img, int i, int j, float frequency, float peakDistance, 
-				const std::array<std::vector<int>, 2>& peaks, const std::vector<float>& signal);
+			void addBlockInfoToRegionMask(const cv::Mat& img, int i, int j, float peakDistance, bool periodic, Workspace& workspace) const;
 			/**
 			 * \brief Aplikuje inofrm=acie o regine na frekvencie.
+			 * \param workspace pracovne data odhadu
 			 */
-			void applyRegionMask();
+			void applyRegionMask(Workspace& workspace) const;
 
 		public:
 			// static members
@@ -146,15 +237,15 @@ namespace processing
 			
 			// constructors
 			FrequenciesEstimator() = default;
-			FrequenciesEstimator(const cv::Size& size, int type);
 
 			// methods
 			/**
 			 * \brief Odhadne frekencie a odtlacku.
 			 * \param fingerprint odtlacok
+			 * \param workspace pracovne data odhadu so vstupnymi orientaciami
 			 * \return frekvencie
 			 */
-			cv::Mat estimate(const cv::Mat& fingerprint);
+			cv::Mat estimate(const cv::Mat& fingerprint, Workspace& workspace) const;
 			
 			/**
 			 * \brief Zobrazi frekvencie spolu s cestou odkial bola metoda zavolana.
@@ -172,18 +263,16 @@ namespace processing
 			// getters
 			int getBlockSize() const { return this->blockSize; }
 			int getWindowSize() const { return this->windowSize; }
-			cv::Mat getFrequencies() const { return this->frequencies; }
-			cv::Mat getOrientations() const { return this->orientations; }
 			bool isInterpolated() const { return this->interpolation; }
-			float getMaxFrequency() const { return this->maxF; }
-			float getMinFrequency() const { return this->minF; }
+			int getOrientationBins() const { return this->orientationBins; }
+			Method getMethod() const { return this->method; }
 			bool isVerbose() const { return this->verboseOutput; }
-			RegionMask getRegionMask() const { return this->regionMask; }
 			
 			// setters
 			FrequenciesEstimator& setBlockSize(const int blockSize) { this->blockSize = blockSize; return *this; }
-			FrequenciesEstimator& setOrientations(const cv::Mat& orientations) { this->orientations = orientations; return *this; }
 			FrequenciesEstimator& setWindowSize(const int windowSize) { this->windowSize = windowSize; return *this; }
+			FrequenciesEstimator& setMethod(const Method method) { this->method = method; return *this; }
+			FrequenciesEstimator& setOrientationBins(const int orientationBins) { this->orientationBins = orientationBins; return *this; }
 			FrequenciesEstimator& interpolate(const bool interpolation = true) { this->interpolation = interpolation; return  *this; }
 			FrequenciesEstimator& verbose(const bool verboseOutput = true) { this->verboseOutput = verboseOutput; return *this; }
 
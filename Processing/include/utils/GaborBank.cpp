@@ -0,0 +1,77 @@
+#include "GaborBank.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace processing::utils;
+using namespace cv;
+
+const float GaborBank::minWavelength = 3;
+const float GaborBank::maxWavelength = 25;
+
+GaborBank::Kernels::Kernels(const int blockSize, const float deviation, const int orientations, const int wavelengths)
+	: orientations(orientations), wavelengths(wavelengths)
+{
+	TickMeter tm; tm.start();
+
+	this->kernels.reserve(static_cast<std::size_t>(orientations) * wavelengths);
+
+	for (auto o = 0; o < orientations; o++)
+	{
+		const auto orientation = CV_PI * o / orientations;
+
+		for (auto w = 0; w < wavelengths; w++)
+		{
+			const auto wavelength = wavelengths > 1
+				? minWavelength + (maxWavelength - minWavelength) * w / (wavelengths - 1)
+				: (minWavelength + maxWavelength) / 2;
+
+			this->kernels.emplace_back(getGaborKernel(
+				Size(blockSize, blockSize), deviation,
+				orientation, wavelength, 1, 0, CV_32F
+			));
+		}
+	}
+
+	tm.stop();
+	this->buildTime = tm.getTimeMilli();
+}
+
+int GaborBank::Kernels::index(const float orientation, const float frequency) const
+{
+	// jadro s nulovou fazou je periodicke v orientacii s periodou pi
+	auto o = static_cast<int>(std::lround(orientation / CV_PI * this->orientations)) % this->orientations;
+	if (o < 0)
+	{
+		o += this->orientations;
+	}
+
+	const auto w = static_cast<int>(std::lround(this->position(frequency)));
+
+	return o * this->wavelengths + w;
+}
+
+float GaborBank::Kernels::position(const float frequency) const
+{
+	// neplatna frekvencia padne do najmensej vlnovej dlzky
+	auto wavelength = 1 / frequency;
+	if (!(wavelength > minWavelength)) wavelength = minWavelength;
+	if (wavelength > maxWavelength) wavelength = maxWavelength;
+
+	return this->wavelengths > 1
+		? (wavelength - minWavelength) / (maxWavelength - minWavelength) * (this->wavelengths - 1)
+		: .0f;
+}
+
+std::shared_ptr<const GaborBank::Kernels> GaborBank::get(const int blockSize, const float deviation)
+{
+	std::lock_guard<std::mutex> guard(this->lock);
+
+	auto& kernels = this->kernels[Key(blockSize, deviation)];
+	if (!kernels)
+	{
+		kernels = std::make_shared<const Kernels>(blockSize, deviation, this->orientations, this->wavelengths);
+	}
+
+	return kernels;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace processing
+{
+	namespace utils
+	{
+		/**
+		 * \brief Banka Gaborovych jadier kvantovanych podla orientacie a vlnovej dlzky.
+		 * Jadra su vytvorene raz pre kazdu velkost bloku a odchylku a zdielane
+		 * vsetkymi filtrami a vlaknami iba na citanie.
+		 */
+		class GaborBank
+		{
+		public:
+			/**
+			 * \brief Jadra pre jednu velkost bloku a odchylku.
+			 */
+			class Kernels
+			{
+			private:
+				// members
+				/**
+				 * \brief Pocet kvantovanych orientacii v intervale [0, pi).
+				 */
+				int orientations;
+				/**
+				 * \brief Pocet kvantovanych vlnovych dlzok.
+				 */
+				int wavelengths;
+				/**
+				 * \brief Jadra, orientacie su ulozene po riadkoch.
+				 */
+				std::vector<cv::Mat> kernels;
+				/**
+				 * \brief Cas vytvorenia jadier v ms.
+				 */
+				double buildTime = 0;
+
+			public:
+				// constructors
+				/**
+				 * \brief Vytvori vsetky jadra.
+				 * \param blockSize velkost bloku
+				 * \param deviation odchylka
+				 * \param orientations pocet kvantovanych orientacii
+				 * \param wavelengths pocet kvantovanych vlnovych dlzok
+				 */
+				Kernels(int blockSize, float deviation, int orientations, int wavelengths);
+
+				// methods
+				/**
+				 * \brief Zisti poradie jadra najblizsieho lokalnej orientacii a frekvencii.
+				 * \param orientation lokalna orientacia
+				 * \param frequency lokalna frekvencia
+				 * \return poradie jadra
+				 */
+				int index(float orientation, float frequency) const;
+				/**
+				 * \brief Zisti spojitu poziciu lokalnej frekvencie medzi kvantovanymi vlnovymi dlzkami.
+				 * \param frequency lokalna frekvencia
+				 * \return pozicia v intervale [0, pocet vlnovych dlzok - 1]
+				 */
+				float position(float frequency) const;
+				/**
+				 * \brief Vyhlada jadro najblizsie lokalnej orientacii a frekvencii.
+				 * \param orientation lokalna orientacia
+				 * \param frequency lokalna frekvencia
+				 * \return jadro
+				 */
+				const cv::Mat& at(const float orientation, const float frequency) const { return this->kernels[this->index(orientation, frequency)]; }
+				/**
+				 * \brief Vrati jadro podla poradia.
+				 * \param index poradie jadra
+				 * \return jadro
+				 */
+				const cv::Mat& at(const int index) const { return this->kernels[index]; }
+
+				// getters
+				std::size_t size() const { return this->kernels.size(); }
+				int getOrientations() const { return this->orientations; }
+				int getWavelengths() const { return this->wavelengths; }
+				double getBuildTime() const { return this->buildTime; }
+			};
+
+		private:
+			/**
+			 * \brief Kluc jadier: velkost bloku a odchylka.
+			 */
+			using Key = std::pair<int, float>;
+
+			// members
+			/**
+			 * \brief Pocet kvantovanych orientacii.
+			 */
+			int orientations;
+			/**
+			 * \brief Pocet kvantovanych vlnovych dlzok.
+			 */
+			int wavelengths;
+			/**
+			 * \brief Vytvorene jadra podla kluca.
+			 */
+			std::map<Key, std::shared_ptr<const Kernels>> kernels;
+			/**
+			 * \brief Zamok jadier.
+			 */
+			mutable std::mutex lock;
+
+		public:
+			// static members
+			/**
+			 * \brief Najmensia kvantovana vlnova dlzka (vzdialenost linii) v pixeloch.
+			 */
+			static const float minWavelength;
+			/**
+			 * \brief Najvacsia kvantovana vlnova dlzka (vzdialenost linii) v pixeloch.
+			 */
+			static const float maxWavelength;
+
+			// constructors
+			/**
+			 * \param orientations pocet kvantovanych orientacii
+			 * \param wavelengths pocet kvantovanych vlnovych dlzok
+			 */
+			explicit GaborBank(int orientations = 32, int wavelengths = 16)
+				: orientations(std::max(orientations, 1)), wavelengths(std::max(wavelengths, 1)) {}
+
+			// methods
+			/**
+			 * \brief Vrati jadra pre velkost bloku a odchylku, pri prvom pouziti ich vytvori.
+			 * \param blockSize velkost bloku
+			 * \param deviation odchylka
+			 * \return jadra
+			 */
+			std::shared_ptr<const Kernels> get(int blockSize, float deviation);
+
+			// getters
+			int getOrientations() const { return this->orientations; }
+			int getWavelengths() const { return this->wavelengths; }
+			std::size_t size() const { std::lock_guard<std::mutex> guard(this->lock); return this->kernels.size(); }
+		};
+	}
+}
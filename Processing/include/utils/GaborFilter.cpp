@@ -2,98 +2,277 @@
 #include "exceptions/KernelSizeIsNotOdd.h"
 #include "ImageProcessor.h"
 
+#include <algorithm>
+#include <numeric>
+
 using namespace processing::utils;
 using namespace cv;
 
-int GaborFilter::displayed = 0;
+std::atomic<int> GaborFilter::displayed(0);
 const std::string GaborFilter::class_name = "GaborFilter::";
 
-Mat GaborFilter::filter(const Mat& fingerprint)
+Mat GaborFilter::filter(const Mat& fingerprint, const Mat& orientations, const Mat& frequencies) const
+{
+	Workspace workspace(orientations, frequencies, this->blockSize);
+
+	return this->filter(fingerprint, workspace);
+}
+
+Mat GaborFilter::filter(const Mat& fingerprint, Workspace& workspace) const
 {
-	if (this->blockSize % 2 == 0)
+	if (workspace.blockSize % 2 == 0)
 	{
 		throw exception::KernelSizeIsNotOdd();
 	}
 
-	this->filtered = Mat::ones(fingerprint.size(), fingerprint.type());
+	workspace.filtered = Mat::ones(fingerprint.size(), fingerprint.type());
 	
-	fingerprint.copyTo(this->filtered);
+	fingerprint.copyTo(workspace.filtered);
 
-	this->filterImage();
+	if (this->compositeOutput)
+	{
+		// banku nainstaluje uz composite(), setBank(nullptr) ju vsak moze odobrat
+		CV_Assert(this->bank);
+		const auto kernels = this->bank->get(workspace.blockSize, this->deviation);
+
+		this->filterComposite(fingerprint, workspace, *kernels);
+	}
+	else
+	{
+		this->filterImage(workspace);
+	}
 
 	if (this->isVerbose())
 	{
 		std::stringstream ss; ss << class_name << "filter";
 
-		this->display(this->filtered, ss.str());
+		this->display(workspace.filtered, ss.str());
 	}
 	
-	return this->filtered;
+	return workspace.filtered;
 }
 
-void GaborFilter::filterImage()
+void GaborFilter::filterImage(Workspace& workspace) const
 {
-	for (auto offset = -this->blockSize / 2; offset <= this->blockSize / 2; offset++)
+	const auto blockSize = workspace.blockSize;
+	const auto kernels = this->bank ? this->bank->get(blockSize, this->deviation) : nullptr;
+	
+	for (auto offset = -blockSize / 2; offset <= blockSize / 2; offset++)
 	{
-		for (auto i = offset; i < this->filtered.rows; i += this->blockSize)
+		for (auto i = offset; i < workspace.filtered.rows; i += blockSize)
 		{
-			for (auto j = offset; j < this->filtered.cols; j += this->blockSize)
+			for (auto j = offset; j < workspace.filtered.cols; j += blockSize)
 			{
 				if (i < 0 || j < 0) continue;
 
-				const auto orientation = this->orientations.at<Vec2f>(i, j)[0];
-				const auto frequency = this->frequencies.at<float>(i, j);
+				const auto orientation = workspace.orientations.at<Vec2f>(i, j)[0];
+				const auto frequency = workspace.frequencies.at<float>(i, j);
 
 				// pozriem co filtrujem, aby gaborov filter nezanasal chybu, ak som mimo obrazka,
 				// vyplnim ho ciernym blokom, kvoli krajsiemu vyzualnemu vystupu a pre zjednodusenie
 				// stencenia priestorov medzi liniami
-				if (!this->isFilterable(i, j))
+				if (!this->isFilterable(i, j, workspace))
 				{
-					auto b = this->blockAt(this->frequencies, i, j);
+					auto b = this->blockAt(workspace.frequencies, i, j, workspace);
 					b = Mat::zeros(b.rows, b.cols, CV_32F);
-					this->blockCopyTo(b, this->filtered, i, j);
+					this->blockCopyTo(b, workspace.filtered, i, j, workspace);
 
 					continue;
 				}
 
-				auto block = this->blockAt(this->filtered, i, j);
+				auto block = this->blockAt(workspace.filtered, i, j, workspace);
 
-				this->filterBlock(block, orientation, frequency);
+				if (kernels)
+				{
+					filterBlock(block, kernels->at(orientation, frequency));
+				}
+				else
+				{
+					this->filterBlock(block, orientation, frequency, blockSize);
+				}
 
-				this->blockCopyTo(block, this->filtered, i, j);
+				this->blockCopyTo(block, workspace.filtered, i, j, workspace);
 			}
 		}
 	}
 }
 
-cv::Mat GaborFilter::blockAt(const Mat& fingerprint, const int i, const int j) const
+void GaborFilter::filterComposite(const Mat& fingerprint, Workspace& workspace, const GaborBank::Kernels& kernels) const
 {
-	const auto h = ((this->filtered.rows - i) < this->blockSize / 2 + 1) ? this->blockSize / 2 + (this->filtered.rows - i) : this->blockSize;
-	const auto w = ((this->filtered.cols - j) < this->blockSize / 2 + 1) ? this->blockSize / 2 + (this->filtered.cols - j) : this->blockSize;
+	const auto blockSize = workspace.blockSize;
+	const auto size = fingerprint.size();
 
-	const auto x = j - this->blockSize / 2 < 0 ? 0 : j - this->blockSize / 2;
-	const auto y = i - this->blockSize / 2 < 0 ? 0 : i - this->blockSize / 2;
+	const auto orientationBins = kernels.getOrientations();
+	const auto wavelengthBins = kernels.getWavelengths();
 
-	auto block = this->filtered(Rect(x, y, w, h));
+	// orientacia a spojita pozicia vlnovej dlzky kazdeho filtrovatelneho bodu, oblasti
+	// bodov jednotlivych orientacii a histogram kvantovanych vlnovych dlziek kazdej orientacie
+	Mat indices(size, CV_32S, Scalar(-1));
+	Mat positions(size, CV_32F, Scalar(0));
+	Mat mask = Mat::zeros(size, CV_8U);
+	std::vector<Rect> regions(orientationBins);
+	std::vector<std::vector<int>> histograms(orientationBins, std::vector<int>(wavelengthBins, 0));
+
+	for (auto i = 0; i < size.height; i++)
+	{
+		const auto* orientations = workspace.orientations.ptr<Vec2f>(i);
+		const auto* frequencies = workspace.frequencies.ptr<float>(i);
+		auto* index = indices.ptr<int>(i);
+		auto* position = positions.ptr<float>(i);
+
+		for (auto j = 0; j < size.width; j++)
+		{
+			if (!this->isFilterable(i, j, workspace))
+			{
+				continue;
+			}
+
+			const auto kernel = kernels.index(orientations[j][0], frequencies[j]);
+			index[j] = kernel / wavelengthBins;
+			position[j] = kernels.position(frequencies[j]);
+			histograms[index[j]][kernel % wavelengthBins]++;
+			mask.at<uchar>(i, j) = 1;
+
+			auto& region = regions[index[j]];
+			region = region.empty() ? Rect(j, i, 1, 1) : (region | Rect(j, i, 1, 1));
+		}
+	}
+
+	// rovnako ako pri blokoch je cierne cele okolie nefiltrovatelneho bodu
+	const auto window = getStructuringElement(MORPH_RECT, Size(blockSize, blockSize));
+	erode(mask, mask, window);
+
+	Mat composed = Mat::zeros(size, CV_32F);
+	std::vector<Mat> responses;
+	std::vector<const float*> values;
+
+	workspace.passes = 0;
+
+	for (auto k = 0; k < static_cast<int>(regions.size()); k++)
+	{
+		const auto& region = regions[k];
+		if (region.empty())
+		{
+			continue;
+		}
+
+		// najpocetnejsie vlnove dlzky orientacie, vzostupne
+		const auto& histogram = histograms[k];
+		std::vector<int> selected(wavelengthBins);
+		std::iota(selected.begin(), selected.end(), 0);
+		std::stable_sort(selected.begin(), selected.end(), [&histogram](const int a, const int b) { return histogram[a] > histogram[b]; });
+
+		auto used = 0;
+		while (used < std::min(this->compositeWavelengths, wavelengthBins) && histogram[selected[used]] > 0)
+		{
+			used++;
+		}
+		selected.resize(used);
+		std::sort(selected.begin(), selected.end());
+
+		// vyrez si okolie berie z celeho obrazku, odozva v oblasti je tak zhodna
+		// s odozvou celeho obrazku
+		responses.resize(selected.size());
+		values.resize(selected.size());
+		for (auto s = 0u; s < selected.size(); s++)
+		{
+			filter2D(fingerprint(region), responses[s], CV_32F, kernels.at(k * wavelengthBins + selected[s]));
+			workspace.passes++;
+		}
+
+		for (auto i = 0; i < region.height; i++)
+		{
+			const auto* index = indices.ptr<int>(region.y + i) + region.x;
+			const auto* position = positions.ptr<float>(region.y + i) + region.x;
+			auto* output = composed.ptr<float>(region.y + i) + region.x;
+
+			for (auto s = 0u; s < selected.size(); s++)
+			{
+				values[s] = responses[s].ptr<float>(i);
+			}
+
+			for (auto j = 0; j < region.width; j++)
+			{
+				if (index[j] != k)
+				{
+					continue;
+				}
+
+				// prva filtrovana vlnova dlzka nad poziciou bodu
+				const auto upper = static_cast<int>(std::upper_bound(selected.begin(), selected.end(), position[j]) - selected.begin());
+
+				if (upper == 0 || upper == static_cast<int>(selected.size()))
+				{
+					output[j] = values[upper == 0 ? 0 : upper - 1][j];
+					continue;
+				}
+
+				const auto t = (position[j] - selected[upper - 1]) / (selected[upper] - selected[upper - 1]);
+
+				if (this->compositeBlend)
+				{
+					output[j] = (1 - t) * values[upper - 1][j] + t * values[upper][j];
+				}
+				else
+				{
+					output[j] = values[t <= .5f ? upper - 1 : upper][j];
+				}
+			}
+		}
+	}
+
+	// lokalna normalizacia do [0, 1] nahradza normalizaciu kazdeho bloku
+	Mat low, high;
+	erode(composed, low, window);
+	dilate(composed, high, window);
+
+	Mat range = high - low;
+	composed -= low;
+	divide(composed, range, composed);
+	composed.setTo(0, range == 0);
+	composed.setTo(0, mask == 0);
+
+	workspace.filtered = composed;
+}
+
+cv::Mat GaborFilter::blockAt(const Mat& fingerprint, const int i, const int j, const Workspace& workspace) const
+{
+	const auto blockSize = workspace.blockSize;
+	const auto& filtered = workspace.filtered;
+	
+	const auto h = ((filtered.rows - i) < blockSize / 2 + 1) ? blockSize / 2 + (filtered.rows - i) : blockSize;
+	const auto w = ((filtered.cols - j) < blockSize / 2 + 1) ? blockSize / 2 + (filtered.cols - j) : blockSize;
+
+	const auto x = j - blockSize / 2 < 0 ? 0 : j - blockSize / 2;
+	const auto y = i - blockSize / 2 < 0 ? 0 : i - blockSize / 2;
+
+	auto block = filtered(Rect(x, y, w, h));
 
 	return block;
 }
 
-void GaborFilter::blockCopyTo(const Mat& block, Mat& fingerprint, const int i, const int j) const
+void GaborFilter::blockCopyTo(const Mat& block, Mat& fingerprint, const int i, const int j, Workspace& workspace) const
 {
-	const auto x = j - this->blockSize / 2 < 0 ? 0 : j - this->blockSize / 2;
-	const auto y = i - this->blockSize / 2 < 0 ? 0 : i - this->blockSize / 2;
+	const auto blockSize = workspace.blockSize;
+	
+	const auto x = j - blockSize / 2 < 0 ? 0 : j - blockSize / 2;
+	const auto y = i - blockSize / 2 < 0 ? 0 : i - blockSize / 2;
 	
-	block.copyTo(this->filtered(Rect(x, y, block.cols, block.rows)));
+	block.copyTo(workspace.filtered(Rect(x, y, block.cols, block.rows)));
 }
 
-void GaborFilter::filterBlock(cv::Mat& block, const float orientation, const float frequency) const
+void GaborFilter::filterBlock(cv::Mat& block, const float orientation, const float frequency, const int blockSize) const
 {
 	const auto kernel = getGaborKernel(
-		Size(this->blockSize, this->blockSize), this->deviation,
+		Size(blockSize, blockSize), this->deviation,
 		orientation, 1 / frequency, 1, 0, CV_32F
 	);
 
+	filterBlock(block, kernel);
+}
+
+void GaborFilter::filterBlock(Mat& block, const Mat& kernel)
+{
 	filter2D(block, block, CV_32F, kernel);
 
 	double min, max;
@@ -101,26 +280,28 @@ void GaborFilter::filterBlock(cv::Mat& block, const float orientation, const flo
 	block.convertTo(block, CV_32F, 1 / (max - min), min / (min - max));
 }
 
-bool GaborFilter::isFilterable(const int i, const int j)
+bool GaborFilter::isFilterable(const int i, const int j, const Workspace& workspace) const
 {
-	const auto halfBlock = this->blockSize / 2 + 1;
-	const auto around = this->blockSize % 2 == 0 ? halfBlock : halfBlock + 1;
+	const auto& orientations = workspace.orientations;
+	
+	const auto halfBlock = workspace.blockSize / 2 + 1;
+	const auto around = workspace.blockSize % 2 == 0 ? halfBlock : halfBlock + 1;
 
 	// hlavou myslienkou je, ci gaborov filter sa nesnazi zffiltrovat nieco,
 	// kde nema data, nechcem aby zavadzal chybu do vylepsenia
 	return (
 		i > around && j > around
-		&& i < this->filtered.rows - around
-		&& j < this->filtered.cols - around
-		&& this->orientations.at<Vec2f>(i, j)[1] > .0f
-		&& this->orientations.at<Vec2f>(i - around, j - around)[1] > .0f
-		&& this->orientations.at<Vec2f>(i + around, j + around)[1] > .0f
-		&& this->orientations.at<Vec2f>(i - around, j + around)[1] > .0f
-		&& this->orientations.at<Vec2f>(i + around, j - around)[1] > .0f
-		&& this->orientations.at<Vec2f>(i - around, j)[1] > .0f
-		&& this->orientations.at<Vec2f>(i + around, j)[1] > .0f
-		&& this->orientations.at<Vec2f>(i, j + around)[1] > .0f
-		&& this->orientations.at<Vec2f>(i, j - around)[1] > .0f
+		&& i < workspace.filtered.rows - around
+		&& j < workspace.filtered.cols - around
+		&& orientations.at<Vec2f>(i, j)[1] > .0f
+		&& orientations.at<Vec2f>(i - around, j - around)[1] > .0f
+		&& orientations.at<Vec2f>(i + around, j + around)[1] > .0f
+		&& orientations.at<Vec2f>(i - around, j + around)[1] > .0f
+		&& orientations.at<Vec2f>(i + around, j - around)[1] > .0f
+		&& orientations.at<Vec2f>(i - around, j)[1] > .0f
+		&& orientations.at<Vec2f>(i + around, j)[1] > .0f
+		&& orientations.at<Vec2f>(i, j + around)[1] > .0f
+		&& orientations.at<Vec2f>(i, j - around)[1] > .0f
 	);
 }
 
@@ -1,7 +1,13 @@
 #pragma once
 
+#include "GaborBank.h"
+
 #include <opencv2/opencv.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
 namespace processing
 {
 	namespace utils
@@ -15,76 +21,142 @@ namespace processing
 		 */
 		class GaborFilter
 		{
+		public:
+			/**
+			 * \brief Pracovne data jedneho filtrovania. Obsahuje vstupne mapy
+			 * a velkost bloku pre konkretny odtlacok, konfiguracia filtra tak
+			 * zostava nemenna.
+			 */
+			struct Workspace
+			{
+				/**
+				 * \brief Lokalne orientacie odtlacku.
+				 */
+				cv::Mat orientations;
+				/**
+				 * \brief Lokalne frekvencie odtlacku.
+				 */
+				cv::Mat frequencies;
+				/**
+				 * \brief Velkost spracovavaneho bloku.
+				 */
+				int blockSize;
+				/**
+				 * \brief Vylepseny odtlacok.
+				 */
+				cv::Mat filtered;
+				/**
+				 * \brief Pocet filtrovani jadrami banky pri skladani odoziev.
+				 */
+				int passes = 0;
+
+				// constructors
+				Workspace(const cv::Mat& orientations, const cv::Mat& frequencies, const int blockSize)
+					: orientations(orientations), frequencies(frequencies), blockSize(blockSize) {}
+			};
+
 		private:
 			// members
 			/**
-			 * \brief Velkost spracovavaneho bloku.
+			 * \brief Predvolena velkost spracovavaneho bloku.
 			 */
 			int blockSize = 16;
 			/**
 			 * \brief Odchylka.
 			 */
 			float deviation = 4;
-
 			/**
-			 * \brief Indikator vizualnych vystupov.
+			 * \brief Banka kvantovanych jadier zdielana filtrami, bez nej sa jadro
+			 * vytvara pre kazdy blok.
 			 */
-			bool verboseOutput = false;
-			
+			std::shared_ptr<GaborBank> bank;
+			/**
+			 * \brief Indikator skladania vystupu z odoziev celeho obrazku na jadra banky
+			 * namiesto filtrovania prekryvajucich sa blokov. Vyzaduje banku jadier.
+			 */
+			bool compositeOutput = false;
 			/**
-			 * \brief Lokalne frekvencie odtlacku.
+			 * \brief Najvacsi pocet vlnovych dlzok filtrovanych pre jednu orientaciu
+			 * pri skladani odoziev, vyberu sa najpocetnejsie.
 			 */
-			cv::Mat frequencies;
+			int compositeWavelengths = 2;
 			/**
-			 * \brief Lokalne orientacie odtlacku.
+			 * \brief Indikator prelinania odoziev dvoch vlnovych dlzok ohranicujucich
+			 * frekvenciu bodu pri skladani odoziev namiesto vyberu najblizsej.
 			 */
-			cv::Mat orientations;
+			bool compositeBlend = false;
+
 			/**
-			 * \brief Vylepseny odtlacok.
+			 * \brief Indikator vizualnych vystupov.
 			 */
-			cv::Mat filtered;
+			bool verboseOutput = false;
 
 			// static members
 			/**
 			 * \brief Pocet zobrazeni vylepseneho odtlacku.
 			 */
-			static int displayed;
+			static std::atomic<int> displayed;
 
 			//methods
 			/**
 			 * \brief Vylepsi kvalitu odtlacku.
+			 * \param workspace pracovne data filtrovania
 			 */
-			void filterImage();
+			void filterImage(Workspace& workspace) const;
+			/**
+			 * \brief Vylepsi kvalitu odtlacku skladanim odoziev. Pre kazdu pouzitu orientaciu
+			 * banky sa oblast jej bodov zfiltruje jadrami najviac compositeWavelengths
+			 * najpocetnejsich kvantovanych vlnovych dlziek tychto bodov, pocet filtrovani je
+			 * tak najviac pocet orientacii krat compositeWavelengths. Kazdy bod prevezme
+			 * odozvu svojej orientacie s najblizsou filtrovanou vlnovou dlzkou, pripadne
+			 * linearne prelinanie odoziev dvoch vlnovych dlzok, ktore jeho frekvenciu
+			 * ohranicuju. Odozvy su normalizovane lokalnym minimom a maximom v okne
+			 * velkosti bloku.
+			 * \param fingerprint obrazok
+			 * \param workspace pracovne data filtrovania
+			 * \param kernels jadra banky
+			 */
+			void filterComposite(const cv::Mat& fingerprint, Workspace& workspace, const GaborBank::Kernels& kernels) const;
 			/**
 			 * \brief Vytiahne blok z obrazku na pozicii [i, j].
 			 * \param fingerprint odtlacok
 			 * \param i pozicia i
 			 * \param j pozicia j
+			 * \param workspace pracovne data filtrovania
 			 * \return blok
 			 */
-			cv::Mat blockAt(const cv::Mat& fingerprint, int i, int j) const;
+			cv::Mat blockAt(const cv::Mat& fingerprint, int i, int j, const Workspace& workspace) const;
 			/**
 			 * \brief Nakopiruje blok do obrazku na pozicii [i, j]
 			 * \param block blok
 			 * \param fingerprint obrazok
 			 * \param i pozicia i
 			 * \param j pozicia j
+			 * \param workspace pracovne data filtrovania
 			 */
-			void blockCopyTo(const cv::Mat& block, cv::Mat& fingerprint, int i, int j) const;
+			void blockCopyTo(const cv::Mat& block, cv::Mat& fingerprint, int i, int j, Workspace& workspace) const;
 			/**
 			 * \brief Zfiltruje blok povodneho obrazku gaborovym filtrom.
 			 * \param block blok
 			 * \param orientation lokalna orientacia 
 			 * \param frequency lokalna frekvencia
+			 * \param blockSize velkost bloku
+			 */
+			void filterBlock(cv::Mat& block, float orientation, float frequency, int blockSize) const;
+			/**
+			 * \brief Zfiltruje blok povodneho obrazku zadanym jadrom.
+			 * \param block blok
+			 * \param kernel gaborovo jadro
 			 */
-			void filterBlock(cv::Mat& block, float orientation, float frequency) const;
+			static void filterBlock(cv::Mat& block, const cv::Mat& kernel);
 			/**
 			 * \brief Zisti ci je blok na pozicii [i, j] filtrovatelny.
 			 * \param i pozicia i
 			 * \param j pozicia j
+			 * \param workspace pracovne data filtrovania
 			 * \return indikator filtrovatelnosti
 			 */
-			bool isFilterable(int i, int j);
+			bool isFilterable(int i, int j, const Workspace& workspace) const;
 			
 		public:
 			// static members
@@ -97,9 +169,18 @@ namespace processing
 			/**
 			 * \brief Vylepsi kvalitu odtlacku.
 			 * \param fingerprint obrazok
-			 * \return 
+			 * \param orientations lokalne orientacie
+			 * \param frequencies lokalne frekvencie
+			 * \return vylepseny odtlacok
+			 */
+			cv::Mat filter(const cv::Mat& fingerprint, const cv::Mat& orientations, const cv::Mat& frequencies) const;
+			/**
+			 * \brief Vylepsi kvalitu odtlacku nad pracovnymi datami volajuceho.
+			 * \param fingerprint obrazok
+			 * \param workspace pracovne data filtrovania
+			 * \return vylepseny odtlacok
 			 */
-			cv::Mat filter(const cv::Mat& fingerprint);
+			cv::Mat filter(const cv::Mat& fingerprint, Workspace& workspace) const;
 
 			/**
 			 * \brief Zobrazi frekvencie spolu s cestou odkial bola metoda zavolana.
@@ -116,19 +197,36 @@ namespace processing
 				
 			// getters
 			float getDeviation() const { return this->deviation; }
-			cv::Mat getFrequencyMap() const { return this->frequencies; }
-			cv::Mat getOrientationMap() const { return this->orientations; }
 			int getBlockSize() const { return this->blockSize; }
-			cv::Mat getFiltered() const { return this->filtered; }
 			bool isVerbose() const { return this->verboseOutput; }
+			std::shared_ptr<GaborBank> getBank() const { return this->bank; }
+			bool isComposite() const { return this->compositeOutput; }
+			int getCompositeWavelengths() const { return this->compositeWavelengths; }
+			bool isCompositeBlend() const { return this->compositeBlend; }
 			
 			// setters
 			GaborFilter& setDeviation(const float deviation) { this->deviation = deviation; return *this; }
-			GaborFilter& setFrequencyMap(const cv::Mat& frequencies) { this->frequencies = frequencies; return *this; }
-			GaborFilter& setOrientationMap(const cv::Mat& orientations) { this->orientations = orientations; return *this; }
 			GaborFilter& setBlockSize(const int blockSize) { this->blockSize = blockSize; return *this; }
 			GaborFilter& verbose(const bool verboseOutput = true) { this->verboseOutput = verboseOutput; return *this; }
+			GaborFilter& setBank(const std::shared_ptr<GaborBank>& bank) { this->bank = bank; return *this; }
+			GaborFilter& composite(bool compositeOutput = true);
+			GaborFilter& setCompositeWavelengths(const int compositeWavelengths) { this->compositeWavelengths = std::max(compositeWavelengths, 1); return *this; }
+			GaborFilter& blendComposite(const bool compositeBlend = true) { this->compositeBlend = compositeBlend; return *this; }
 			
 		};
 	}
 }
+
+
+inline processing::utils::GaborFilter& processing::utils::GaborFilter::composite(const bool compositeOutput)
+{
+	this->compositeOutput = compositeOutput;
+
+	// skladanie bez banky by vytvaralo vsetky jadra pre kazdy odtlacok
+	if (compositeOutput && !this->bank)
+	{
+		this->bank = std::make_shared<GaborBank>();
+	}
+
+	return *this;
+}
@@ -3,9 +3,55 @@
 
 #include <opencv2/imgproc.hpp>
 
+#include <vector>
+
 using namespace processing::utils;
 using namespace cv;
 
+namespace
+{
+	/**
+	 * \brief Zostavi tabulku odstranenia bodov jednej iteracie stencovania
+	 * s podmienkami zhodnymi s thinningIteration.
+	 * \param iter poradie iteracie
+	 */
+	constexpr std::array<std::uint8_t, 256> deletionTable(const int iter)
+	{
+		std::array<std::uint8_t, 256> table{};
+
+		for (auto code = 0; code < 256; code++)
+		{
+			int p[8] = {};
+			for (auto n = 0; n < 8; n++)
+			{
+				p[n] = (code >> n) & 1;
+			}
+			const auto p2 = p[0], p3 = p[1], p4 = p[2], p5 = p[3], p6 = p[4], p7 = p[5], p8 = p[6], p9 = p[7];
+
+			auto a = 0;
+			for (auto n = 0; n < 8; n++)
+			{
+				a += p[n] == 0 && p[(n + 1) % 8] == 1;
+			}
+
+			const auto b = p2 + p3 + p4 + p5 + p6 + p7 + p8 + p9;
+
+			const auto m1 = iter == 0 ? (p2 * p4 * p6) : (p2 * p4 * p8);
+			const auto m2 = iter == 0 ? (p4 * p6 * p8) : (p2 * p6 * p8);
+
+			const auto n1 = (p2 * p4 == 1) && (p6 + p7 + p8 == 0);
+			const auto n2 = (p4 * p6 == 1) && (p2 + p8 + p9 == 0);
+
+			table[code] = b >= 2 && b <= 7
+				&& ((a == 1 && m1 == 0 && m2 == 0) || (a == 2 && (n1 || n2)));
+		}
+
+		return table;
+	}
+}
+
+const std::array<std::array<std::uint8_t, 256>, 2> ImageProcessor::deletions = { deletionTable(0), deletionTable(1) };
+
 Mat ImageProcessor::read(const std::string& imageLocation, const int flags)
 {
 	auto image =  imread(imageLocation, flags);
@@ -201,6 +247,117 @@ Mat ImageProcessor::rotate(const Mat& img, const float angle, const std::vector<
 }
 
 void ImageProcessor::thine(Mat& img, const Mat& segmentation)
+{
+	Mat binary;
+	compare(img, 0, binary, CMP_NE);
+	bitwise_and(binary, Scalar(1), binary);
+
+	thineBinary(binary);
+
+	binary.convertTo(img, CV_32F);
+}
+
+void ImageProcessor::thineBinary(Mat& img)
+{
+	const auto rows = img.rows, cols = img.cols;
+	if (rows < 3 || cols < 3)
+	{
+		return;
+	}
+	if (!img.isContinuous())
+	{
+		img = img.clone();
+	}
+
+	auto* data = img.data;
+	const auto code = [data, cols](const int k)
+	{
+		return neighbourhood(data + k - cols, data + k, data + k + cols, 0);
+	};
+
+	// bity 0 a 1 oznacuju body, ktore je treba vyhodnotit v danej iteracii
+	Mat pending = Mat::zeros(img.size(), CV_8U);
+	auto* dirty = pending.data;
+
+	// na zaciatku su kandidatmi vsetky body obrysu, vnutorne body sa odstranit nedaju
+	std::vector<int> candidates;
+	for (auto i = 1; i < rows - 1; i++)
+	{
+		for (auto j = 1; j < cols - 1; j++)
+		{
+			const auto k = i * cols + j;
+			if (data[k] && code(k) != 0xFF)
+			{
+				dirty[k] = 3;
+				candidates.push_back(k);
+			}
+		}
+	}
+
+	std::vector<int> removed;
+	auto changed = true;
+
+	while (changed)
+	{
+		changed = false;
+
+		for (auto iter = 0; iter < 2; iter++)
+		{
+			const auto bit = static_cast<std::uint8_t>(1 << iter);
+			const auto& table = deletions[iter];
+
+			// vyhodnotenie nad stavom pred iteraciou, body sa odstrania az potom
+			removed.clear();
+			auto kept = 0u;
+			for (const auto k : candidates)
+			{
+				if (dirty[k] & bit)
+				{
+					dirty[k] &= ~bit;
+					if (table[code(k)])
+					{
+						dirty[k] = 0;
+						removed.push_back(k);
+						continue;
+					}
+				}
+				if (dirty[k])
+				{
+					candidates[kept++] = k;
+				}
+			}
+			candidates.resize(kept);
+
+			for (const auto k : removed)
+			{
+				data[k] = 0;
+			}
+
+			// susedom odstranenych bodov sa zmenilo okolie, vyhodnotia sa v oboch iteraciach
+			for (const auto k : removed)
+			{
+				for (const auto offset : { -cols - 1, -cols, -cols + 1, -1, 1, cols - 1, cols, cols + 1 })
+				{
+					const auto n = k + offset;
+					const auto i = n / cols, j = n % cols;
+					if (!data[n] || i < 1 || i >= rows - 1 || j < 1 || j >= cols - 1)
+					{
+						continue;
+					}
+					if (!dirty[n])
+					{
+						candidates.push_back(n);
+					}
+					dirty[n] = 3;
+				}
+			}
+
+			changed = changed || !removed.empty();
+		}
+	}
+}
+
+void ImageProcessor::thineReference(Mat& img, const Mat& segmentation)
 {
 	Mat prev = Mat::zeros(img.size(), CV_32F);
 	Mat diff;
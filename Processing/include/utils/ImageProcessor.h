@@ -2,6 +2,8 @@
 
 #include <opencv2/opencv.hpp>
 
+#include <array>
+#include <cstdint>
 #include <string>
 
 namespace processing
@@ -21,6 +23,12 @@ namespace processing
 			 */
 			static void thinningIteration(cv::Mat& img, int iter);
 
+			/**
+			 * \brief Priznaky odstranenia bodu pri stencovani podla 8-okolia zbaleneho
+			 * do bajtu (pozri neighbourhood) pre obe iteracie stencovania.
+			 */
+			static const std::array<std::array<std::uint8_t, 256>, 2> deletions;
+
 		public:
 			/**
 			 * \brief Pristup k pixelu obrazku, pripade ze sa pozicia nenachadza na obrazku
@@ -117,6 +125,34 @@ namespace processing
 			 * \param segmentation segmentacia 
 			 */
 			static void thine(cv::Mat& img, const cv::Mat& segmentation);
+			/**
+			 * \brief Ztensi obrazok binarizovaneho odtlacku prsta povodnym postupom
+			 * prechadzajucim cely obrazok v kazdej iteracii. Vysledok je zhodny s thine.
+			 * \param img obrazok
+			 * \param segmentation segmentacia
+			 */
+			static void thineReference(cv::Mat& img, const cv::Mat& segmentation);
+			/**
+			 * \brief Ztensi binarny obrazok s hodnotami 0 a 1 typu CV_8U. V kazdej iteracii
+			 * su vyhodnotene iba body obrysu, ktorych okolie sa od posledneho vyhodnotenia
+			 * v rovnakej iteracii zmenilo, o odstraneni rozhoduje tabulka deletions.
+			 * \param img obrazok
+			 */
+			static void thineBinary(cv::Mat& img);
+			/**
+			 * \brief Zbali 8-okolie bodu binarneho obrazku typu CV_8U do bajtu. Bit n patri
+			 * bodu okolia v poradi od horneho v smere hodinovych ruciciek.
+			 * \param above riadok nad bodom
+			 * \param row riadok bodu
+			 * \param below riadok pod bodom
+			 * \param j stlpec bodu
+			 * \return zbalene okolie
+			 */
+			static int neighbourhood(const std::uint8_t* above, const std::uint8_t* row, const std::uint8_t* below, const int j)
+			{
+				return above[j] | above[j + 1] << 1 | row[j + 1] << 2 | below[j + 1] << 3
+					| below[j] << 4 | below[j - 1] << 5 | row[j - 1] << 6 | above[j - 1] << 7;
+			}
 			/**
 			 * \brief Opravi zle ohodnotene oblasti, kde doslo k chybnej segemntacii.
 			 * \param segmentation segmentacia odtlacku
@@ -3,11 +3,42 @@
 #include "exceptions/UnknownMinutiaeType.h"
 #include "exceptions/MapOutOfBound.h"
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
 using namespace processing::utils::storage;
 using namespace processing::utils;
 using namespace cv;
 
-int MinutiaeEstimator::displayed = 0;
+namespace
+{
+	/**
+	 * \brief Zostavi tabulku typov markantov pre vsetky 8-okolia.
+	 */
+	constexpr std::array<std::int8_t, 256> crossingTable()
+	{
+		std::array<std::int8_t, 256> table{};
+
+		for (auto code = 0; code < 256; code++)
+		{
+			auto transitions = 0;
+			for (auto n = 0; n < 8; n++)
+			{
+				transitions += ((code >> n) & 1) != ((code >> ((n + 1) % 8)) & 1);
+			}
+
+			const auto crossing = transitions / 2;
+			table[code] = crossing == 1
+				? Minutiae::Type::BIFURCATION
+				: (crossing >= 3 ? Minutiae::Type::TERMINATION : Minutiae::Type::NONE);
+		}
+
+		return table;
+	}
+}
+
+std::atomic<int> MinutiaeEstimator::displayed(0);
 const std::string MinutiaeEstimator::class_name = "MinutiaeEstimator::";
 
 const std::array<std::array<int, 2>, 8> MinutiaeEstimator::indices{ {
@@ -17,22 +48,28 @@ const std::array<std::array<int, 2>, 8> MinutiaeEstimator::indices{ {
 	{1, 0}, {1, 1},
 } };
 
-std::vector<Minutiae> MinutiaeEstimator::estimate(const Mat& img)
+const std::array<std::int8_t, 256> MinutiaeEstimator::crossings = crossingTable();
+
+std::vector<Minutiae> MinutiaeEstimator::estimate(const Mat& img, const Mat& segmentation) const
 {
-	this->minutiaes = std::vector<Minutiae>();
-	
-	this->tmp = Mat(img.size(), CV_8UC3);
-	ImageProcessor::convertTo(img, this->tmp, CV_8U);
+	Workspace workspace(segmentation, this->blockSize);
+
+	return this->estimate(img, workspace);
+}
 
-	this->lineTracking = Mat(img.size(), CV_8UC3);
-	ImageProcessor::convertTo(img, this->lineTracking, CV_8U);
+std::vector<Minutiae> MinutiaeEstimator::estimate(const Mat& img, Workspace& workspace) const
+{
+	workspace.minutiaes = std::vector<Minutiae>();
+	
+	workspace.tmp = Mat(img.size(), CV_8UC3);
+	ImageProcessor::convertTo(img, workspace.tmp, CV_8U);
 	
-	this->compute(img);
+	this->compute(img, workspace);
 
-	return this->minutiaes;
+	return workspace.minutiaes;
 }
 
-void MinutiaeEstimator::display(const Mat& img, const std::vector<Minutiae>& minutiaes, const std::string& trace) const
+void MinutiaeEstimator::display(const Mat& img, const std::vector<Minutiae>& minutiaes, const Mat& tracing, const std::string& trace) const
 {
 	const auto tmp = this->getMinutiaeImage(img, minutiaes);
 	
@@ -41,93 +78,111 @@ void MinutiaeEstimator::display(const Mat& img, const std::vector<Minutiae>& min
 
 	ss.str("");
 	ss << ++displayed << ": Minutiaes Tracing" << " TRACE: " << trace;
-	imshow(ss.str(), this->tmp);
+	imshow(ss.str(), tracing);
 	
+	Mat lineTracking(img.size(), CV_8UC3);
+	ImageProcessor::convertTo(img, lineTracking, CV_8U);
+
 	ss.str("");
 	ss << ++displayed << ": Ridge Tracking" << " TRACE: " << trace;
-	imshow(ss.str(), this->lineTracking);
+	imshow(ss.str(), lineTracking);
 }
 
-void MinutiaeEstimator::write(const Mat& img, const std::vector<Minutiae>& minutiaes, const std::string& path, const std::string& filename) const
+void MinutiaeEstimator::write(const Mat& img, const std::vector<Minutiae>& minutiaes, const Mat& tracing, 
+	const std::string& path, const std::string& filename) const
 {
-	auto tmp = this->tmp;
+	auto tmp = tracing.clone();
 	tmp.convertTo(tmp, CV_8UC3, 255);
 
-	std::stringstream ss; ss.str(""); ss << path << "4_tracing\\" << filename << ".jpg";
+	std::stringstream ss; ss.str(""); ss << path << "4_tracing/" << filename << ".jpg";
 	imwrite(ss.str(), tmp);
 	
 	auto tmp2 = this->getMinutiaeImage(img, minutiaes);
 	tmp2.convertTo(tmp2, CV_8UC3, 255);
 
-	ss.str(""); ss.str(""); ss << path << "5_minutiae\\" << filename << ".jpg";
+	ss.str(""); ss.str(""); ss << path << "5_minutiae/" << filename << ".jpg";
 	imwrite(ss.str(), tmp2);
 }
 
-void MinutiaeEstimator::compute(const Mat& img)
+void MinutiaeEstimator::compute(const Mat& img, Workspace& workspace) const
 {
+	// linie stenceneho odtlacku ako bajty 0 a 1
+	Mat ridges;
+	compare(img, 1, ridges, CMP_EQ);
+	bitwise_and(ridges, Scalar(1), ridges);
+
 	for (auto i = 1; i < img.rows - 1; i++)
 	{
-		for (auto j = 1; j < img.cols - 1; j++)
+		const auto* above = ridges.ptr<uchar>(i - 1);
+		const auto* row = ridges.ptr<uchar>(i);
+		const auto* below = ridges.ptr<uchar>(i + 1);
+
+		auto j = 1;
+#if defined(__SSE2__) || defined(_M_X64)
+		// 16 bodov naraz, useky bez linie sa preskocia a okolia sa balia vektorovo
+		const auto zero = _mm_setzero_si128();
+		alignas(16) uchar codes[16];
+
+		for (; j + 16 < img.cols; j += 16)
 		{
-			// ak sa nenachadzam na linii, nezaujima ma to
-			if (img.at<float>(i, j) == 0) continue;
-
-			// vezmem pixely okolia
-			std::vector<float> pixels;
-			pixels.push_back(img.at<float>(i - 1, j) == 1 ? 0 : 1);
-			pixels.push_back(img.at<float>(i - 1, j + 1) == 1 ? 0 : 1);
-			pixels.push_back(img.at<float>(i, j + 1) == 1 ? 0 : 1);
-			pixels.push_back(img.at<float>(i + 1, j + 1) == 1 ? 0 : 1);
-			pixels.push_back(img.at<float>(i + 1, j) == 1 ? 0 : 1);
-			pixels.push_back(img.at<float>(i + 1, j - 1) == 1 ? 0 : 1);
-			pixels.push_back(img.at<float>(i, j - 1) == 1 ? 0 : 1);
-			pixels.push_back(img.at<float>(i - 1, j - 1) == 1 ? 0 : 1);
-
-			// spocitam vysky 01 parov
-			auto sum = 0.0f;
-			for (auto n = 1; n <= pixels.size(); n++)
+			const auto center = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + j));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi8(center, zero)) == 0xFFFF)
 			{
-				sum += abs(pixels.at(n % 8) - pixels.at(n - 1));
+				continue;
 			}
-			sum *= .5f;
 
-			// ak jeden jedna sa o rozdvojenie (vychadzam zo stencenych priestorov, nie linii)
-			if (sum == 1.0f)
+			const auto load = [](const uchar* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); };
+
+			// hodnoty su 0 alebo 1, posun v 16-bitovych pruhoch tak neprelieva bity medzi bajtmi
+			auto code = load(above + j);
+			code = _mm_or_si128(code, _mm_slli_epi16(load(above + j + 1), 1));
+			code = _mm_or_si128(code, _mm_slli_epi16(load(row + j + 1), 2));
+			code = _mm_or_si128(code, _mm_slli_epi16(load(below + j + 1), 3));
+			code = _mm_or_si128(code, _mm_slli_epi16(load(below + j), 4));
+			code = _mm_or_si128(code, _mm_slli_epi16(load(below + j - 1), 5));
+			code = _mm_or_si128(code, _mm_slli_epi16(load(row + j - 1), 6));
+			code = _mm_or_si128(code, _mm_slli_epi16(load(above + j - 1), 7));
+			_mm_store_si128(reinterpret_cast<__m128i*>(codes), code);
+
+			for (auto k = 0; k < 16; k++)
 			{
-				auto pos = Point(j, i);
-				if (!this->isValid(pos))
+				const auto type = crossings[codes[k]];
+				if (row[j + k] && type != Minutiae::Type::NONE)
 				{
-					continue;
+					this->add(img, Point(j + k, i), type, workspace);
 				}
-		
-				const auto direction = this->calculateDirection(img, pos, Minutiae::Type::BIFURCATION);
-				const auto adptThreshold = this->calculateAdaptiveThreshold(img, pos, direction, true);
-				const auto adaptiveDirection = this->calculateDirection(img, pos, Minutiae::Type::BIFURCATION, adptThreshold, true);
-				
-				auto minutiae = Minutiae(pos, adaptiveDirection, adptThreshold, Minutiae::Type::BIFURCATION);
-				this->minutiaes.emplace_back(minutiae);
 			}
-			// ak 3 ukoncenie (vychadzam zo stencenych priestorov, nie linii)
-			else if (sum >= 3.0f)
-			{
-				auto pos = Point(j, i);
-				if (!this->isValid(pos))
-				{
-					continue;
-				}
+		}
+#endif
+		for (; j < img.cols - 1; j++)
+		{
+			// ak sa nenachadzam na linii, nezaujima ma to
+			if (!row[j]) continue;
 
-				const auto direction = this->calculateDirection(img, pos, Minutiae::Type::TERMINATION);
-				const auto adptThreshold = this->calculateAdaptiveThreshold(img, pos, direction, true);
-				const auto adaptiveDirection = this->calculateDirection(img, pos, Minutiae::Type::TERMINATION, adptThreshold, true);
-				
-				auto minutiae = Minutiae(pos, adaptiveDirection, adptThreshold, Minutiae::Type::TERMINATION);
-				this->minutiaes.emplace_back(minutiae);
+			const auto type = crossings[ImageProcessor::neighbourhood(above, row, below, j)];
+			if (type != Minutiae::Type::NONE)
+			{
+				this->add(img, Point(j, i), type, workspace);
 			}
 		}
 	}
 }
 
-float MinutiaeEstimator::calculateAdaptiveThreshold(const Mat& map, const Point& pos, const float direction, const bool verbose)
+void MinutiaeEstimator::add(const Mat& img, const Point& pos, const int type, Workspace& workspace) const
+{
+	if (!this->isValid(pos, workspace))
+	{
+		return;
+	}
+
+	const auto direction = this->calculateDirection(img, pos, type, workspace);
+	const auto adptThreshold = this->calculateAdaptiveThreshold(img, pos, direction, workspace, true);
+	const auto adaptiveDirection = this->calculateDirection(img, pos, type, workspace, adptThreshold, true);
+
+	workspace.minutiaes.emplace_back(pos, adaptiveDirection, adptThreshold, type);
+}
+
+float MinutiaeEstimator::calculateAdaptiveThreshold(const Mat& map, const Point& pos, const float direction, Workspace& workspace, const bool verbose) const
 {
 	const auto defaultThreshold = 7;
 	
@@ -137,8 +192,8 @@ float MinutiaeEstimator::calculateAdaptiveThreshold(const Mat& map, const Point&
 	auto r1Failed = false, r2Failed = false;
 
 	std::vector<Point> line;
-	const auto positions = this->getStartingTracingPositions(pos, map, Point(-1, -1), true);
-	const auto endPoints = this->trace(pos, positions, 15, map, line);
+	const auto positions = this->getStartingTracingPositions(pos, map, workspace, Point(-1, -1), true);
+	const auto endPoints = this->trace(pos, positions, 15, map, line, workspace);
 	
 	// maximalne pojdem do vzdialenosti 50 pixelov od markantu
 	for (auto bound = 1; bound < 50; bound++)
@@ -151,7 +206,7 @@ float MinutiaeEstimator::calculateAdaptiveThreshold(const Mat& map, const Point&
 			{
 				if (verbose)
 				{
-					cv::line(this->tmp, pos, ridge1, Scalar(0, 0, 1), 2);
+					cv::line(workspace.tmp, pos, ridge1, Scalar(0, 0, 1), 2);
 				}
 
 				// nasiel som, najdem najkratsiu vzdialenost
@@ -168,7 +223,7 @@ float MinutiaeEstimator::calculateAdaptiveThreshold(const Mat& map, const Point&
 
 				if (verbose)
 				{
-					cv::line(this->tmp, pos, ridge1, Scalar(0, 1, 0), 2);
+					cv::line(workspace.tmp, pos, ridge1, Scalar(0, 1, 0), 2);
 				}
 			}
 		}
@@ -186,7 +241,7 @@ float MinutiaeEstimator::calculateAdaptiveThreshold(const Mat& map, const Point&
 			{
 				if (verbose)
 				{
-					cv::line(this->tmp, pos, ridge2, Scalar(0, 0, 1), 2);
+					cv::line(workspace.tmp, pos, ridge2, Scalar(0, 0, 1), 2);
 				}
 
 				// nasiel som, najdem najkratsiu vzdialenost
@@ -203,7 +258,7 @@ float MinutiaeEstimator::calculateAdaptiveThreshold(const Mat& map, const Point&
 
 				if (verbose)
 				{
-					cv::line(this->tmp, pos, ridge2, Scalar(0, 1, 0), 2);
+					cv::line(workspace.tmp, pos, ridge2, Scalar(0, 1, 0), 2);
 				}
 			}
 		}
@@ -345,17 +400,17 @@ bool MinutiaeEstimator::locationContainsRidge(const Mat& map, const Point& pos,
 	return false;
 }
 
-bool MinutiaeEstimator::isValid(const Point& pos)
+bool MinutiaeEstimator::isValid(const Point& pos, const Workspace& workspace) const
 {
 	// sontrolujem ci sa nahodou nejedna o okraj stenceneho obrazka, potom nejde o markant
 	for (const auto index : indices)
 	{
-		const Point seg(pos.x + index[1] * this->blockSize * 2, pos.y + index[0] * this->blockSize * 2);
+		const Point seg(pos.x + index[1] * workspace.blockSize * 2, pos.y + index[0] * workspace.blockSize * 2);
 
 		if (seg.x < 0 || seg.y < 0 
-			|| seg.x >= this->segmentation.cols 
-			|| seg.y >= this->segmentation.rows
-			|| this->segmentation.at<Vec2f>(seg.y, seg.x)[1] == .0f)
+			|| seg.x >= workspace.segmentation.cols 
+			|| seg.y >= workspace.segmentation.rows
+			|| workspace.segmentation.at<Vec2f>(seg.y, seg.x)[1] == .0f)
 		{
 			return false;
 		}
@@ -364,12 +419,12 @@ bool MinutiaeEstimator::isValid(const Point& pos)
 	return true;
 }
 
-float MinutiaeEstimator::calculateDirection(const Mat& img, const Point& pos, const int type, const float threshold, const bool verbose)
+float MinutiaeEstimator::calculateDirection(const Mat& img, const Point& pos, const int type, Workspace& workspace, const float threshold, const bool verbose) const
 {
-	const auto positions = this->getStartingTracingPositions(pos, img, Point(-1, -1), true);
+	const auto positions = this->getStartingTracingPositions(pos, img, workspace, Point(-1, -1), true);
 
 	std::vector<Point> line;
-	const auto points = this->trace(pos, positions, threshold, img, line, verbose);
+	const auto points = this->trace(pos, positions, threshold, img, line, workspace, verbose);
 	
 	switch (type)
 	{
@@ -435,7 +490,7 @@ float MinutiaeEstimator::direction(const Point& offset, const Point& center) con
 	return atan2(offset.y - center.y, offset.x - center.x);
 }
 
-std::vector<Point> MinutiaeEstimator::getStartingTracingPositions(const Point& base, const Mat& map, const Point& except, const bool verbose)
+std::vector<Point> MinutiaeEstimator::getStartingTracingPositions(const Point& base, const Mat& map, Workspace& workspace, const Point& except, const bool verbose) const
 {
 	std::vector<Point> positions;
 
@@ -456,7 +511,7 @@ std::vector<Point> MinutiaeEstimator::getStartingTracingPositions(const Point& b
 
 			if (verbose)
 			{
-				circle(this->tmp, positions.back(), 1, Scalar(1, 0, 1));
+				circle(workspace.tmp, positions.back(), 1, Scalar(1, 0, 1));
 			}
 
 			if (positions.size() == 3)
@@ -469,7 +524,8 @@ std::vector<Point> MinutiaeEstimator::getStartingTracingPositions(const Point& b
 	return positions;
 }
 
-std::vector<Point> MinutiaeEstimator::trace(const Point& base, std::vector<Point> positions, const int length, const Mat& map, std::vector<Point>& processed, const bool verbose)
+std::vector<Point> MinutiaeEstimator::trace(const Point& base, std::vector<Point> positions, const int length, const Mat& map, 
+	std::vector<Point>& processed, Workspace& workspace, const bool verbose) const
 {
 	std::vector<Point> result;
 
@@ -508,7 +564,7 @@ std::vector<Point> MinutiaeEstimator::trace(const Point& base, std::vector<Point
 
 						if (verbose)
 						{
-							circle(this->tmp, point, 1, Scalar(1, 0, 1));
+							circle(workspace.tmp, point, 1, Scalar(1, 0, 1));
 						}
 					}
 				}
@@ -2,6 +2,10 @@
 
 #include "storage/Minutiae.h"
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+
 namespace processing
 {
 	namespace utils
@@ -11,58 +15,82 @@ namespace processing
 		 */
 		class MinutiaeEstimator
 		{
-		private:
-			// members
-			/**
-			 * \brief Ulozisko pre krokovanie tracovania linii, a vyhladavania susednych.
-			 */
-			cv::Mat tmp;
-			/**
-			 * \brief Ulozisko defaultny tracing linii.
-			 */
-			cv::Mat lineTracking;
+		public:
 			/**
-			 * \brief Ulozisko pre markanty.
-			 */
-			std::vector<storage::Minutiae> minutiaes;
+			 * \brief Pracovne data jedneho vyhladavania markantov. Obsahuje
+			 * segmentaciu a velkost bloku konkretneho odtlacku spolu s
+			 * medzivysledkami tracovania.
+			 */
+			struct Workspace
+			{
+				/**
+				 * \brief Segmentacia odtlacku.
+				 */
+				cv::Mat segmentation;
+				/**
+				 * \brief Velkost spracovavaneho bloku.
+				 */
+				int blockSize;
+				/**
+				 * \brief Ulozisko pre krokovanie tracovania linii, a vyhladavania susednych.
+				 */
+				cv::Mat tmp;
+				/**
+				 * \brief Ulozisko pre markanty.
+				 */
+				std::vector<storage::Minutiae> minutiaes;
 
+				// constructors
+				Workspace(const cv::Mat& segmentation, const int blockSize)
+					: segmentation(segmentation), blockSize(blockSize) {}
+			};
+
+		private:
+			// members
 			/**
-			 * \brief Velkost spracovavaneho bloku.
+			 * \brief Predvolena velkost spracovavaneho bloku.
 			 */
 			int blockSize = 11;
-			/**
-			 * \brief Segmentacia odtlacku.
-			 */
-			cv::Mat segmentation;
 
 			// static members
 			/**
 			 * \brief Pocet zobrazeni v ramci jedneho behu.
 			 */
-			static int displayed;
+			static std::atomic<int> displayed;
 
 			// methods
 			/**
 			 * \brief Spustenie procesu vyhladavania markantov.
 			 * \param img stenceny obrazok odtlacku.
+			 * \param workspace pracovne data vyhladavania
+			 */
+			void compute(const cv::Mat& img, Workspace& workspace) const;
+			/**
+			 * \brief Overi poziciu markantu, spocita jeho smer a dlzku tracovania a ulozi ho.
+			 * \param img stenceny obrazok odtlacku
+			 * \param pos pozicia markantu
+			 * \param type typ markantu
+			 * \param workspace pracovne data vyhladavania
 			 */
-			void compute(const cv::Mat& img);
+			void add(const cv::Mat& img, const cv::Point& pos, int type, Workspace& workspace) const;
 			/**
 			 * \brief Kontrola ci nejde o oznacanie markantu na okraju odtlacku.
 			 * \param pos pozicia markantu
+			 * \param workspace pracovne data vyhladavania
 			 * \return idikator validnosti markantu
 			 */
-			bool isValid(const cv::Point& pos);
+			bool isValid(const cv::Point& pos, const Workspace& workspace) const;
 			/**
 			 * \brief Spocita smer markantu.
 			 * \param img stenceny odtlacok
 			 * \param pos pozicia markantu
 			 * \param type typ markantu
+			 * \param workspace pracovne data vyhladavania
 			 * \param threshold dlzka tracovania
 			 * \param verbose kontrolny vystup
 			 * \return smer markantu
 			 */
-			float calculateDirection(const cv::Mat& img, const cv::Point& pos, int type, float threshold = 20, bool verbose = false);
+			float calculateDirection(const cv::Mat& img, const cv::Point& pos, int type, Workspace& workspace, float threshold = 20, bool verbose = false) const;
 			/**
 			 * \brief Najdze najmensi rozdiel medzi uhlami (urcenie uhlu pre zdvojenie linii).
 			 * \param directions smery linii
@@ -80,11 +108,13 @@ namespace processing
 			 * \brief Urci startovacie tracovacie pozicie. 
 			 * \param base pociatocny bod
 			 * \param map obrazok
+			 * \param workspace pracovne data vyhladavania
 			 * \param except bod na vynechanie
 			 * \param verbose kontrolny vystup
 			 * \return startovacie body tracovania
 			 */
-			std::vector<cv::Point> getStartingTracingPositions(const cv::Point& base, const cv::Mat& map, const cv::Point& except = cv::Point(-1, -1), bool verbose = false);
+			std::vector<cv::Point> getStartingTracingPositions(const cv::Point& base, const cv::Mat& map, Workspace& workspace, 
+				const cv::Point& except = cv::Point(-1, -1), bool verbose = false) const;
 			/**
 			 * \brief Tracovanie linie stenceneho odtlacku
 			 * \param base pociatocny bod
@@ -92,20 +122,23 @@ namespace processing
 			 * \param length dlzka tracovania
 			 * \param map stenceny obrazok
 			 * \param processed sem sa ulozi vektorova reprezentacia tracovanej linie 
+			 * \param workspace pracovne data vyhladavania
 			 * \param verbose kontrolny vystup
 			 * \return okrajove body tracovania linie
 			 */
-			std::vector<cv::Point> trace(const cv::Point& base, std::vector<cv::Point> positions, int length, const cv::Mat& map, std::vector<cv::Point>& processed, bool verbose = false);
+			std::vector<cv::Point> trace(const cv::Point& base, std::vector<cv::Point> positions, int length, const cv::Mat& map, 
+				std::vector<cv::Point>& processed, Workspace& workspace, bool verbose = false) const;
 			/**
 			 * \brief Spocita adaptivnu hodnotu dlzky tracovania (trashold) na zaklade vzdialenosti
 			 * subeznych linii.
 			 * \param map stenceny odtlacok 
 			 * \param pos pozicia markantu
 			 * \param direction prvotny smer marakntu na zaklade defaultnejdlzky tracovania
+			 * \param workspace pracovne data vyhladavania
 			 * \param verbose kontrolny vystup
 			 * \return adaptivna dlzka tracovania urcena pre markant
 			 */
-			float calculateAdaptiveThreshold(const cv::Mat& map, const cv::Point& pos, float direction, bool verbose = false);
+			float calculateAdaptiveThreshold(const cv::Mat& map, const cv::Point& pos, float direction, Workspace& workspace, bool verbose = false) const;
 			/**
 			 * \brief Skontroluje ci sa v susednych bodoch pos nachadza linia.
 			 * \param map stenceny obrazok
@@ -140,6 +173,13 @@ namespace processing
 			 * \brief Indexy susednych bodov.
 			 */
 			static const std::array<std::array<int, 2>, 8> indices;
+			/**
+			 * \brief Typ markantu podla 8-okolia zbaleneho do bajtu. Bit n patri bodu
+			 * okolia v poradi od horneho v smere hodinovych ruciciek. Polovica poctu
+			 * 01 prechodov okolia (crossing number) 1 znamena rozdvojenie, aspon 3
+			 * ukoncenie (vychadza sa zo stencenych priestorov, nie linii).
+			 */
+			static const std::array<std::int8_t, 256> crossings;
 			
 			// constructors
 			MinutiaeEstimator() = default;
@@ -148,9 +188,17 @@ namespace processing
 			/**
 			 * \brief Spusti vyhladavanie markantov a nakonfiguruje potrebne parametre.
 			 * \param img stenceny obrazok
+			 * \param segmentation segmentacia odtlacku
+			 * \return najdene markanty
+			 */
+			std::vector<storage::Minutiae> estimate(const cv::Mat& img, const cv::Mat& segmentation) const;
+			/**
+			 * \brief Spusti vyhladavanie markantov nad pracovnymi datami volajuceho.
+			 * \param img stenceny obrazok
+			 * \param workspace pracovne data vyhladavania
 			 * \return najdene markanty
 			 */
-			std::vector<storage::Minutiae> estimate(const cv::Mat& img);
+			std::vector<storage::Minutiae> estimate(const cv::Mat& img, Workspace& workspace) const;
 
 			cv::Mat getMinutiaeImage(const cv::Mat& img, const std::vector<storage::Minutiae>& minutiaes) const;
 
@@ -158,25 +206,25 @@ namespace processing
 			 * \brief Zobrazi markanty spolu s cestou odkial bola metoda zavolana.
 			 * \param img odtlacok
 			 * \param minutiaes markanty
+			 * \param tracing tracovanie markantov
 			 * \param trace cesta odkial bola metoda zavolana
 			 */
-			void display(const cv::Mat& img, const std::vector<storage::Minutiae>& minutiaes, const std::string& trace) const;
+			void display(const cv::Mat& img, const std::vector<storage::Minutiae>& minutiaes, const cv::Mat& tracing, const std::string& trace) const;
 			/**
 			 * \brief Zapise markanty do suboru na definovaej ceste path.
 			 * \param img obrazok
 			 * \param minutiaes markanty
+			 * \param tracing tracovanie markantov
 			 * \param path cesta
 			 * \param filename nazov suboru
 			 */
-			void write(const cv::Mat& img, const std::vector<storage::Minutiae>& minutiaes, const std::string& path, const std::string& filename) const;
+			void write(const cv::Mat& img, const std::vector<storage::Minutiae>& minutiaes, const cv::Mat& tracing, 
+				const std::string& path, const std::string& filename) const;
 
 			// getters
-			cv::Mat getSegmentation() const { return this->segmentation; }
 			int getBlockSize() const { return this->blockSize; }
-			cv::Mat geMinutiaeTracing() const { return this->tmp; }
 
 			// setters
-			MinutiaeEstimator& setSegmentation(const cv::Mat& segmentation) { this->segmentation = segmentation; return *this; }
 			MinutiaeEstimator& setBlockSize(const int blockSize) { this->blockSize = blockSize; return *this; }
 			
 		};
@@ -1,28 +1,50 @@
 #include "OrientationsEstimator.h"
 #include "ImageProcessor.h"
 
+#include <algorithm>
+#include <vector>
+
 using namespace processing::utils;
 using namespace cv;
 
-int OrientationsEstimator::displayed = 0;
+std::atomic<int> OrientationsEstimator::displayed(0);
 const std::string OrientationsEstimator::class_name = "OrientationsEstimator::";
 
-Mat OrientationsEstimator::estimate(const Mat& fingerprint)
+Mat OrientationsEstimator::estimate(const Mat& fingerprint) const
 {
-	this->orientations = Mat(fingerprint.size(), CV_32FC2, Scalar(0, 1));
-	
-	this->computeGradients(fingerprint);
+	Workspace workspace;
+
+	return this->estimate(fingerprint, workspace);
+}
+
+Mat OrientationsEstimator::estimate(const Mat& fingerprint, Workspace& workspace) const
+{
+	this->computeGradients(fingerprint, workspace);
 
-	this->compute(fingerprint);
+	return this->estimateFromGradients(fingerprint, workspace);
+}
+
+Mat OrientationsEstimator::estimateFromGradients(const Mat& fingerprint, Workspace& workspace) const
+{
+	workspace.orientations = Mat(fingerprint.size(), CV_32FC2, Scalar(0, 1));
+
+	if (this->integralImage)
+	{
+		this->computeIntegral(fingerprint, workspace);
+	}
+	else
+	{
+		this->compute(fingerprint, workspace);
+	}
 
 	if (this->isVerbose())
 	{
 		std::stringstream ss; ss << class_name << "estimate";
 		
-		this->display(fingerprint, this->orientations, ss.str());
+		this->display(fingerprint, workspace.orientations, ss.str());
 	}
 	
-	return this->orientations;
+	return workspace.orientations;
 }
 
 void OrientationsEstimator::display(const Mat& fingerprint, const Mat& orientations, const std::string& trace, const bool blank) const
@@ -45,19 +67,23 @@ void OrientationsEstimator::write(const cv::Mat& fingerprint, const cv::Mat& ori
 
 /////////////////////////////////////// Private members ///////////////////////////////////////
 
-void OrientationsEstimator::computeGradients(const Mat& fingerprint)
+void OrientationsEstimator::computeGradients(const Mat& fingerprint, Workspace& workspace) const
 {
-	Sobel(fingerprint, this->gradX, fingerprint.type(), 1, 0, 3);
-	Sobel(fingerprint, this->gradY, fingerprint.type(), 0, 1, 3);
+	Sobel(fingerprint, workspace.gradX, fingerprint.type(), 1, 0, 3);
+	Sobel(fingerprint, workspace.gradY, fingerprint.type(), 0, 1, 3);
 }
 
-void OrientationsEstimator::compute(const Mat& fingerprint)
+void OrientationsEstimator::compute(const Mat& fingerprint, Workspace& workspace) const
 {	
 	const auto rows = fingerprint.rows;
 	const auto cols = fingerprint.cols;
 
-	Mat phiX = Mat::zeros(this->orientations.size(), CV_32F);
-	Mat phiY = Mat::zeros(this->orientations.size(), CV_32F);
+	const auto& gradX = workspace.gradX;
+	const auto& gradY = workspace.gradY;
+	auto& orientations = workspace.orientations;
+
+	Mat phiX = Mat::zeros(orientations.size(), CV_32F);
+	Mat phiY = Mat::zeros(orientations.size(), CV_32F);
 	
 	for (auto i = this->blockSize / 2.0f; i < rows; i += this->blockSize)
 	{
@@ -74,8 +100,8 @@ void OrientationsEstimator::compute(const Mat& fingerprint)
 			{
 				for (auto v = j - this->blockSize / 2; v < j + blockW; v++)
 				{
-					vsy += 2 * this->gradX.at<float>(u, v) * this->gradY.at<float>(u, v);
-					vsx += pow(this->gradX.at<float>(u, v), 2) - pow(this->gradY.at<float>(u, v), 2);
+					vsy += 2 * gradX.at<float>(u, v) * gradY.at<float>(u, v);
+					vsx += pow(gradX.at<float>(u, v), 2) - pow(gradY.at<float>(u, v), 2);
 				}
 			}
 
@@ -87,8 +113,8 @@ void OrientationsEstimator::compute(const Mat& fingerprint)
 				{
 					for (auto v = j - this->blockSize / 2; v < j + blockW && v < cols; v++)
 					{
-						this->orientations.at<Vec2f>(u, v)[0] = orientation;
-						this->orientations.at<Vec2f>(u, v)[1] = 1;
+						orientations.at<Vec2f>(u, v)[0] = orientation;
+						orientations.at<Vec2f>(u, v)[1] = 1;
 
 						phiX.at<float>(u, v) = cos(2.0f * orientation);
 						phiY.at<float>(u, v) = sin(2.0f * orientation);
@@ -100,18 +126,90 @@ void OrientationsEstimator::compute(const Mat& fingerprint)
 
 	if (this->lowPassFilter)
 	{
-		this->filterOrientations(phiX, phiY);
+		this->filterOrientations(phiX, phiY, workspace);
+	}
+}
+
+void OrientationsEstimator::computeIntegral(const Mat& fingerprint, Workspace& workspace) const
+{
+	const auto rows = fingerprint.rows;
+	const auto cols = fingerprint.cols;
+	const auto blockSize = this->blockSize;
+
+	const auto& gradX = workspace.gradX;
+	const auto& gradY = workspace.gradY;
+	auto& orientations = workspace.orientations;
+
+	// momenty 2 * gx * gy a gx^2 - gy^2 a ich integralne obrazy
+	Mat momentY, momentX, squareY;
+	multiply(gradX, gradY, momentY, 2);
+	multiply(gradX, gradX, momentX);
+	multiply(gradY, gradY, squareY);
+	momentX -= squareY;
+
+	Mat sumY, sumX;
+	integral(momentY, sumY, CV_64F);
+	integral(momentX, sumX, CV_64F);
+
+	Mat phiX = Mat::zeros(orientations.size(), CV_32F);
+	Mat phiY = Mat::zeros(orientations.size(), CV_32F);
+
+	// riadok orientacii a vektorov jedneho riadku blokov
+	std::vector<Vec2f> orientationRow(cols);
+	std::vector<float> phiXRow(cols), phiYRow(cols);
+
+	// bloky su rovnake ako v compute, blok so stredom mimo obrazku sa vynecha
+	for (auto top = 0; top + blockSize / 2.0f < rows; top += blockSize)
+	{
+		const auto bottom = std::min(top + blockSize, rows);
+
+		std::fill(orientationRow.begin(), orientationRow.end(), Vec2f(0, 1));
+		std::fill(phiXRow.begin(), phiXRow.end(), .0f);
+		std::fill(phiYRow.begin(), phiYRow.end(), .0f);
+
+		for (auto left = 0; left + blockSize / 2.0f < cols; left += blockSize)
+		{
+			const auto right = std::min(left + blockSize, cols);
+
+			const auto vsy = sumY.at<double>(bottom, right) - sumY.at<double>(top, right)
+				- sumY.at<double>(bottom, left) + sumY.at<double>(top, left);
+			const auto vsx = sumX.at<double>(bottom, right) - sumX.at<double>(top, right)
+				- sumX.at<double>(bottom, left) + sumX.at<double>(top, left);
+
+			if (vsx != .0)
+			{
+				const auto orientation = static_cast<float>(.5 * fastAtan2(static_cast<float>(vsy), static_cast<float>(vsx)) * CV_PI / 180);
+
+				std::fill(orientationRow.begin() + left, orientationRow.begin() + right, Vec2f(orientation, 1));
+				std::fill(phiXRow.begin() + left, phiXRow.begin() + right, cos(2.0f * orientation));
+				std::fill(phiYRow.begin() + left, phiYRow.begin() + right, sin(2.0f * orientation));
+			}
+		}
+
+		for (auto u = top; u < bottom; u++)
+		{
+			std::copy(orientationRow.begin(), orientationRow.end(), orientations.ptr<Vec2f>(u));
+			std::copy(phiXRow.begin(), phiXRow.end(), phiX.ptr<float>(u));
+			std::copy(phiYRow.begin(), phiYRow.end(), phiY.ptr<float>(u));
+		}
+	}
+
+	if (this->lowPassFilter)
+	{
+		this->filterOrientations(phiX, phiY, workspace);
 	}
 }
 
-void OrientationsEstimator::filterOrientations(Mat& phiX, Mat& phiY)
+void OrientationsEstimator::filterOrientations(Mat& phiX, Mat& phiY, Workspace& workspace) const
 {
+	auto& orientations = workspace.orientations;
+
 	auto filteredX = ImageProcessor::getBlurred(phiX, 7 * blockSize);
 	auto filteredY = ImageProcessor::getBlurred(phiY, 7 * blockSize);
 
-	for (auto i = this->blockSize / 2; i < this->orientations.rows; i += this->blockSize)
+	for (auto i = this->blockSize / 2; i < orientations.rows; i += this->blockSize)
 	{
-		for (auto j = this->blockSize / 2; j < this->orientations.cols; j += this->blockSize)
+		for (auto j = this->blockSize / 2; j < orientations.cols; j += this->blockSize)
 		{
 			// pozriem ci neskocim mimo, ak hej zmensim velkost bloku
 			const auto blockH = ((orientations.rows - i) < this->blockSize / 2.0f) ? (orientations.rows - i) : this->blockSize / 2.0f;
@@ -127,7 +225,7 @@ void OrientationsEstimator::filterOrientations(Mat& phiX, Mat& phiY)
 			{
 				for (auto v = j - this->blockSize / 2; v < j + blockW; v++)
 				{
-					this->orientations.at<Vec2f>(u, v)[0] = orientation;
+					orientations.at<Vec2f>(u, v)[0] = orientation;
 					
 				}
 			}
@@ -2,6 +2,8 @@
 
 #include <opencv2/opencv.hpp>
 
+#include <atomic>
+
 namespace processing
 {
 	namespace utils
@@ -11,6 +13,28 @@ namespace processing
 		 */
 		class OrientationsEstimator
 		{
+		public:
+			/**
+			 * \brief Pracovne data jedneho odhadu orientacii. Kazde volanie
+			 * pracuje nad vlastnym uloziskom, takze jeden nakonfigurovany odhad
+			 * moze sluzit viacerym vlaknam naraz.
+			 */
+			struct Workspace
+			{
+				/**
+				 * \brief Orientacie dotlacku.
+				 */
+				cv::Mat orientations;
+				/**
+				 * \brief Gradient odtlacku X.
+				 */
+				cv::Mat gradX;
+				/**
+				 * \brief Gradient odtlacku Y.
+				 */
+				cv::Mat gradY;
+			};
+
 		private:
 			// members
 			/**
@@ -22,23 +46,14 @@ namespace processing
 			 */
 			int kernelSize = 3;
 
-			/**
-			 * \brief Orientacie dotlacku.
-			 */
-			cv::Mat orientations;
-			/**
-			 * \brief Gradient odtlacku X.
-			 */
-			cv::Mat gradX;
-			/**
-			 * \brief Gradient odtlacku Y.
-			 */
-			cv::Mat gradY;
-
 			/**
 			 * \brief Indikator pouzitia dolnopriepustneho filtra.
 			 */
 			bool lowPassFilter = false;
+			/**
+			 * \brief Indikator odhadu z integralnych obrazov momentov gradientu.
+			 */
+			bool integralImage = false;
 			/**
 			 * \brief Indikator kontrolneho vystup.
 			 */
@@ -48,25 +63,36 @@ namespace processing
 			/**
 			 * \brief Pocet zobrazeni v ramci jedneho behu.
 			 */
-			static int displayed;
+			static std::atomic<int> displayed;
 
 			// methods
 			/**
 			 * \brief Ohadne lokalne orientacie odtlacku.
 			 * \param fingerprint normalizovany odtlacok
+			 * \param workspace pracovne data odhadu
+			 */
+			void compute(const cv::Mat& fingerprint, Workspace& workspace) const;
+			/**
+			 * \brief Ohadne lokalne orientacie odtlacku z integralnych obrazov momentov
+			 * gradientu. Sucet momentov kazdeho bloku sa precita v konstantnom case,
+			 * vysledok sa od compute lisi iba zaokruhlenim suctov.
+			 * \param fingerprint normalizovany odtlacok
+			 * \param workspace pracovne data odhadu
 			 */
-			void compute(const cv::Mat& fingerprint);
+			void computeIntegral(const cv::Mat& fingerprint, Workspace& workspace) const;
 			/**
 			 * \brief Zisti gradient odtlacku.
 			 * \param fingerprint normalizovany odtlaock
+			 * \param workspace pracovne data odhadu
 			 */
-			void computeGradients(const cv::Mat& fingerprint);
+			void computeGradients(const cv::Mat& fingerprint, Workspace& workspace) const;
 			/**
 			 * \brief Zfiltruje orientacie dolnopriepustnym filtrom.
 			 * \param phiX x-ove suradnice orientacii prevedenych na vektor 
 			 * \param phiY y-ove suradnice orientacii prevedenych na vektor 
+			 * \param workspace pracovne data odhadu
 			 */
-			void filterOrientations(cv::Mat& phiX, cv::Mat& phiY);
+			void filterOrientations(cv::Mat& phiX, cv::Mat& phiY, Workspace& workspace) const;
 
 		public:
 			// static members
@@ -81,7 +107,22 @@ namespace processing
 			 * \param fingerprint normalizovany odtlacok
 			 * \return lokalne orientacie odtlacku
 			 */
-			cv::Mat estimate(const cv::Mat& fingerprint);
+			cv::Mat estimate(const cv::Mat& fingerprint) const;
+			/**
+			 * \brief Zahaji odhad lokalnych orientacii nad pracovnymi datami volajuceho.
+			 * \param fingerprint normalizovany odtlacok
+			 * \param workspace pracovne data odhadu
+			 * \return lokalne orientacie odtlacku
+			 */
+			cv::Mat estimate(const cv::Mat& fingerprint, Workspace& workspace) const;
+			/**
+			 * \brief Zahaji odhad lokalnych orientacii z gradientov, ktore su uz ulozene
+			 * v pracovnych datach volajuceho (napr. z Preprocessor).
+			 * \param fingerprint normalizovany odtlacok
+			 * \param workspace pracovne data odhadu s gradientmi odtlacku
+			 * \return lokalne orientacie odtlacku
+			 */
+			cv::Mat estimateFromGradients(const cv::Mat& fingerprint, Workspace& workspace) const;
 			
 			/**
 			 * \brief Zobrazi lokalne orientacie s cestou odkial bola metoda zavolana.
@@ -104,18 +145,16 @@ namespace processing
 			cv::Mat getOrientationImage(const cv::Mat& fingerprint, const cv::Mat& orientations, bool blank = false) const;
 
 			// getters
-			cv::Mat getOrientationMap() const { return this->orientations; }
 			int getBlockSize() const { return this->blockSize; }
-			cv::Mat getGradX() const { return this->gradX; }
-			cv::Mat getGradY() const { return this->gradY; }
 			int getKernelSize() const { return this->kernelSize; }
 			bool isVerbose() const { return this->verboseOutput; }
+			bool usesIntegralImage() const { return this->integralImage; }
 			
 			// setters
-			OrientationsEstimator& setOrientationMap(const cv::Mat& orientations) { this->orientations = orientations; return *this; }
 			OrientationsEstimator& setBlockSize(const int blockSize) { this->blockSize = blockSize; return *this; }
 			OrientationsEstimator& setKernelSize(const int kernelSize) { this->kernelSize = kernelSize; return  *this; }
 			OrientationsEstimator& useLowPassFilter(const bool use = true) { lowPassFilter = use; return *this; }
+			OrientationsEstimator& useIntegralImage(const bool use = true) { this->integralImage = use; return *this; }
 			OrientationsEstimator& verbose(const bool verbose = true) { this->verboseOutput = verbose; return *this; }
 
 		};
@@ -0,0 +1,104 @@
+#include "Preprocessor.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace processing::utils;
+using namespace cv;
+
+const double Preprocessor::targetMean = 75.0 / 255.0;
+const std::string Preprocessor::class_name = "Preprocessor::";
+
+Mat Preprocessor::process(Mat& fingerprint, Workspace& workspace) const
+{
+	cv::resize(fingerprint, fingerprint, Size(0, 0), this->scale, this->scale);
+
+	double min, max, m, d;
+	this->blur(fingerprint, workspace, min, max, m, d);
+
+	const auto rows = fingerprint.rows;
+	const auto cols = fingerprint.cols;
+	const auto alpha = 1 / (max - min);
+	const auto beta = min / (min - max);
+	const auto m0 = targetMean;
+
+	// normalizovany odtlacok ostava v odtlacku, nemoze byt zdielany medzi volaniami
+	Mat normalized(fingerprint.size(), CV_32F);
+	auto& gradX = workspace.orientations.gradX;
+	auto& gradY = workspace.orientations.gradY;
+	gradX.create(fingerprint.size(), CV_32F);
+	gradY.create(fingerprint.size(), CV_32F);
+
+	// Sobel pasu potrebuje aj nasledujuci riadok, normalizacia preto predbieha o riadok
+	auto ready = 0;
+	for (auto top = 0; top < rows; top += this->bandRows)
+	{
+		const auto bottom = std::min(top + this->bandRows, rows);
+
+		for (const auto last = std::min(bottom + 1, rows); ready < last; ready++)
+		{
+			const auto* b = workspace.blurred.ptr<float>(ready);
+			auto* n = normalized.ptr<float>(ready);
+
+			for (auto j = 0; j < cols; j++)
+			{
+				const auto v = static_cast<float>(b[j] * alpha + beta);
+				const auto delta = std::sqrt(m0 * (v - m) * (v - m) / d);
+				const auto value = static_cast<float>(v > m ? m0 + delta : m0 - delta);
+
+				n[j] = std::min(std::max(value, .0f), 1.f);
+			}
+		}
+
+		const auto band = normalized.rowRange(top, bottom);
+		auto bandX = gradX.rowRange(top, bottom);
+		auto bandY = gradY.rowRange(top, bottom);
+
+		Sobel(band, bandX, CV_32F, 1, 0, 3);
+		Sobel(band, bandY, CV_32F, 0, 1, 3);
+	}
+
+	return normalized;
+}
+
+/////////////////////////////////////// Private members ///////////////////////////////////////
+
+void Preprocessor::blur(const Mat& fingerprint, Workspace& workspace, double& min, double& max, double& mean, double& deviation) const
+{
+	const auto gauss = getGaussianKernel(this->kernelSize, 0, CV_32F);
+	const Mat kernel = gauss * gauss.t();
+
+	workspace.blurred.create(fingerprint.size(), CV_32F);
+
+	min = DBL_MAX;
+	max = -DBL_MAX;
+	auto sum = .0, squares = .0;
+
+	// pas je citany z rodicovskej matice, okraje sa rozsiria rovnako ako pri celom obrazku
+	for (auto top = 0; top < fingerprint.rows; top += this->bandRows)
+	{
+		const auto bottom = std::min(top + this->bandRows, fingerprint.rows);
+
+		const auto source = fingerprint.rowRange(top, bottom);
+		auto band = workspace.blurred.rowRange(top, bottom);
+
+		filter2D(source, band, CV_32F, kernel, Point(-1, -1), 0, BORDER_DEFAULT);
+
+		double bandMin, bandMax;
+		minMaxLoc(band, &bandMin, &bandMax);
+
+		min = std::min(min, bandMin);
+		max = std::max(max, bandMax);
+		sum += cv::sum(band)[0];
+		squares += band.dot(band);
+	}
+
+	// statistiky normalizovaneho rozsahu [0, 1]
+	const auto total = static_cast<double>(fingerprint.total());
+	const auto range = max - min;
+	const auto average = sum / total;
+
+	mean = (average - min) / range;
+	deviation = std::sqrt(std::max(squares / total - average * average, .0)) / range;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "OrientationsEstimator.h"
+
+#include <opencv2/opencv.hpp>
+
+namespace processing
+{
+	namespace utils
+	{
+		/**
+		 * \brief Spojene predspracovanie odtlacku: rozmazanie, normalizacia a gradienty
+		 * v jednom priechode po pasoch riadkov. Normalizacia potrebuje globalne minimum,
+		 * maximum, priemer a odchylku, preto sa rozmazany odtlacok prejde dvakrat: prvy
+		 * priechod rozmaze pas a zapocita jeho statistiky, druhy pas znormalizuje a hned
+		 * z neho vypocita gradienty, kym su riadky v cache.
+		 */
+		class Preprocessor
+		{
+		public:
+			/**
+			 * \brief Pracovne data predspracovania. Buffre su znovu pouzite pri kazdom
+			 * volani s rovnakou velkostou odtlacku.
+			 */
+			struct Workspace
+			{
+				/**
+				 * \brief Rozmazany odtlacok.
+				 */
+				cv::Mat blurred;
+				/**
+				 * \brief Pracovne data odhadu orientacii, sem sa ulozia gradienty.
+				 */
+				OrientationsEstimator::Workspace orientations;
+			};
+
+		private:
+			// members
+			/**
+			 * \brief Zvacsenie odtlacku pred normalizaciou.
+			 */
+			double scale = 1.1;
+			/**
+			 * \brief Velkost jadra Gaussovho rozmazania.
+			 */
+			int kernelSize = 5;
+			/**
+			 * \brief Pocet riadkov jedneho pasu.
+			 */
+			int bandRows = 32;
+
+			// static members
+			/**
+			 * \brief Ziadany priemer normalizovaneho odtlacku.
+			 */
+			static const double targetMean;
+
+			// methods
+			/**
+			 * \brief Rozmaze odtlacok po pasoch a zisti jeho minimum, maximum, priemer a odchylku.
+			 * \param fingerprint odtlacok
+			 * \param workspace pracovne data, rozmazany odtlacok sa ulozi do blurred
+			 * \param min sem sa ulozi minimum
+			 * \param max sem sa ulozi maximum
+			 * \param mean sem sa ulozi priemer
+			 * \param deviation sem sa ulozi smerodajna odchylka
+			 */
+			void blur(const cv::Mat& fingerprint, Workspace& workspace, double& min, double& max, double& mean, double& deviation) const;
+
+		public:
+			// static members
+			static const std::string class_name;
+
+			// constructors
+			Preprocessor() = default;
+
+			// methods
+			/**
+			 * \brief Zvacsi odtlacok, rozmaze ho, znormalizuje a zisti jeho gradienty.
+			 * Vysledok zodpoveda postupnosti ImageProcessor::resize, getBlurred,
+			 * normalize a Sobelovmu operatoru az na zaokruhlenie statistik.
+			 * \param fingerprint odtlacok, zmeni sa jeho velkost
+			 * \param workspace pracovne data, gradienty sa ulozia do orientations
+			 * \return normalizovany odtlacok
+			 */
+			cv::Mat process(cv::Mat& fingerprint, Workspace& workspace) const;
+
+			// getters
+			double getScale() const { return this->scale; }
+			int getKernelSize() const { return this->kernelSize; }
+			int getBandRows() const { return this->bandRows; }
+
+			// setters
+			Preprocessor& setScale(const double scale) { this->scale = scale; return *this; }
+			Preprocessor& setKernelSize(const int kernelSize) { this->kernelSize = kernelSize; return *this; }
+			Preprocessor& setBandRows(const int bandRows) { this->bandRows = bandRows; return *this; }
+		};
+	}
+}
@@ -0,0 +1,50 @@
+# Optimalizacne prepinace spolocne pre vsetky ciele.
+#
+#   MORPHING_NATIVE  - kompilacia pre CPU hostitela (-march=native)
+#   MORPHING_LTO     - optimalizacia pri linkovani
+#   MORPHING_PGO     - OFF | GENERATE | USE, profilom riadena optimalizacia
+#
+# Typicky PGO beh:
+#   cmake -B build -DMORPHING_PGO=GENERATE && cmake --build build
+#   ./build/MorphCtl/morphctl batch ...   (reprezentativna vzorka)
+#   cmake -B build -DMORPHING_PGO=USE && cmake --build build
+
+option(MORPHING_NATIVE "Optimize for the host CPU (-march=native)" ON)
+option(MORPHING_LTO "Enable link time optimization" OFF)
+set(MORPHING_PGO "OFF" CACHE STRING "Profile guided optimization: OFF, GENERATE or USE")
+set_property(CACHE MORPHING_PGO PROPERTY STRINGS OFF GENERATE USE)
+set(MORPHING_PGO_DIR "${CMAKE_BINARY_DIR}/pgo" CACHE PATH "Directory holding PGO profiles")
+
+if(MORPHING_LTO)
+	include(CheckIPOSupported)
+	check_ipo_supported(RESULT MORPHING_LTO_SUPPORTED OUTPUT MORPHING_LTO_OUTPUT)
+	if(NOT MORPHING_LTO_SUPPORTED)
+		message(WARNING "LTO is not supported by the compiler: ${MORPHING_LTO_OUTPUT}")
+	endif()
+endif()
+
+function(morphing_optimize target)
+	if(CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang")
+		# Release pre GCC/Clang uz obsahuje -O3
+		if(MORPHING_NATIVE)
+			target_compile_options(${target} PRIVATE -march=native)
+		endif()
+
+		if(MORPHING_PGO STREQUAL "GENERATE")
+			target_compile_options(${target} PRIVATE -fprofile-generate=${MORPHING_PGO_DIR})
+			target_link_options(${target} PRIVATE -fprofile-generate=${MORPHING_PGO_DIR})
+		elseif(MORPHING_PGO STREQUAL "USE")
+			target_compile_options(${target} PRIVATE -fprofile-use=${MORPHING_PGO_DIR})
+			target_link_options(${target} PRIVATE -fprofile-use=${MORPHING_PGO_DIR})
+			if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+				target_compile_options(${target} PRIVATE -fprofile-correction -Wno-missing-profile)
+			endif()
+		elseif(NOT MORPHING_PGO STREQUAL "OFF")
+			message(FATAL_ERROR "Unknown MORPHING_PGO value '${MORPHING_PGO}', use OFF, GENERATE or USE")
+		endif()
+	endif()
+
+	if(MORPHING_LTO AND MORPHING_LTO_SUPPORTED)
+		set_property(TARGET ${target} PROPERTY INTERPROCEDURAL_OPTIMIZATION TRUE)
+	endif()
+endfunction()